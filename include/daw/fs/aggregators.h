@@ -0,0 +1,188 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+/// The reductions that parallel::aggregate computes together in one pass.
+/// An aggregator of values of type T has
+///   state<T>( )           the state of no values
+///   add( state, value )   add a value to state
+///   merge( state, other ) add the values of other, which came after those of
+///                         state, to state
+///   result( state )       the result of the values added
+namespace daw::algorithm::parallel::aggregators {
+	/// The number of values
+	struct count {
+		template<typename T>
+		[[nodiscard]] constexpr std::size_t state( ) const {
+			return 0;
+		}
+
+		template<typename T>
+		constexpr void add( std::size_t &s, T const & ) const {
+			++s;
+		}
+
+		constexpr void merge( std::size_t &s, std::size_t other ) const {
+			s += other;
+		}
+
+		[[nodiscard]] constexpr std::size_t result( std::size_t s ) const {
+			return s;
+		}
+	};
+
+	/// The sum of the values, in Result or the value type when Result is void
+	template<typename Result = void>
+	struct sum {
+		template<typename T>
+		using result_t = std::conditional_t<std::is_void_v<Result>, T, Result>;
+
+		template<typename T>
+		[[nodiscard]] constexpr result_t<T> state( ) const {
+			return result_t<T>{ };
+		}
+
+		template<typename S, typename T>
+		constexpr void add( S &s, T const &value ) const {
+			s += value;
+		}
+
+		template<typename S>
+		constexpr void merge( S &s, S const &other ) const {
+			s += other;
+		}
+
+		template<typename S>
+		[[nodiscard]] constexpr S result( S const &s ) const {
+			return s;
+		}
+	};
+
+	/// The least value, the first of equal ones, or an empty optional when
+	/// there are no values
+	template<typename Compare = std::less<>>
+	struct min {
+		[[no_unique_address]] Compare cmp{ };
+
+		template<typename T>
+		[[nodiscard]] constexpr std::optional<T> state( ) const {
+			return std::nullopt;
+		}
+
+		template<typename T>
+		constexpr void add( std::optional<T> &s, T const &value ) const {
+			if( not s or cmp( value, *s ) ) {
+				s = value;
+			}
+		}
+
+		template<typename T>
+		constexpr void merge( std::optional<T> &s, std::optional<T> const &other ) const {
+			if( other ) {
+				add( s, *other );
+			}
+		}
+
+		template<typename T>
+		[[nodiscard]] constexpr std::optional<T> result( std::optional<T> const &s ) const {
+			return s;
+		}
+	};
+
+	/// The greatest value, the first of equal ones, or an empty optional when
+	/// there are no values
+	template<typename Compare = std::less<>>
+	struct max {
+		[[no_unique_address]] Compare cmp{ };
+
+		template<typename T>
+		[[nodiscard]] constexpr std::optional<T> state( ) const {
+			return std::nullopt;
+		}
+
+		template<typename T>
+		constexpr void add( std::optional<T> &s, T const &value ) const {
+			if( not s or cmp( *s, value ) ) {
+				s = value;
+			}
+		}
+
+		template<typename T>
+		constexpr void merge( std::optional<T> &s, std::optional<T> const &other ) const {
+			if( other ) {
+				add( s, *other );
+			}
+		}
+
+		template<typename T>
+		[[nodiscard]] constexpr std::optional<T> result( std::optional<T> const &s ) const {
+			return s;
+		}
+	};
+
+	/// The result of mean_var
+	struct mean_var_result {
+		std::size_t count = 0;
+		double mean = 0.0;
+		/// The population variance, 0 when there are no values
+		double variance = 0.0;
+	};
+
+	/// The count, mean and variance of the values.  Each task keeps a running
+	/// mean and sum of squared differences, which stays accurate where summing
+	/// the squares does not, and the states of the tasks are combined with
+	/// Chan's formula
+	struct mean_var {
+		struct state_t {
+			std::size_t count = 0;
+			double mean = 0.0;
+			double m2 = 0.0;
+		};
+
+		template<typename T>
+		[[nodiscard]] constexpr state_t state( ) const {
+			return state_t{ };
+		}
+
+		template<typename T>
+		constexpr void add( state_t &s, T const &value ) const {
+			auto const x = static_cast<double>( value );
+			++s.count;
+			auto const delta = x - s.mean;
+			s.mean += delta / static_cast<double>( s.count );
+			s.m2 += delta * ( x - s.mean );
+		}
+
+		constexpr void merge( state_t &s, state_t const &other ) const {
+			if( other.count == 0 ) {
+				return;
+			}
+			auto const count = s.count + other.count;
+			auto const delta = other.mean - s.mean;
+			auto const weight =
+			  static_cast<double>( other.count ) / static_cast<double>( count );
+			s.mean += delta * weight;
+			s.m2 += other.m2 + delta * delta * static_cast<double>( s.count ) * weight;
+			s.count = count;
+		}
+
+		[[nodiscard]] constexpr mean_var_result result( state_t const &s ) const {
+			if( s.count == 0 ) {
+				return mean_var_result{ };
+			}
+			return mean_var_result{ s.count, s.mean, s.m2 / static_cast<double>( s.count ) };
+		}
+	};
+} // namespace daw::algorithm::parallel::aggregators
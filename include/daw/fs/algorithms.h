@@ -23,12 +23,18 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
+#include <vector>
 
 #include <daw/daw_sort_n.h>
 #include <daw/daw_view.h>
 
+#include "aggregators.h"
+#include "default_init_allocator.h"
 #include "impl/algorithms_impl.h"
 #include "impl/concept_checks.h"
+#include "range_pipeline.h"
+#include "store_policy.h"
 
 namespace daw::algorithm::parallel {
 	template<typename RandomIterator, typename UnaryOperation>
@@ -48,6 +54,31 @@ namespace daw::algorithm::parallel {
 		                         DAW_MOVE( ts ) );
 	}
 
+	/// for_each over forward or input iterators.  The calling thread reads
+	/// blocks of items while tasks run unary_op on the blocks read before
+	template<impl::block_input_iterator Iterator, typename UnaryOperation>
+	void for_each( Iterator first,
+	               Iterator last,
+	               UnaryOperation unary_op,
+	               task_scheduler ts = get_task_scheduler( ) ) {
+
+		static_assert( concept_checks::is_callable_v<UnaryOperation, Iterator>,
+		               "UnaryOperation passed to for_each must accept the value referenced "
+		               "by first. e.g "
+		               "unary_op( *first ) must be valid" );
+
+		(void)impl::parallel_map_blocks<bool>(
+		  DAW_MOVE( first ),
+		  DAW_MOVE( last ),
+		  [op = daw::traits::lift_func( unary_op )]( auto block ) {
+			  for( auto &&item : block ) {
+				  (void)op( item );
+			  }
+			  return true;
+		  },
+		  DAW_MOVE( ts ) );
+	}
+
 	template<typename RandomIterator, typename UnaryOperation>
 	void for_each_n( RandomIterator first,
 	                 size_t N,
@@ -74,25 +105,148 @@ namespace daw::algorithm::parallel {
 
 		traits::is_random_access_iterator_test<RandomIterator>( );
 
-		impl::parallel_for_each_index( daw::view( first, last ),
-		                               daw::traits::lift_func( indexed_op ),
-		                               DAW_MOVE( ts ) );
+		impl::parallel_for_each_index(
+		  first, last, daw::traits::lift_func( indexed_op ), DAW_MOVE( ts ) );
 	}
 
+	/// Assign value to each item.  See store_policy for how large ranges are
+	/// written
 	template<typename RandomIterator, typename T>
 	void fill( RandomIterator first,
 	           RandomIterator last,
 	           T const &value,
-	           task_scheduler ts = get_task_scheduler( ) ) {
+	           task_scheduler ts = get_task_scheduler( ),
+	           store_policy policy = store_policy::automatic ) {
 
 		traits::is_random_access_iterator_test<RandomIterator>( );
 		static_assert( traits::is_assignable_iterator_v<RandomIterator, T>,
 		               "T value must be assignable to the "
 		               "dereferenced RandomIterator first. "
 		               "e.g. *first = value is valid" );
-		impl::parallel_for_each(
+		impl::parallel_fill( daw::view( first, last ), value, policy, DAW_MOVE( ts ) );
+	}
+
+	/// Copy the items to first_out, which must not overlap them.  See
+	/// store_policy for how large outputs are written
+	/// @returns the end of the copied items
+	template<typename RandomIterator, typename RandomOutputIterator>
+	RandomOutputIterator copy( RandomIterator first,
+	                           RandomIterator last,
+	                           RandomOutputIterator first_out,
+	                           task_scheduler ts = get_task_scheduler( ),
+	                           store_policy policy = store_policy::automatic ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+		traits::is_random_access_iterator_test<RandomOutputIterator>( );
+		traits::is_input_iterator_test<RandomIterator>( );
+
+		impl::parallel_copy( daw::view( first, last ), first_out, policy, DAW_MOVE( ts ) );
+		return std::next( first_out, std::distance( first, last ) );
+	}
+
+	/// Copy construct the items into the uninitialized memory at first_out.
+	/// When a copy throws, the items already constructed are destroyed and the
+	/// exception is rethrown
+	/// @returns the end of the constructed items
+	template<typename RandomIterator, typename RandomOutputIterator>
+	RandomOutputIterator uninitialized_copy( RandomIterator first,
+	                                         RandomIterator last,
+	                                         RandomOutputIterator first_out,
+	                                         task_scheduler ts = get_task_scheduler( ),
+	                                         store_policy policy = store_policy::automatic ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+		traits::is_random_access_iterator_test<RandomOutputIterator>( );
+		traits::is_input_iterator_test<RandomIterator>( );
+
+		impl::parallel_uninitialized_copy(
+		  daw::view( first, last ), first_out, policy, DAW_MOVE( ts ) );
+		return std::next( first_out, std::distance( first, last ) );
+	}
+
+	/// Copy construct value into each item of the uninitialized memory
+	/// [first, last).  When a copy throws, the items already constructed are
+	/// destroyed and the exception is rethrown
+	template<typename RandomIterator, typename T>
+	void uninitialized_fill( RandomIterator first,
+	                         RandomIterator last,
+	                         T const &value,
+	                         task_scheduler ts = get_task_scheduler( ),
+	                         store_policy policy = store_policy::automatic ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+
+		impl::parallel_uninitialized_generate(
 		  daw::view( first, last ),
-		  [&value]( auto &item ) { item = value; },
+		  [&value]( size_t ) -> T const & { return value; },
+		  policy,
+		  DAW_MOVE( ts ) );
+	}
+
+	/// Construct unary_op of each item in the uninitialized memory at
+	/// first_out.  When unary_op or a construction throws, the items already
+	/// constructed are destroyed and the exception is rethrown
+	/// @returns the end of the constructed items
+	template<typename RandomIterator, typename RandomOutputIterator, typename UnaryOperation>
+	RandomOutputIterator uninitialized_transform( RandomIterator first,
+	                                              RandomIterator last,
+	                                              RandomOutputIterator first_out,
+	                                              UnaryOperation &&unary_op,
+	                                              task_scheduler ts = get_task_scheduler( ),
+	                                              store_policy policy = store_policy::automatic ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+		traits::is_random_access_iterator_test<RandomOutputIterator>( );
+		traits::is_input_iterator_test<RandomIterator>( );
+		static_assert( concept_checks::is_callable_v<UnaryOperation, RandomIterator>,
+		               "UnaryOperation passed to uninitialized_transform must accept the value "
+		               "referenced by first. e.g unary_op( *first ) must be valid" );
+
+		auto const last_out = std::next( first_out, std::distance( first, last ) );
+		impl::parallel_uninitialized_generate(
+		  daw::view( first_out, last_out ),
+		  [first, op = daw::traits::lift_func( DAW_FWD( unary_op ) )]( size_t n ) {
+			  return op( *std::next( first, static_cast<std::ptrdiff_t>( n ) ) );
+		  },
+		  policy,
+		  DAW_MOVE( ts ) );
+		return last_out;
+	}
+
+	/// Destroy the items of [first, last), leaving uninitialized memory
+	template<typename RandomIterator>
+	void destroy( RandomIterator first,
+	              RandomIterator last,
+	              task_scheduler ts = get_task_scheduler( ) ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+
+		impl::parallel_destroy( daw::view( first, last ), DAW_MOVE( ts ) );
+	}
+
+	/// Resize vec to count items, the new item at index n being gen( n ), with
+	/// the items written in parallel.  With std::allocator the new items are
+	/// value initialized before they are overwritten, with a
+	/// default_init_allocator trivial items are only written once
+	template<typename T, typename Alloc, typename Generator>
+	void resize_and_overwrite( std::vector<T, Alloc> &vec,
+	                           size_t count,
+	                           Generator &&gen,
+	                           task_scheduler ts = get_task_scheduler( ),
+	                           store_policy policy = store_policy::automatic ) {
+
+		auto const old_size = vec.size( );
+		if( count <= old_size ) {
+			vec.erase( std::next( vec.begin( ), static_cast<std::ptrdiff_t>( count ) ), vec.end( ) );
+			return;
+		}
+		vec.resize( count );
+		impl::parallel_generate(
+		  daw::view( std::next( vec.begin( ), static_cast<std::ptrdiff_t>( old_size ) ), vec.end( ) ),
+		  [old_size, g = daw::traits::lift_func( DAW_FWD( gen ) )]( size_t n ) {
+			  return g( old_size + n );
+		  },
+		  policy,
 		  DAW_MOVE( ts ) );
 	}
 
@@ -148,6 +302,39 @@ namespace daw::algorithm::parallel {
 		                              DAW_MOVE( ts ) );
 	}
 
+	/// reduce over forward or input iterators.  The calling thread reads
+	/// blocks of items while tasks reduce the blocks read before, and the
+	/// results of the blocks are reduced in order
+	template<typename T, impl::block_input_iterator Iterator, typename BinaryOperation>
+	[[nodiscard]] T reduce( Iterator first,
+	                        Iterator last,
+	                        T init,
+	                        BinaryOperation &&binary_op,
+	                        task_scheduler ts = get_task_scheduler( ) ) {
+
+		static_assert( concept_checks::is_callable_v<BinaryOperation, Iterator, Iterator>,
+		               "BinaryOperation passed to reduce must take two values referenced by "
+		               "first. e.g binary_op( *first, *first ) must be valid" );
+
+		auto op = daw::traits::lift_func( DAW_FWD( binary_op ) );
+		auto const blocks = impl::parallel_map_blocks<std::optional<T>>(
+		  DAW_MOVE( first ),
+		  DAW_MOVE( last ),
+		  [&op]( auto block ) {
+			  auto it = block.begin( );
+			  auto result = static_cast<T>( *it );
+			  for( ++it; it != block.end( ); ++it ) {
+				  result = op( DAW_MOVE( result ), *it );
+			  }
+			  return std::optional<T>( DAW_MOVE( result ) );
+		  },
+		  DAW_MOVE( ts ) );
+		for( auto const &block : blocks ) {
+			init = op( DAW_MOVE( init ), *block );
+		}
+		return init;
+	}
+
 	template<typename T, typename RandomIterator>
 	[[nodiscard]] T reduce( RandomIterator first,
 	                        RandomIterator last,
@@ -162,6 +349,18 @@ namespace daw::algorithm::parallel {
 		                                         DAW_MOVE( ts ) );
 	}
 
+	/// The sum of the items of forward or input iterators, starting from init
+	template<typename T, impl::block_input_iterator Iterator>
+	[[nodiscard]] T
+	reduce( Iterator first, Iterator last, T init, task_scheduler ts = get_task_scheduler( ) ) {
+
+		return daw::algorithm::parallel::reduce( DAW_MOVE( first ),
+		                                         DAW_MOVE( last ),
+		                                         DAW_MOVE( init ),
+		                                         std::plus<>{ },
+		                                         DAW_MOVE( ts ) );
+	}
+
 	template<typename RandomIterator>
 	[[nodiscard]] decltype( auto )
 	reduce( RandomIterator first, RandomIterator last, task_scheduler ts = get_task_scheduler( ) ) {
@@ -190,11 +389,12 @@ namespace daw::algorithm::parallel {
 
 	template<typename RandomIterator, typename Compare = std::less<>>
 	[[nodiscard]] decltype( auto ) max_element( RandomIterator first,
-	                                            RandomIterator const last,
+	                                            RandomIterator last,
 	                                            task_scheduler ts = get_task_scheduler( ),
-	                                            Compare comp = Compare{ } ) {
+	                                            Compare &&comp = Compare{ } ) {
 
 		traits::is_random_access_iterator_test<RandomIterator>( );
+		traits::is_input_iterator_test<RandomIterator>( );
 		concept_checks::is_binary_predicate_test<Compare, RandomIterator, RandomIterator>( );
 
 		return impl::parallel_max_element( daw::view( first, last ),
@@ -202,12 +402,53 @@ namespace daw::algorithm::parallel {
 		                                   DAW_MOVE( ts ) );
 	}
 
+	/// The smallest and the largest items in one pass
+	/// @returns a std::pair of iterators to the first of the smallest and the
+	/// last of the largest items, or of last when the range is empty
+	template<typename RandomIterator, typename Compare = std::less<>>
+	[[nodiscard]] decltype( auto ) minmax_element( RandomIterator first,
+	                                               RandomIterator last,
+	                                               task_scheduler ts = get_task_scheduler( ),
+	                                               Compare &&comp = Compare{ } ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+		traits::is_input_iterator_test<RandomIterator>( );
+		concept_checks::is_binary_predicate_test<Compare, RandomIterator, RandomIterator>( );
+
+		return impl::parallel_minmax_element( daw::view( first, last ),
+		                                      daw::traits::lift_func( DAW_FWD( comp ) ),
+		                                      DAW_MOVE( ts ) );
+	}
+
+	/// Compute several reductions of the items in one pass, e.g.
+	/// aggregate( first, last, ts, aggregators::sum{ }, aggregators::max{ } )
+	/// @returns a std::tuple of the result of each aggregator, see aggregators.h
+	template<typename RandomIterator, typename... Aggregators>
+	[[nodiscard]] auto aggregate( RandomIterator first,
+	                              RandomIterator last,
+	                              task_scheduler ts,
+	                              Aggregators &&...aggs ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+		traits::is_input_iterator_test<RandomIterator>( );
+		static_assert( sizeof...( Aggregators ) > 0, "aggregate needs at least one aggregator" );
+
+		return impl::parallel_aggregate( daw::view( first, last ), DAW_MOVE( ts ), DAW_FWD( aggs )... );
+	}
+
+	template<typename RandomIterator, not_cvref_of<task_scheduler>... Aggregators>
+	[[nodiscard]] auto aggregate( RandomIterator first, RandomIterator last, Aggregators &&...aggs ) {
+		return daw::algorithm::parallel::aggregate(
+		  first, last, get_task_scheduler( ), DAW_FWD( aggs )... );
+	}
+
 	template<typename RandomIterator, typename RandomOutputIterator, typename UnaryOperation>
 	void transform( RandomIterator first,
 	                RandomIterator const last,
 	                RandomOutputIterator first_out,
 	                UnaryOperation &&unary_op,
-	                task_scheduler ts = get_task_scheduler( ) ) {
+	                task_scheduler ts = get_task_scheduler( ),
+	                store_policy policy = store_policy::automatic ) {
 
 		traits::is_random_access_iterator_test<RandomIterator>( );
 		static_assert( concept_checks::is_callable_v<UnaryOperation, RandomIterator>,
@@ -225,7 +466,8 @@ namespace daw::algorithm::parallel {
 		impl::parallel_map( daw::view( first, last ),
 		                    first_out,
 		                    daw::traits::lift_func( DAW_FWD( unary_op ) ),
-		                    DAW_MOVE( ts ) );
+		                    DAW_MOVE( ts ),
+		                    policy );
 	}
 
 	template<typename RandomIterator1,
@@ -472,8 +714,8 @@ namespace daw::algorithm::parallel {
 		traits::is_input_iterator_test<RandomIterator2>( );
 		concept_checks::is_equality_comparable_test<RandomIterator1, RandomIterator2>( );
 
-		auto pred = []( auto const &lhs, auto const &rhs ) { return lhs == rhs; };
-		return impl::parallel_equal( first1, last1, first2, last2, DAW_MOVE( pred ), DAW_MOVE( ts ) );
+		return impl::parallel_equal(
+		  first1, last1, first2, last2, std::equal_to<>{ }, DAW_MOVE( ts ) );
 	}
 
 	template<typename RandomIterator, typename UnaryPredicate>
@@ -499,16 +741,239 @@ namespace daw::algorithm::parallel {
 		traits::is_random_access_iterator_test<RandomIterator>( );
 		traits::is_input_iterator_test<RandomIterator>( );
 
-		return impl::parallel_count(
-		  first,
-		  last,
-		  [&value]( auto const &rhs ) { return value == rhs; },
+		return impl::parallel_count( daw::view( first, last ),
+		                             impl::equal_to_value<T>{ &value },
+		                             DAW_MOVE( ts ) );
+	}
+
+	/// count_if over forward or input iterators.  The calling thread reads
+	/// blocks of items while tasks count the blocks read before
+	template<impl::block_input_iterator Iterator, typename UnaryPredicate>
+	[[nodiscard]] size_t count_if( Iterator first,
+	                               Iterator last,
+	                               UnaryPredicate &&pred,
+	                               task_scheduler ts = get_task_scheduler( ) ) {
+
+		concept_checks::is_unary_predicate_test<UnaryPredicate, Iterator>( );
+
+		auto const blocks = impl::parallel_map_blocks<size_t>(
+		  DAW_MOVE( first ),
+		  DAW_MOVE( last ),
+		  [p = daw::traits::lift_func( DAW_FWD( pred ) )]( auto block ) {
+			  return static_cast<size_t>( std::count_if( block.begin( ), block.end( ), p ) );
+		  },
 		  DAW_MOVE( ts ) );
+		return std::accumulate( blocks.begin( ), blocks.end( ), size_t{ 0 } );
+	}
+
+	/// count over forward or input iterators
+	template<impl::block_input_iterator Iterator, typename T>
+	[[nodiscard]] size_t count( Iterator first,
+	                            Iterator last,
+	                            T const &value,
+	                            task_scheduler ts = get_task_scheduler( ) ) {
+
+		return daw::algorithm::parallel::count_if( DAW_MOVE( first ),
+		                                           DAW_MOVE( last ),
+		                                           impl::equal_to_value<T>{ &value },
+		                                           DAW_MOVE( ts ) );
+	}
+
+	/// Copy the items pred is true for to first_out, keeping their order
+	/// @returns the end of the copied items
+	template<typename RandomIterator, typename RandomOutputIterator, typename UnaryPredicate>
+	[[nodiscard]] RandomOutputIterator copy_if( RandomIterator first,
+	                                            RandomIterator last,
+	                                            RandomOutputIterator first_out,
+	                                            UnaryPredicate &&pred,
+	                                            task_scheduler ts = get_task_scheduler( ) ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+		traits::is_random_access_iterator_test<RandomOutputIterator>( );
+		concept_checks::is_unary_predicate_test<UnaryPredicate, RandomIterator>( );
+
+		return impl::parallel_copy_if( daw::view( first, last ),
+		                               first_out,
+		                               daw::traits::lift_func( DAW_FWD( pred ) ),
+		                               DAW_MOVE( ts ) );
+	}
+
+	/// Remove the items pred is true for, keeping the order of the rest
+	/// @returns the end of the kept items
+	template<typename RandomIterator, typename UnaryPredicate>
+	[[nodiscard]] RandomIterator remove_if( RandomIterator first,
+	                                        RandomIterator last,
+	                                        UnaryPredicate &&pred,
+	                                        task_scheduler ts = get_task_scheduler( ) ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+		concept_checks::is_unary_predicate_test<UnaryPredicate, RandomIterator>( );
+
+		return impl::parallel_remove_if( daw::view( first, last ),
+		                                 daw::traits::lift_func( DAW_FWD( pred ) ),
+		                                 DAW_MOVE( ts ) );
+	}
+
+	/// Put the items pred is true for first
+	/// @returns the first item pred is false for
+	template<typename RandomIterator, typename UnaryPredicate>
+	[[nodiscard]] RandomIterator partition( RandomIterator first,
+	                                        RandomIterator last,
+	                                        UnaryPredicate &&pred,
+	                                        task_scheduler ts = get_task_scheduler( ) ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+		concept_checks::is_unary_predicate_test<UnaryPredicate, RandomIterator>( );
+
+		return impl::parallel_partition( daw::view( first, last ),
+		                                 daw::traits::lift_func( DAW_FWD( pred ) ),
+		                                 DAW_MOVE( ts ) );
+	}
+
+	/// Put the items pred is true for first, keeping the order within both
+	/// groups
+	/// @returns the first item pred is false for
+	template<typename RandomIterator, typename UnaryPredicate>
+	[[nodiscard]] RandomIterator stable_partition( RandomIterator first,
+	                                               RandomIterator last,
+	                                               UnaryPredicate &&pred,
+	                                               task_scheduler ts = get_task_scheduler( ) ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+		concept_checks::is_unary_predicate_test<UnaryPredicate, RandomIterator>( );
+
+		return impl::parallel_stable_partition( daw::view( first, last ),
+		                                        daw::traits::lift_func( DAW_FWD( pred ) ),
+		                                        DAW_MOVE( ts ) );
+	}
+
+	/// Remove all but the first item of each run of equal items
+	/// @returns the end of the kept items
+	template<typename RandomIterator, typename BinaryPredicate = std::equal_to<>>
+	[[nodiscard]] RandomIterator unique( RandomIterator first,
+	                                     RandomIterator last,
+	                                     task_scheduler ts = get_task_scheduler( ),
+	                                     BinaryPredicate &&pred = BinaryPredicate{ } ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+		concept_checks::is_binary_predicate_test<BinaryPredicate, RandomIterator, RandomIterator>( );
+
+		return impl::parallel_unique( daw::view( first, last ),
+		                              daw::traits::lift_func( DAW_FWD( pred ) ),
+		                              DAW_MOVE( ts ) );
+	}
+
+	/// Put the item that belongs at nth in sorted order there, with no item
+	/// before it ordered after it and none after it ordered before it
+	template<random_access_iterator RandomIterator, typename Compare = std::less<>>
+	void nth_element( RandomIterator first,
+	                  RandomIterator nth,
+	                  RandomIterator last,
+	                  task_scheduler ts = get_task_scheduler( ),
+	                  Compare &&comp = Compare{ } ) {
+
+		impl::parallel_nth_element( daw::view( first, last ),
+		                            nth,
+		                            daw::traits::lift_func( DAW_FWD( comp ) ),
+		                            DAW_MOVE( ts ) );
+	}
+
+	/// Sort the items that belong in [first, middle) there, the order of the
+	/// rest is unspecified
+	template<random_access_iterator RandomIterator, typename Compare = std::less<>>
+	void partial_sort( RandomIterator first,
+	                   RandomIterator middle,
+	                   RandomIterator last,
+	                   task_scheduler ts = get_task_scheduler( ),
+	                   Compare &&comp = Compare{ } ) {
+
+		impl::parallel_partial_sort( daw::view( first, last ),
+		                             middle,
+		                             daw::traits::lift_func( DAW_FWD( comp ) ),
+		                             DAW_MOVE( ts ) );
+	}
+
+	/// The k items that come first in the order of comp, largest first by
+	/// default, sorted.  The range is not modified
+	template<random_access_iterator RandomIterator, typename Compare = std::greater<>>
+	[[nodiscard]] auto top_k( RandomIterator first,
+	                          RandomIterator last,
+	                          size_t k,
+	                          task_scheduler ts = get_task_scheduler( ),
+	                          Compare &&comp = Compare{ } ) {
+
+		return impl::parallel_top_k( daw::view( first, last ),
+		                             k,
+		                             daw::traits::lift_func( DAW_FWD( comp ) ),
+		                             DAW_MOVE( ts ) );
+	}
+
+	/// The number of items in each of bucket_count buckets, bucket( item )
+	/// gives the bucket of item and must be less than bucket_count.  One pass
+	/// is made over the items whatever the bucket count
+	template<typename RandomIterator, typename Bucket>
+	[[nodiscard]] std::vector<size_t> histogram( RandomIterator first,
+	                                             RandomIterator last,
+	                                             Bucket &&bucket,
+	                                             size_t bucket_count,
+	                                             task_scheduler ts = get_task_scheduler( ) ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+		traits::is_input_iterator_test<RandomIterator>( );
+
+		return impl::parallel_histogram( daw::view( first, last ),
+		                                 daw::traits::lift_func( DAW_FWD( bucket ) ),
+		                                 bucket_count,
+		                                 DAW_MOVE( ts ) );
+	}
+
+	/// The number of items for each value of key( item ), the items themselves
+	/// by default
+	/// @returns a std::unordered_map of the keys to their counts
+	template<typename RandomIterator, typename KeyFunction = std::identity>
+	[[nodiscard]] auto count_by_key( RandomIterator first,
+	                                 RandomIterator last,
+	                                 task_scheduler ts = get_task_scheduler( ),
+	                                 KeyFunction &&key = KeyFunction{ } ) {
+
+		traits::is_random_access_iterator_test<RandomIterator>( );
+		traits::is_input_iterator_test<RandomIterator>( );
+
+		return impl::parallel_count_by_key(
+		  daw::view( first, last ), daw::traits::lift_func( DAW_FWD( key ) ), DAW_MOVE( ts ) );
+	}
+
+	/// Combine the values of items with equal keys using reducer, which must
+	/// be associative.  The keys need not be sorted, the values of a key are
+	/// combined in the order of the items.  Key and value must be default
+	/// constructible
+	/// @returns a std::vector of each key and its value, in no particular order
+	template<typename KeyIterator, typename ValueIterator, typename BinaryOperation>
+	[[nodiscard]] auto reduce_by_key( KeyIterator first_key,
+	                                  KeyIterator last_key,
+	                                  ValueIterator first_value,
+	                                  BinaryOperation &&reducer,
+	                                  task_scheduler ts = get_task_scheduler( ) ) {
+
+		traits::is_random_access_iterator_test<KeyIterator>( );
+		traits::is_random_access_iterator_test<ValueIterator>( );
+		traits::is_input_iterator_test<KeyIterator>( );
+		traits::is_input_iterator_test<ValueIterator>( );
+
+		return impl::parallel_reduce_by_key( daw::view( first_key, last_key ),
+		                                     first_value,
+		                                     daw::traits::lift_func( DAW_FWD( reducer ) ),
+		                                     DAW_MOVE( ts ) );
 	}
 
 	template<size_t minimum_size = 1>
 	using default_range_splitter = impl::split_range_t<minimum_size>;
 
+	/// Splits on alignment byte boundaries of the items written, such as a
+	/// cache line or a page
+	template<size_t minimum_size = 1, size_t alignment = impl::cache_line_size>
+	using aligned_range_splitter = impl::aligned_split_range_t<minimum_size, alignment>;
+
 	template<typename PartitionPolicy = default_range_splitter<>,
 	         typename RandomIterator,
 	         typename Function>
@@ -0,0 +1,379 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include "impl/daw_function.h"
+#include "task_scheduler.h"
+
+#include <daw/daw_exception.h>
+#include <daw/daw_move.h>
+#include <daw/daw_traits.h>
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace daw {
+	/// The default number of values an async_generator produces ahead of its
+	/// consumer
+	inline constexpr std::size_t default_generator_lookahead = 64;
+
+	namespace impl {
+		/// State shared by an async_generator and its producer task.  At most one
+		/// producer task runs at a time, it stops when lookahead values are
+		/// waiting and is restarted when the consumer takes one, so no worker
+		/// blocks on a full buffer
+		template<typename T>
+		class async_generator_state_t
+		  : public std::enable_shared_from_this<async_generator_state_t<T>> {
+
+			std::mutex m_mut{ };
+			std::vector<std::optional<T>> m_values;
+			std::size_t m_front = 0;
+			std::size_t m_size = 0;
+			bool m_is_producing = false;
+			bool m_is_done = false;
+			bool m_is_cancelled = false;
+			std::exception_ptr m_error = nullptr;
+			std::coroutine_handle<> m_waiter = nullptr;
+			std::function<std::optional<T>( )> m_producer;
+			task_scheduler m_ts;
+
+		public:
+			async_generator_state_t( std::function<std::optional<T>( )> producer,
+			                         std::size_t lookahead,
+			                         task_scheduler ts )
+			  : m_values( lookahead )
+			  , m_producer( DAW_MOVE( producer ) )
+			  , m_ts( DAW_MOVE( ts ) ) {
+
+				daw::exception::precondition_check( lookahead > 0,
+				                                    "The lookahead of a generator must be positive" );
+			}
+
+			/// Take the producer before the first value is requested, to compose it
+			[[nodiscard]] std::function<std::optional<T>( )> take_producer( ) {
+				auto const lck = std::lock_guard( m_mut );
+				daw::exception::precondition_check(
+				  not m_is_producing and not m_is_done and m_size == 0,
+				  "The generator has already started" );
+				m_is_done = true;
+				return DAW_MOVE( m_producer );
+			}
+
+			[[nodiscard]] task_scheduler const &get_task_scheduler( ) const {
+				return m_ts;
+			}
+
+			[[nodiscard]] std::size_t lookahead( ) const {
+				return m_values.size( );
+			}
+
+			/// Stop producing and wait for a producer task that has been started to
+			/// finish, running pending tasks meanwhile, so the producer is not called
+			/// once the generator is gone
+			void cancel( ) {
+				{
+					auto const lck = std::lock_guard( m_mut );
+					m_is_cancelled = true;
+				}
+				while( true ) {
+					{
+						auto const lck = std::lock_guard( m_mut );
+						if( not m_is_producing ) {
+							return;
+						}
+					}
+					if( not m_ts.help_run_next_task( ) ) {
+						std::this_thread::yield( );
+					}
+				}
+			}
+
+			/// Take the next value without waiting
+			/// @returns the value, or nothing with is_done set when the sequence has
+			/// ended, or nothing when the value is not ready yet
+			[[nodiscard]] std::optional<T> try_pop( bool &is_done ) {
+				auto const lck = std::lock_guard( m_mut );
+				return try_pop_locked( is_done );
+			}
+
+			/// Take the next value, running pending tasks until it is ready
+			/// @returns nothing at the end of the sequence
+			[[nodiscard]] std::optional<T> pop( ) {
+				while( true ) {
+					bool is_done = false;
+					if( auto result = try_pop( is_done ); result or is_done ) {
+						return result;
+					}
+					if( not m_ts.help_run_next_task( ) ) {
+						std::this_thread::yield( );
+					}
+				}
+			}
+
+			/// Resume waiter once a value is ready or the sequence has ended
+			/// @returns false when that is already the case and waiter must not
+			/// suspend
+			[[nodiscard]] bool suspend( std::coroutine_handle<> waiter ) {
+				auto const lck = std::lock_guard( m_mut );
+				if( m_size > 0 or m_is_done ) {
+					return false;
+				}
+				m_waiter = waiter;
+				start_producer( );
+				return true;
+			}
+
+		private:
+			/// Called with the lock held
+			[[nodiscard]] std::optional<T> try_pop_locked( bool &is_done ) {
+				if( m_size == 0 ) {
+					is_done = m_is_done;
+					if( is_done and m_error ) {
+						std::rethrow_exception( m_error );
+					}
+					start_producer( );
+					return { };
+				}
+				auto &slot = m_values[m_front];
+				auto result = DAW_MOVE( slot );
+				slot.reset( );
+				m_front = ( m_front + 1 ) % m_values.size( );
+				--m_size;
+				start_producer( );
+				return result;
+			}
+
+			/// Called with the lock held
+			void start_producer( ) {
+				if( m_is_producing or m_is_done or m_size == m_values.size( ) ) {
+					return;
+				}
+				m_is_producing = true;
+				if( not m_ts.add_task( [self = this->shared_from_this( )]( ) { self->produce( ); } ) ) {
+					m_is_producing = false;
+					throw daw::unable_to_add_task_exception{ };
+				}
+			}
+
+			void produce( ) {
+				auto lck = std::unique_lock( m_mut );
+				while( not m_is_cancelled and m_size < m_values.size( ) ) {
+					lck.unlock( );
+					auto value = std::optional<T>( );
+					auto error = std::exception_ptr( );
+					try {
+						value = m_producer( );
+					} catch( ... ) { error = std::current_exception( ); }
+					lck.lock( );
+					if( not value ) {
+						m_is_done = true;
+						m_error = DAW_MOVE( error );
+						break;
+					}
+					m_values[( m_front + m_size ) % m_values.size( )] = DAW_MOVE( value );
+					++m_size;
+					if( m_waiter ) {
+						auto waiter = std::exchange( m_waiter, nullptr );
+						lck.unlock( );
+						resume( waiter );
+						lck.lock( );
+					}
+				}
+				m_is_producing = false;
+				auto waiter = std::exchange( m_waiter, nullptr );
+				lck.unlock( );
+				resume( waiter );
+			}
+
+			/// The waiter resumes on the scheduler so the producer is not held up
+			/// by the consumer
+			void resume( std::coroutine_handle<> waiter ) {
+				if( waiter and not m_ts.add_task( [waiter]( ) { waiter.resume( ); } ) ) {
+					waiter.resume( );
+				}
+			}
+		};
+	} // namespace impl
+
+	/// A sequence of values produced on a task_scheduler ahead of the consumer,
+	/// up to a lookahead.  Iterate it, blocking while running pending tasks, or
+	/// co_await it from a coroutine.  Stages added with next are applied to
+	/// each value as it is produced, without materializing the sequence
+	template<typename T>
+	class [[nodiscard]] async_generator {
+		std::shared_ptr<impl::async_generator_state_t<T>> m_state;
+
+		template<typename>
+		friend class async_generator;
+
+	public:
+		using value_type = T;
+
+		/// producer returns the next value or an empty optional at the end of
+		/// the sequence.  It is only called from one task at a time, and not
+		/// after the generator is destroyed
+		async_generator( std::function<std::optional<T>( )> producer,
+		                 std::size_t lookahead = default_generator_lookahead,
+		                 task_scheduler ts = get_task_scheduler( ) )
+		  : m_state( std::make_shared<impl::async_generator_state_t<T>>( DAW_MOVE( producer ),
+		                                                                  lookahead,
+		                                                                  DAW_MOVE( ts ) ) ) {}
+
+		async_generator( async_generator && ) noexcept = default;
+
+		/// The producer of the generator replaced is cancelled, as on destruction
+		async_generator &operator=( async_generator &&rhs ) noexcept {
+			if( this != &rhs ) {
+				if( m_state ) {
+					m_state->cancel( );
+				}
+				m_state = DAW_MOVE( rhs.m_state );
+			}
+			return *this;
+		}
+
+		async_generator( async_generator const & ) = delete;
+		async_generator &operator=( async_generator const & ) = delete;
+
+		~async_generator( ) {
+			if( m_state ) {
+				m_state->cancel( );
+			}
+		}
+
+		/// A generator of func applied to each value.  Must be called before any
+		/// value has been taken, this generator is left empty
+		template<typename Function>
+		[[nodiscard]] auto next( Function &&func ) && {
+			using result_t = daw::remove_cvref_t<std::invoke_result_t<Function &, T>>;
+			auto producer = m_state->take_producer( );
+			auto const lookahead = m_state->lookahead( );
+			auto ts = m_state->get_task_scheduler( );
+			return async_generator<result_t>(
+			  [producer = DAW_MOVE( producer ),
+			   func = fs::impl::make_callable( DAW_FWD( func ) )]( ) mutable -> std::optional<result_t> {
+				  auto value = producer( );
+				  if( not value ) {
+					  return { };
+				  }
+				  return std::invoke( func, DAW_MOVE( *value ) );
+			  },
+			  lookahead,
+			  DAW_MOVE( ts ) );
+		}
+
+		/// Take the next value, running pending tasks until it is ready
+		/// @returns nothing at the end of the sequence
+		[[nodiscard]] std::optional<T> pop( ) {
+			return m_state->pop( );
+		}
+
+		class awaiter {
+			impl::async_generator_state_t<T> *m_state;
+			std::optional<T> m_value{ };
+			bool m_is_done = false;
+
+		public:
+			explicit awaiter( impl::async_generator_state_t<T> &state )
+			  : m_state( &state ) {}
+
+			[[nodiscard]] bool await_ready( ) {
+				m_value = m_state->try_pop( m_is_done );
+				return m_value or m_is_done;
+			}
+
+			[[nodiscard]] bool await_suspend( std::coroutine_handle<> waiter ) {
+				return m_state->suspend( waiter );
+			}
+
+			/// @returns nothing at the end of the sequence
+			[[nodiscard]] std::optional<T> await_resume( ) {
+				if( m_value or m_is_done ) {
+					return DAW_MOVE( m_value );
+				}
+				return m_state->try_pop( m_is_done );
+			}
+		};
+
+		/// co_await the next value, nothing at the end of the sequence.  The
+		/// coroutine resumes on the task_scheduler when it had to wait
+		[[nodiscard]] awaiter operator co_await( ) & {
+			return awaiter( *m_state );
+		}
+
+		class iterator {
+			async_generator *m_gen = nullptr;
+			std::optional<T> m_value{ };
+
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = T *;
+			using reference = T &;
+
+			iterator( ) = default;
+
+			explicit iterator( async_generator &gen )
+			  : m_gen( &gen )
+			  , m_value( gen.pop( ) ) {}
+
+			[[nodiscard]] reference operator*( ) {
+				return *m_value;
+			}
+
+			[[nodiscard]] pointer operator->( ) {
+				return std::addressof( *m_value );
+			}
+
+			iterator &operator++( ) {
+				m_value = m_gen->pop( );
+				return *this;
+			}
+
+			void operator++( int ) {
+				operator++( );
+			}
+
+			[[nodiscard]] bool operator==( std::default_sentinel_t ) const {
+				return not m_value;
+			}
+		};
+
+		/// Starts the generator if needed and takes the first value
+		[[nodiscard]] iterator begin( ) {
+			return iterator( *this );
+		}
+
+		[[nodiscard]] std::default_sentinel_t end( ) const {
+			return { };
+		}
+	};
+
+	/// A generator of the values of producer, see async_generator
+	template<typename Producer>
+	[[nodiscard]] auto make_async_generator( Producer &&producer,
+	                                         std::size_t lookahead = default_generator_lookahead,
+	                                         task_scheduler ts = get_task_scheduler( ) ) {
+		using result_t = daw::remove_cvref_t<std::invoke_result_t<Producer &>>;
+		using value_t = typename result_t::value_type;
+		return async_generator<value_t>( DAW_FWD( producer ), lookahead, DAW_MOVE( ts ) );
+	}
+} // namespace daw
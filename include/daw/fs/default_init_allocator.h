@@ -0,0 +1,50 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include <daw/daw_move.h>
+
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace daw::algorithm::parallel {
+	/// An allocator that default initializes the items a container constructs
+	/// without arguments, instead of value initializing them.  Growing a
+	/// std::vector of trivial items with it does not write them, so
+	/// resize_and_overwrite can write each one once, in parallel
+	template<typename T, typename Alloc = std::allocator<T>>
+	class default_init_allocator : public Alloc {
+		using traits_t = std::allocator_traits<Alloc>;
+
+	public:
+		template<typename U>
+		struct rebind {
+			using other = default_init_allocator<U, typename traits_t::template rebind_alloc<U>>;
+		};
+
+		using Alloc::Alloc;
+
+		default_init_allocator( ) = default;
+
+		template<typename U, typename A>
+		default_init_allocator( default_init_allocator<U, A> const &other ) noexcept
+		  : Alloc( static_cast<A const &>( other ) ) {}
+
+		template<typename U>
+		void construct( U *ptr ) noexcept( std::is_nothrow_default_constructible_v<U> ) {
+			::new( static_cast<void *>( ptr ) ) U;
+		}
+
+		template<typename U, typename... Args>
+		void construct( U *ptr, Args &&...args ) {
+			traits_t::construct( static_cast<Alloc &>( *this ), ptr, DAW_FWD( args )... );
+		}
+	};
+} // namespace daw::algorithm::parallel
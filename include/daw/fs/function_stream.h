@@ -25,12 +25,17 @@
 #include "daw_fs_concepts.h"
 #include "future_result.h"
 #include "impl/function_stream_impl.h"
+#include "impl/stream_pipeline_impl.h"
+#include "in_flight_limit.h"
 #include "package.h"
 #include "task_scheduler.h"
 
 #include <daw/cpp_17.h>
 #include <daw/daw_concepts.h>
 
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -39,12 +44,16 @@ namespace daw {
 	template<typename... Functions>
 	class function_stream {
 		using function_t = std::tuple<std::remove_cvref_t<Functions>...>;
-		using func_comp_t = impl::function_composer_t<Functions...>;
 
 		function_t m_funcs;
 
 	public:
 		bool continue_on_result_destruction = true;
+		/// Where each function after the first runs once its argument is ready
+		continuation_policy policy = continuation_policy::scheduled;
+		/// When set, each call holds a slot of limit until it has finished and
+		/// waits, or fails with would_block_exception, when there is none
+		in_flight_limit *limit = nullptr;
 
 		template<not_cvref_of<function_stream> F, typename... Fs>
 		requires( daw::all_true_v<
@@ -61,16 +70,55 @@ namespace daw {
 		explicit constexpr function_stream( std::tuple<Functions...> const &funcs )
 		  : m_funcs( funcs ) {}
 
+		/// The stages of the stream, after any fusion
+		[[nodiscard]] constexpr function_t const &functions( ) const noexcept {
+			return m_funcs;
+		}
+
 		template<typename... Args>
 		[[nodiscard]] auto operator( )( Args &&...args ) const {
-			using func_result_t = decltype( std::declval<func_comp_t>( ).apply( args... ) );
+			using func_result_t =
+			  impl::package_result_t<function_t, std::tuple<daw::remove_cvref_t<Args>...>>;
 			future_result_t<func_result_t> result{ };
-			impl::call<0>( make_shared_package( continue_on_result_destruction,
+			auto slot = impl::in_flight_slot( );
+			if( limit ) {
+				auto ts = get_task_scheduler( );
+				if( not limit->acquire( ts ) ) {
+					result.set_exception( would_block_exception{ } );
+					return result;
+				}
+				slot = impl::in_flight_slot( *limit );
+			}
+			auto package = make_shared_package( continue_on_result_destruction,
 			                                    result.get_handle( ),
 			                                    m_funcs,
-			                                    DAW_FWD( args )... ) );
+			                                    DAW_FWD( args )... );
+			package->set_in_flight_slot( DAW_MOVE( slot ) );
+			impl::call<0>( DAW_MOVE( package ), policy );
 			return result;
 		}
+
+		/// Stream each element of input through the functions and pass the
+		/// results, in input order unless a daw::parallel_stage is unordered, to
+		/// sink.  Each function drains a bounded buffer
+		/// so many elements are in flight at once without a package or task per
+		/// element.  When max_in_flight elements are in the stream the caller runs
+		/// pending tasks until there is room.  Returns once every element has
+		/// reached sink and rethrows the first exception thrown by a function or
+		/// sink
+		template<typename Range, typename Sink>
+		void run( Range &&input,
+		          Sink &&sink,
+		          std::size_t max_in_flight = default_stream_buffer_size ) const {
+			using input_t = daw::remove_cvref_t<decltype( *std::begin( input ) )>;
+			using pipeline_t = impl::stream_pipeline_t<std::remove_reference_t<Sink>,
+			                                           input_t,
+			                                           std::remove_cvref_t<Functions>...>;
+
+			auto pipeline =
+			  std::make_shared<pipeline_t>( get_task_scheduler( ), m_funcs, sink, max_in_flight );
+			pipeline->run( std::begin( input ), std::end( input ) );
+		}
 	}; // function_stream
 
 	template<typename... Functions>
@@ -84,9 +132,40 @@ namespace daw {
 	function_stream( std::tuple<Functions> const &... )
 	  -> function_stream<std::remove_cvref_t<Functions>...>;
 
+	/// Mark func as a cheap stage that can be fused with the fusible stages next
+	/// to it and run in the same task
+	template<typename Function>
+	[[nodiscard]] constexpr auto fusible( Function &&func ) {
+		return impl::make_fused_function( fs::impl::make_callable( DAW_FWD( func ) ) );
+	}
+
+	/// Combine funcs into a single stage that runs them one after another in the
+	/// same task
+	template<typename... Functions>
+	[[nodiscard]] constexpr auto fuse( Functions &&...funcs ) {
+		return impl::make_fused_function( fs::impl::make_callable( DAW_FWD( funcs ) )... );
+	}
+
+	/// Mark func as a stage that function_stream::run calls from up to degree
+	/// tasks at once, for a bottleneck stage.  func must be safe to call
+	/// concurrently.  With parallel_order::ordered the results are passed on in
+	/// input order, unordered passes each on as soon as it is ready
+	template<typename Function>
+	[[nodiscard]] constexpr auto parallel_stage( Function &&func,
+	                                             std::size_t degree,
+	                                             parallel_order order = parallel_order::ordered ) {
+		using func_t = daw::remove_cvref_t<decltype( fs::impl::make_callable( DAW_FWD( func ) ) )>;
+		return impl::parallel_stage_t<func_t>{ fs::impl::make_callable( DAW_FWD( func ) ),
+		                                       degree,
+		                                       order };
+	}
+
+	/// Create a function_stream from funcs.  Runs of adjacent fusible stages are
+	/// fused into one stage
 	template<typename... Functions>
 	constexpr auto make_function_stream( Functions &&...funcs ) noexcept {
-		return function_stream( std::tuple( fs::impl::make_callable( funcs )... ) );
+		return function_stream(
+		  impl::fuse_stage_tuple( std::tuple( fs::impl::make_callable( funcs )... ) ) );
 	}
 
 	template<Waitable... Waitables>
@@ -100,17 +179,18 @@ namespace daw {
 		friend class daw::future_generator_t;
 
 		std::tuple<Funcs...> m_funcs;
+		continuation_policy m_policy = continuation_policy::scheduled;
 
 		template<typename... Functions>
 		[[nodiscard]] static constexpr future_generator_t<Functions...>
-		make_future_generator( std::tuple<Functions...> &&tp_funcs ) {
-			return future_generator_t<Functions...>{ DAW_MOVE( tp_funcs ) };
+		make_future_generator( continuation_policy policy, std::tuple<Functions...> &&tp_funcs ) {
+			return future_generator_t<Functions...>{ policy, DAW_MOVE( tp_funcs ) };
 		}
 
 		template<typename... Functions>
 		[[nodiscard]] static constexpr future_generator_t<Functions...>
-		make_future_generator( std::tuple<Functions...> const &tp_funcs ) {
-			return future_generator_t<Functions...>{ tp_funcs };
+		make_future_generator( continuation_policy policy, std::tuple<Functions...> const &tp_funcs ) {
+			return future_generator_t<Functions...>{ policy, tp_funcs };
 		}
 
 	public:
@@ -131,25 +211,40 @@ namespace daw {
 		explicit constexpr future_generator_t( std::tuple<Funcs...> &&tp_funcs )
 		  : m_funcs{ DAW_MOVE( tp_funcs ) } {}
 
+		constexpr future_generator_t( continuation_policy policy, std::tuple<Funcs...> const &tp_funcs )
+		  : m_funcs{ tp_funcs }
+		  , m_policy( policy ) {}
+
+		constexpr future_generator_t( continuation_policy policy, std::tuple<Funcs...> &&tp_funcs )
+		  : m_funcs{ DAW_MOVE( tp_funcs ) }
+		  , m_policy( policy ) {}
+
 		template<typename... Args>
 		[[nodiscard]] constexpr decltype( auto ) operator( )( Args &&...args ) const {
 			return get_function_stream( )( DAW_FWD( args )... );
 		}
 
-		[[nodiscard]] constexpr function_stream<Funcs...> get_function_stream( ) const {
-			return function_stream<Funcs...>( m_funcs );
+		/// Runs of adjacent fusible functions become a single stage of the stream
+		[[nodiscard]] constexpr auto get_function_stream( ) const {
+			auto result = function_stream( impl::fuse_stage_tuple( m_funcs ) );
+			result.policy = m_policy;
+			return result;
+		}
+
+		[[nodiscard]] constexpr continuation_policy policy( ) const noexcept {
+			return m_policy;
 		}
 
 		template<typename... NextFunctions>
 		[[nodiscard]] constexpr auto next( NextFunctions &&...next_functions ) const {
 			return make_future_generator(
-			  std::tuple_cat( m_funcs, std::make_tuple( DAW_FWD( next_functions )... ) ) );
+			  m_policy, std::tuple_cat( m_funcs, std::make_tuple( DAW_FWD( next_functions )... ) ) );
 		}
 
 		template<typename... NextFuncs>
 		[[nodiscard]] constexpr decltype( auto )
 		join( future_generator_t<NextFuncs...> const &fut2 ) const {
-			return make_future_generator( std::tuple_cat( m_funcs, fut2.m_funcs ) );
+			return make_future_generator( m_policy, std::tuple_cat( m_funcs, fut2.m_funcs ) );
 		}
 	};
 
@@ -204,9 +299,18 @@ namespace daw {
 		return impl::function_composer_t<std::remove_cv_t<Functions>...>( DAW_FWD( funcs )... );
 	}
 
-	template<typename... Functions>
+	template<not_cvref_of<continuation_policy>... Functions>
 	[[nodiscard]] constexpr auto compose_future( Functions &&...funcs ) noexcept {
 		return future_generator_t<std::remove_cv_t<Functions>...>(
 		  std::tuple<std::remove_cv_t<Functions>...>( DAW_FWD( funcs )... ) );
 	}
+
+	/// Compose functions into a future generator whose functions after the first
+	/// run as chosen by policy
+	template<typename... Functions>
+	[[nodiscard]] constexpr auto compose_future( continuation_policy policy,
+	                                             Functions &&...funcs ) noexcept {
+		return future_generator_t<std::remove_cv_t<Functions>...>(
+		  policy, std::tuple<std::remove_cv_t<Functions>...>( DAW_FWD( funcs )... ) );
+	}
 } // namespace daw
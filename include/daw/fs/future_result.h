@@ -25,12 +25,14 @@
 #include "impl/daw_function.h"
 #include "impl/daw_latch.h"
 #include "impl/future_result_impl.h"
+#include "in_flight_limit.h"
 #include "task_scheduler.h"
 
 #include <daw/cpp_17.h>
 #include <daw/daw_exception.h>
 #include <daw/daw_expected.h>
 #include <daw/daw_mutable_capture.h>
+#include <daw/daw_scope_guard.h>
 #include <daw/daw_traits.h>
 #include <daw/vector.h>
 
@@ -160,21 +162,41 @@ namespace daw {
 			return m_data.get( );
 		}
 
-		template<typename Function>
+		template<not_cvref_of<continuation_policy> Function>
 		[[nodiscard]] decltype( auto ) next( Function &&func ) {
 			return m_data.next( fs::impl::make_callable( DAW_FWD( func ) ) );
 		}
 
-		template<typename... Functions>
+		/// Add the next function in the chain, policy chooses where it runs once
+		/// this result is available
+		template<typename Function>
+		[[nodiscard]] decltype( auto ) next( continuation_policy policy, Function &&func ) {
+			return m_data.next( policy, fs::impl::make_callable( DAW_FWD( func ) ) );
+		}
+
+		template<not_cvref_of<continuation_policy>... Functions>
 		[[nodiscard]] decltype( auto ) fork( Functions &&...funcs ) {
 			return m_data.fork( fs::impl::make_callable( DAW_FWD( funcs ) )... );
 		}
 
-		template<typename Function, typename... Functions>
+		template<typename... Functions>
+		[[nodiscard]] decltype( auto ) fork( continuation_policy policy, Functions &&...funcs ) {
+			return m_data.fork( policy, fs::impl::make_callable( DAW_FWD( funcs ) )... );
+		}
+
+		template<not_cvref_of<continuation_policy> Function, typename... Functions>
 		[[nodiscard]] decltype( auto ) fork_join( Function &&joiner, Functions &&...funcs ) {
 			return m_data.fork_join( fs::impl::make_callable( DAW_FWD( joiner ) ),
 			                         fs::impl::make_callable( DAW_FWD( funcs ) )... );
 		}
+
+		template<typename Function, typename... Functions>
+		[[nodiscard]] decltype( auto )
+		fork_join( continuation_policy policy, Function &&joiner, Functions &&...funcs ) {
+			return m_data.fork_join( policy,
+			                         fs::impl::make_callable( DAW_FWD( joiner ) ),
+			                         fs::impl::make_callable( DAW_FWD( funcs ) )... );
+		}
 	};
 	// future_result_t
 
@@ -256,14 +278,42 @@ namespace daw {
 			                  DAW_FWD( args )... );
 		}
 
-		template<typename Function>
+		template<not_cvref_of<continuation_policy> Function>
 		[[nodiscard]] decltype( auto ) next( Function &&function ) {
 			return m_data.next( fs::impl::make_callable( DAW_FWD( function ) ) );
 		}
 
+		template<typename Function>
+		[[nodiscard]] decltype( auto ) next( continuation_policy policy, Function &&function ) {
+			return m_data.next( policy, fs::impl::make_callable( DAW_FWD( function ) ) );
+		}
+
+		template<not_cvref_of<continuation_policy> Function, typename... Functions>
+		[[nodiscard]] decltype( auto ) fork( Function &&func, Functions &&...funcs ) {
+			return m_data.fork( fs::impl::make_callable( DAW_FWD( func ) ),
+			                    fs::impl::make_callable( DAW_FWD( funcs ) )... );
+		}
+
+		template<typename Function, typename... Functions>
+		[[nodiscard]] decltype( auto )
+		fork( continuation_policy policy, Function &&func, Functions &&...funcs ) {
+			return m_data.fork( policy,
+			                    fs::impl::make_callable( DAW_FWD( func ) ),
+			                    fs::impl::make_callable( DAW_FWD( funcs ) )... );
+		}
+
+		template<not_cvref_of<continuation_policy> Function, typename... Functions>
+		[[nodiscard]] decltype( auto ) fork_join( Function &&joiner, Functions &&...funcs ) {
+			return m_data.fork_join( fs::impl::make_callable( DAW_FWD( joiner ) ),
+			                         fs::impl::make_callable( DAW_FWD( funcs ) )... );
+		}
+
 		template<typename Function, typename... Functions>
-		[[nodiscard]] decltype( auto ) fork( Function &&func, Functions &&...funcs ) const {
-			return m_data.fork( fs::impl::make_callable( DAW_FWD( func ), DAW_FWD( funcs ) )... );
+		[[nodiscard]] decltype( auto )
+		fork_join( continuation_policy policy, Function &&joiner, Functions &&...funcs ) {
+			return m_data.fork_join( policy,
+			                         fs::impl::make_callable( DAW_FWD( joiner ) ),
+			                         fs::impl::make_callable( DAW_FWD( funcs ) )... );
 		}
 	}; // future_result_t<void>
 
@@ -354,6 +404,45 @@ namespace daw {
 		                           DAW_FWD( args )... );
 	}
 
+	/// Run func( args... ) on ts as make_future_result does, holding a slot of
+	/// limit until it has finished.  When limit is full this waits as its policy
+	/// says, with in_flight_policy::would_block the result holds a
+	/// would_block_exception and func is not run
+	template<typename Function, typename... Args>
+	requires( invocable<Function, Args...> ) //
+	  [[nodiscard]] auto make_future_result( in_flight_limit &limit,
+	                                         task_scheduler ts,
+	                                         Function &&func,
+	                                         Args &&...args ) {
+		using result_t = daw::remove_cvref_t<decltype( func( DAW_FWD( args )... ) )>;
+		if( not limit.acquire( ts ) ) {
+			auto result = future_result_t<result_t>( );
+			result.set_exception( would_block_exception{ } );
+			return result;
+		}
+		try {
+			return make_future_result(
+			  ts,
+			  [&limit, func = daw::mutable_capture( fs::impl::make_callable( DAW_FWD( func ) ) )](
+			    auto &&...as ) {
+				  auto const release = daw::on_scope_exit( [&limit]( ) { limit.release( ); } );
+				  return func.move_out( )( DAW_FWD( as )... );
+			  },
+			  DAW_FWD( args )... );
+		} catch( ... ) {
+			limit.release( );
+			throw;
+		}
+	}
+
+	template<typename Function, typename... Args>
+	requires( invocable<Function, Args...> ) //
+	  [[nodiscard]] auto make_future_result( in_flight_limit &limit,
+	                                         Function &&func,
+	                                         Args &&...args ) {
+		return make_future_result( limit, get_task_scheduler( ), DAW_FWD( func ), DAW_FWD( args )... );
+	}
+
 	template<typename Function, typename... Args>
 	[[nodiscard]] decltype( auto ) async( Function &&func, Args &&...args ) {
 		static_assert( daw::traits::is_callable_v<std::remove_reference_t<Function>, Args...> );
@@ -411,8 +500,8 @@ namespace daw {
 				last = std::next( first, sz - 1 );
 			}
 			while( first != last ) {
-				auto l_it = ++first;
-				auto r_it = ++first;
+				auto l_it = first++;
+				auto r_it = first++;
 				auto &lhs = *l_it;
 				*out_it =
 				  DAW_MOVE( lhs ).next( [rhs = daw::mutable_capture( DAW_MOVE( *r_it ) ),
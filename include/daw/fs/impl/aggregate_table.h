@@ -0,0 +1,114 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include <daw/daw_move.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace daw::algorithm::parallel::impl {
+	/// An open addressing hash table that combines the value added for a key
+	/// with the one it holds.  Slots are probed linearly and the hash of each
+	/// item is kept, so growing or merging tables never hashes a key again.
+	/// Only used from one task at a time
+	template<typename Key,
+	         typename Value,
+	         typename Hash = std::hash<Key>,
+	         typename KeyEqual = std::equal_to<Key>>
+	class aggregate_table {
+		std::vector<std::uint64_t> m_hashes{ };
+		std::vector<std::optional<std::pair<Key, Value>>> m_items{ };
+		std::size_t m_size = 0;
+
+	public:
+		/// std::hash is the identity for integers on some standard libraries, so
+		/// it is mixed until both the low bits, that pick the slot, and the high
+		/// bits, that pick the shard, vary
+		[[nodiscard]] static std::uint64_t hash( Key const &key ) {
+			auto h = static_cast<std::uint64_t>( Hash{ }( key ) );
+			h ^= h >> 33U;
+			h *= 0xff51'afd7'ed55'8ccdULL;
+			h ^= h >> 33U;
+			h *= 0xc4ce'b9fe'1a85'ec53ULL;
+			h ^= h >> 33U;
+			return h;
+		}
+
+		/// Which of 2^shard_bits shards hash belongs to
+		[[nodiscard]] static constexpr std::size_t shard( std::uint64_t hash, int shard_bits ) {
+			if( shard_bits == 0 ) {
+				return 0;
+			}
+			return static_cast<std::size_t>( hash >> ( 64 - shard_bits ) );
+		}
+
+		[[nodiscard]] std::size_t size( ) const {
+			return m_size;
+		}
+
+		/// Add key with value, or make the value of key reducer( value of key,
+		/// value ) when it is present
+		template<typename K, typename V, typename Reducer>
+		void combine( std::uint64_t hash, K &&key, V &&value, Reducer &reducer ) {
+			if( ( m_size + 1 ) * 4 > m_items.size( ) * 3 ) {
+				grow( );
+			}
+			auto const mask = m_items.size( ) - 1;
+			for( auto pos = static_cast<std::size_t>( hash ) & mask;; pos = ( pos + 1 ) & mask ) {
+				auto &item = m_items[pos];
+				if( not item ) {
+					m_hashes[pos] = hash;
+					item.emplace( DAW_FWD( key ), DAW_FWD( value ) );
+					++m_size;
+					return;
+				}
+				if( m_hashes[pos] == hash and KeyEqual{ }( item->first, key ) ) {
+					item->second = reducer( DAW_MOVE( item->second ), DAW_FWD( value ) );
+					return;
+				}
+			}
+		}
+
+		/// Call func( hash, item ) for each item, in no particular order
+		template<typename Func>
+		void for_each( Func &&func ) {
+			for( std::size_t n = 0; n < m_items.size( ); ++n ) {
+				if( m_items[n] ) {
+					func( m_hashes[n], *m_items[n] );
+				}
+			}
+		}
+
+	private:
+		void grow( ) {
+			auto const capacity = std::max<std::size_t>( 16, 2 * m_items.size( ) );
+			auto hashes = std::exchange( m_hashes, std::vector<std::uint64_t>( capacity ) );
+			auto items =
+			  std::exchange( m_items, std::vector<std::optional<std::pair<Key, Value>>>( capacity ) );
+			auto const mask = capacity - 1;
+			for( std::size_t n = 0; n < items.size( ); ++n ) {
+				if( not items[n] ) {
+					continue;
+				}
+				auto pos = static_cast<std::size_t>( hashes[n] ) & mask;
+				while( m_items[pos] ) {
+					pos = ( pos + 1 ) & mask;
+				}
+				m_hashes[pos] = hashes[n];
+				m_items[pos] = DAW_MOVE( items[n] );
+			}
+		}
+	};
+} // namespace daw::algorithm::parallel::impl
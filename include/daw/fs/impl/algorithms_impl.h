@@ -23,8 +23,13 @@
 #pragma once
 
 #include "../future_result.h"
+#include "../in_flight_limit.h"
+#include "../scratch_arena.h"
+#include "../store_policy.h"
 #include "../task_scheduler.h"
+#include "aggregate_table.h"
 #include "daw_latch.h"
+#include "simd_kernels.h"
 
 #include <daw/daw_algorithm.h>
 #include <daw/daw_mutable_capture.h>
@@ -33,38 +38,240 @@
 #include <daw/parallel/daw_spin_lock.h>
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <cstdint>
 #include <iterator>
+#include <memory>
 #include <numeric>
 #include <optional>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace daw::algorithm::parallel::impl {
+	/// The size of a cache line, the unit that cores contend for when writing
+	inline constexpr size_t cache_line_size = 64;
+
+	/// A value alone on its cache line, so tasks writing neighbouring slots of
+	/// a vector of them do not slow each other down
+	template<typename T>
+	struct alignas( cache_line_size ) padded_slot {
+		T value{ };
+	};
+
+	/// The parts of a range, each within one unit of the others in size.  Part
+	/// boundaries fall on multiples of the unit after the first lead items,
+	/// which belong to the first part.  The bounds of a part are computed when
+	/// asked for, so nothing is stored per part and it is cheap to copy into
+	/// tasks
+	template<typename Iterator>
+	class [[nodiscard]] range_partition {
+		Iterator m_first{ };
+		size_t m_size = 0;
+		size_t m_count = 0;
+		size_t m_lead = 0;
+		size_t m_unit = 1;
+		// In units, the first m_larger parts hold one more than m_part_size
+		size_t m_part_size = 0;
+		size_t m_larger = 0;
+
+		constexpr range_partition( Iterator first,
+		                           size_t size,
+		                           size_t count,
+		                           size_t lead,
+		                           size_t unit,
+		                           size_t part_size,
+		                           size_t larger ) noexcept
+		  : m_first( DAW_MOVE( first ) )
+		  , m_size( size )
+		  , m_count( count )
+		  , m_lead( lead )
+		  , m_unit( unit )
+		  , m_part_size( part_size )
+		  , m_larger( larger ) {}
+
+		[[nodiscard]] constexpr size_t offset( size_t n ) const noexcept {
+			if( n == 0 ) {
+				return 0;
+			}
+			if( n == m_count ) {
+				return m_size;
+			}
+			return m_lead + ( n * m_part_size + std::min( n, m_larger ) ) * m_unit;
+		}
+
+	public:
+		constexpr range_partition( ) noexcept = default;
+
+		/// Split the item_count items starting at first into count parts
+		constexpr range_partition( Iterator first, size_t item_count, size_t count ) noexcept
+		  : range_partition( DAW_MOVE( first ), item_count, count, 0, 1 ) {}
+
+		/// Split the item_count items starting at first into up to count parts,
+		/// with the boundaries at lead + k * unit
+		constexpr range_partition( Iterator first,
+		                           size_t item_count,
+		                           size_t count,
+		                           size_t lead,
+		                           size_t unit ) noexcept
+		  : m_first( DAW_MOVE( first ) )
+		  , m_size( item_count )
+		  , m_lead( std::min( lead, item_count ) )
+		  , m_unit( unit ) {
+
+			auto const unit_count = ( item_count - m_lead + unit - 1 ) / unit;
+			if( item_count > 0 ) {
+				m_count = std::clamp<size_t>( count, 1, std::max<size_t>( unit_count, 1 ) );
+			}
+			if( unit_count > 0 ) {
+				m_part_size = unit_count / m_count;
+				m_larger = unit_count % m_count;
+			}
+		}
+
+		/// The number of parts
+		[[nodiscard]] constexpr size_t size( ) const noexcept {
+			return m_count;
+		}
+
+		[[nodiscard]] constexpr bool empty( ) const noexcept {
+			return m_count == 0;
+		}
+
+		[[nodiscard]] constexpr daw::view<Iterator> operator[]( size_t n ) const {
+			return daw::view<Iterator>(
+			  std::next( m_first, static_cast<std::ptrdiff_t>( offset( n ) ) ),
+			  std::next( m_first, static_cast<std::ptrdiff_t>( offset( n + 1 ) ) ) );
+		}
+
+		/// The parts [first_part, last_part) as a partition of their own, with
+		/// the same bounds.  Used to split the remaining work again
+		[[nodiscard]] constexpr range_partition slice( size_t first_part, size_t last_part ) const {
+			auto const first = offset( first_part );
+			return range_partition( std::next( m_first, static_cast<std::ptrdiff_t>( first ) ),
+			                        offset( last_part ) - first,
+			                        last_part - first_part,
+			                        first_part == 0 ? m_lead : 0,
+			                        m_unit,
+			                        m_part_size,
+			                        m_larger > first_part ? m_larger - first_part : 0 );
+		}
+	};
+
 	template<size_t MinRangeSize = 1>
 	struct [[nodiscard]] split_range_t {
 		static_assert( MinRangeSize != 0, "Minimum range size must be > 0" );
 		static constexpr size_t min_range_size = MinRangeSize;
 
+		/// Up to max_parts parts of at least MinRangeSize items, or one part
+		/// when the range is smaller
 		template<typename Iterator>
-		[[nodiscard]] std::vector<daw::view<Iterator>>
+		[[nodiscard]] constexpr range_partition<Iterator>
 		operator( )( Iterator first, Iterator last, size_t const max_parts ) const {
-
-			return daw::algorithm::partition_range<MinRangeSize>( first, last, max_parts );
+			auto const item_count = static_cast<size_t>( std::distance( first, last ) );
+			auto const count =
+			  std::max<size_t>( 1, std::min( max_parts, item_count / MinRangeSize ) );
+			return range_partition<Iterator>( DAW_MOVE( first ), item_count, count );
 		}
 
 		template<typename Iterator>
-		[[nodiscard]] std::vector<daw::view<Iterator>> operator( )( daw::view<Iterator> rng,
-		                                                            size_t const max_parts ) const {
+		[[nodiscard]] constexpr range_partition<Iterator>
+		operator( )( daw::view<Iterator> rng, size_t const max_parts ) const {
 			return operator( )( rng.begin( ), rng.end( ), max_parts );
 		}
 	};
 
-	template<typename RandomIterator, typename Func>
+	/// Splits like split_range_t, but places the part boundaries on Alignment
+	/// byte boundaries of the items written, when they are contiguous in
+	/// memory.  Tasks writing neighbouring parts then never share a cache line,
+	/// or a page with an Alignment of 4096
+	template<size_t MinRangeSize = 1, size_t Alignment = cache_line_size>
+	struct [[nodiscard]] aligned_split_range_t {
+		static_assert( MinRangeSize != 0, "Minimum range size must be > 0" );
+		static_assert( Alignment != 0 and ( Alignment & ( Alignment - 1 ) ) == 0,
+		               "Alignment must be a power of 2" );
+		static constexpr size_t min_range_size = MinRangeSize;
+
+		/// aligned_to is the first of the item_count items written, such as the
+		/// output of a transform
+		template<typename Iterator, typename AlignIterator>
+		[[nodiscard]] range_partition<Iterator> operator( )( Iterator first,
+		                                                     Iterator last,
+		                                                     size_t const max_parts,
+		                                                     AlignIterator aligned_to ) const {
+			auto const item_count = static_cast<size_t>( std::distance( first, last ) );
+			auto const count =
+			  std::max<size_t>( 1, std::min( max_parts, item_count / MinRangeSize ) );
+			if constexpr( std::contiguous_iterator<AlignIterator> ) {
+				constexpr size_t item_size = sizeof( std::iter_value_t<AlignIterator> );
+				if constexpr( item_size < Alignment and Alignment % item_size == 0 ) {
+					auto const address =
+					  reinterpret_cast<std::uintptr_t>( std::to_address( aligned_to ) );
+					if( address % item_size == 0 ) {
+						auto const lead = ( ( Alignment - address % Alignment ) % Alignment ) / item_size;
+						return range_partition<Iterator>(
+						  DAW_MOVE( first ), item_count, count, lead, Alignment / item_size );
+					}
+				}
+			}
+			return range_partition<Iterator>( DAW_MOVE( first ), item_count, count );
+		}
+
+		template<typename Iterator>
+		[[nodiscard]] range_partition<Iterator>
+		operator( )( Iterator first, Iterator last, size_t const max_parts ) const {
+			return operator( )( first, last, max_parts, first );
+		}
+
+		template<typename Iterator, typename AlignIterator>
+		[[nodiscard]] range_partition<Iterator> operator( )( daw::view<Iterator> rng,
+		                                                     size_t const max_parts,
+		                                                     AlignIterator aligned_to ) const {
+			return operator( )( rng.begin( ), rng.end( ), max_parts, DAW_MOVE( aligned_to ) );
+		}
+
+		template<typename Iterator>
+		[[nodiscard]] range_partition<Iterator> operator( )( daw::view<Iterator> rng,
+		                                                     size_t const max_parts ) const {
+			return operator( )( rng.begin( ), rng.end( ), max_parts, rng.begin( ) );
+		}
+	};
+
+	/// Partition range for writes to the items starting at out, aligning the
+	/// parts to them when the policy supports it
+	template<typename PartitionPolicy, typename Iterator, typename OutputIterator>
+	[[nodiscard]] auto
+	partition_for_output( daw::view<Iterator> range, size_t const max_parts, OutputIterator out ) {
+		if constexpr( std::is_invocable_v<PartitionPolicy const &,
+		                                  daw::view<Iterator>,
+		                                  size_t,
+		                                  OutputIterator> ) {
+			return PartitionPolicy{ }( range, max_parts, DAW_MOVE( out ) );
+		} else {
+			return PartitionPolicy{ }( range, max_parts );
+		}
+	}
+
+	/// Ranges is a range_partition, or anything else indexable with a size
+	/// such as a vector of views
+	template<typename Ranges, typename Func>
 	[[nodiscard]] daw::shared_cnt_sem
-	partition_range( std::vector<daw::view<RandomIterator>> ranges, Func &&func, task_scheduler ts ) {
-		auto sem = daw::shared_cnt_sem( ranges.size( ) );
-		for( auto rng : ranges ) {
+	partition_range( Ranges const &ranges, Func &&func, task_scheduler ts ) {
+		// Each task adds itself to sem, the initial count is released once they
+		// are all scheduled
+		auto sem = daw::shared_cnt_sem( 1 );
+		auto const ae = on_scope_exit( [sem]( ) mutable { sem.notify( ); } );
+		for( size_t n = 0; n < ranges.size( ); ++n ) {
 			if( not schedule_task(
 			      sem,
-			      [func = daw::mutable_capture( func ), rng = DAW_MOVE( rng )] { ( *func )( rng ); },
+			      [func = daw::mutable_capture( func ), rng = ranges[n]] { ( *func )( rng ); },
 			      ts ) ) {
 
 				throw daw::unable_to_add_task_exception{ };
@@ -73,9 +280,9 @@ namespace daw::algorithm::parallel::impl {
 		return sem;
 	}
 
-	template<typename RandomIterator, typename Func>
+	template<typename Ranges, typename Func>
 	[[nodiscard]] daw::shared_cnt_sem
-	partition_range_pos( std::vector<daw::view<RandomIterator>> ranges,
+	partition_range_pos( Ranges const &ranges,
 	                     Func func,
 	                     task_scheduler ts,
 	                     size_t const start_pos = 0 ) noexcept {
@@ -106,10 +313,10 @@ namespace daw::algorithm::parallel::impl {
 		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
 		auto sem = daw::shared_cnt_sem( 1 );
 		auto const ae = on_scope_exit( [sem]( ) mutable { sem.notify( ); } );
-		for( auto rng : ranges ) {
+		for( size_t n = 0; n < ranges.size( ); ++n ) {
 			if( not schedule_task(
 			      sem,
-			      [func = daw::mutable_capture( DAW_FWD( func ) ), rng]( ) {
+			      [func = daw::mutable_capture( DAW_FWD( func ) ), rng = ranges[n]]( ) {
 				      func.move_out( )( rng.begin( ), rng.end( ) );
 			      },
 			      ts ) ) {
@@ -121,7 +328,127 @@ namespace daw::algorithm::parallel::impl {
 		return sem;
 	}
 
-	template<typename PartitionPolicy = split_range_t<>, typename RandomIterator, typename Func>
+	/// Items that can be written a cache line at a time as bytes
+	template<typename T>
+	inline constexpr bool is_streamable_v = simd::has_stream_stores and
+	                                        std::is_trivially_copyable_v<T> and
+	                                        cache_line_size % sizeof( T ) == 0;
+
+	/// Whether to write count items at Iterator with stream_store
+	template<typename Iterator>
+	[[nodiscard]] bool use_stream_stores( store_policy policy, size_t count ) {
+		using value_t = std::iter_value_t<Iterator>;
+		if constexpr( std::contiguous_iterator<Iterator> and is_streamable_v<value_t> ) {
+			switch( policy ) {
+			case store_policy::streaming:
+				return true;
+			case store_policy::cached:
+				return false;
+			default:
+				return count * sizeof( value_t ) >= streaming_threshold( );
+			}
+		} else {
+			(void)policy;
+			(void)count;
+			return false;
+		}
+	}
+
+	/// Write count items to out, which may be uninitialized, bypassing the
+	/// cache.  The items in the partial cache lines at either end are written
+	/// one at a time as item( n ), the whole lines between with
+	/// lines( dst, n, line_count ), starting at item n, using simd::stream_lines
+	template<typename T, typename Item, typename Lines>
+	void stream_store( T *out, size_t count, Item item, Lines lines ) {
+		constexpr size_t per_line = cache_line_size / sizeof( T );
+		auto const write = [&]( size_t n ) {
+			T const value = item( n );
+			std::memcpy( static_cast<void *>( out + n ), &value, sizeof( T ) );
+		};
+		auto const misalign = reinterpret_cast<std::uintptr_t>( out ) % cache_line_size;
+		if( misalign % sizeof( T ) != 0 ) {
+			// No item starts a cache line
+			for( size_t n = 0; n < count; ++n ) {
+				write( n );
+			}
+			return;
+		}
+		auto const head =
+		  misalign == 0 ? size_t{ 0 } : std::min( count, ( cache_line_size - misalign ) / sizeof( T ) );
+		for( size_t n = 0; n < head; ++n ) {
+			write( n );
+		}
+		auto const whole = ( count - head ) / per_line;
+		if( whole > 0 ) {
+			lines( out + head, head, whole );
+		}
+		for( size_t n = head + whole * per_line; n < count; ++n ) {
+			write( n );
+		}
+		simd::stream_fence( );
+	}
+
+	/// Write count copies of value to out bypassing the cache
+	template<typename T>
+	void stream_fill( T *out, size_t count, T const &value ) {
+		alignas( cache_line_size ) std::byte line[cache_line_size];
+		for( size_t n = 0; n < cache_line_size; n += sizeof( T ) ) {
+			std::memcpy( line + n, &value, sizeof( T ) );
+		}
+		stream_store(
+		  out,
+		  count,
+		  [&value]( size_t ) { return value; },
+		  [&line]( T *dst, size_t, size_t line_count ) {
+			  simd::stream_lines( dst, line, line_count, 0 );
+		  } );
+	}
+
+	/// Copy the count items at first to out bypassing the cache
+	template<typename T>
+	void stream_copy( T const *first, size_t count, T *out ) {
+		stream_store(
+		  out,
+		  count,
+		  [first]( size_t n ) { return first[n]; },
+		  [first]( T *dst, size_t n, size_t line_count ) {
+			  simd::stream_lines( dst, first + n, line_count, cache_line_size );
+		  } );
+	}
+
+	/// Write item( n ) for each n in [0, count) to out bypassing the cache.  The
+	/// items are gathered a few lines at a time and streamed from there
+	template<typename T, typename Item>
+	void stream_generate( size_t count, T *out, Item item ) {
+		stream_store( out, count, item, [&]( T *dst, size_t n, size_t line_count ) {
+			constexpr size_t buffer_lines = 4;
+			constexpr size_t per_line = cache_line_size / sizeof( T );
+			alignas( cache_line_size ) std::byte buffer[buffer_lines * cache_line_size];
+			while( line_count > 0 ) {
+				auto const lines = std::min( line_count, buffer_lines );
+				for( size_t m = 0; m < lines * per_line; ++m ) {
+					T const value = item( n + m );
+					std::memcpy( buffer + m * sizeof( T ), &value, sizeof( T ) );
+				}
+				simd::stream_lines( dst, buffer, lines, cache_line_size );
+				dst += lines * per_line;
+				n += lines * per_line;
+				line_count -= lines;
+			}
+		} );
+	}
+
+	/// Write unary_op of the count items at first to out bypassing the cache
+	template<typename T, typename Iterator, typename UnaryOperation>
+	void stream_map( Iterator first, size_t count, T *out, UnaryOperation &unary_op ) {
+		stream_generate( count, out, [&]( size_t n ) -> T {
+			return unary_op( *std::next( first, static_cast<std::ptrdiff_t>( n ) ) );
+		} );
+	}
+
+	template<typename PartitionPolicy = aligned_split_range_t<>,
+	         typename RandomIterator,
+	         typename Func>
 	void parallel_for_each( daw::view<RandomIterator> rng, Func &&func, task_scheduler ts ) {
 
 		static_assert( std::is_invocable_v<Func, decltype( rng.front( ) )> );
@@ -155,8 +482,6 @@ namespace daw::algorithm::parallel::impl {
 	                              Func func,
 	                              task_scheduler ts ) {
 		auto const ranges = PartitionPolicy{ }( first, last, ts.size( ) );
-		auto sem = daw::shared_cnt_sem( ranges.size( ) );
-		Unused( sem );
 		partition_range(
 		  ranges,
 		  [func, first]( auto rng ) {
@@ -220,26 +545,38 @@ namespace daw::algorithm::parallel::impl {
 			srt( range.begin( ), range.end( ), cmp );
 			return;
 		}
-		auto ranges = PartitionPolicy( )( range, ts.size( ) );
-
-		auto sorters = std::vector<future_result_t<daw::view<Iterator>>>( );
-		sorters.reserve( ranges.size( ) );
-
-		auto const sort_fn = [cmp = mutable_capture( cmp ),
-		                      srt = mutable_capture( DAW_FWD( srt ) )]( daw::view<Iterator> r ) {
-			( *srt )( r.begin( ), r.end( ), *cmp );
-			return r;
-		};
+		auto const ranges = PartitionPolicy( )( range, ts.size( ) );
 
-		daw::algorithm::transform(
-		  ranges.begin( ),
-		  ranges.end( ),
-		  std::back_inserter( sorters ),
-		  [ts = daw::mutable_capture( ts ), sort_fn]( daw::view<Iterator> rng ) {
-			  return make_future_result( *ts, sort_fn, rng );
-		  } );
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [&srt, &cmp]( daw::view<Iterator> r, size_t ) { srt( r.begin( ), r.end( ), cmp ); },
+		  ts ) );
 
-		ts.wait_for( reduce_futures( sorters.begin( ), sorters.end( ), parallel_sort_merger{ cmp } ) );
+		// Merge neighbouring sorted runs in rounds, each round halving their
+		// number.  The tasks of a round never wait on each other, so no worker
+		// blocks inside a task
+		auto const merger = parallel_sort_merger{ cmp };
+		for( size_t width = 1; width < ranges.size( ); width *= 2 ) {
+			auto sem = daw::shared_cnt_sem( 1 );
+			{
+				auto const ae = on_scope_exit( [sem]( ) mutable { sem.notify( ); } );
+				for( size_t part = 0; part + width < ranges.size( ); part += 2 * width ) {
+					auto const left = daw::view<Iterator>( ranges[part].begin( ),
+					                                       ranges[part + width].begin( ) );
+					auto const right = daw::view<Iterator>(
+					  ranges[part + width].begin( ),
+					  ranges[std::min( part + 2 * width, ranges.size( ) ) - 1].end( ) );
+					auto const task = [&merger, left, right] {
+						(void)merger( left, right );
+					};
+					if( not schedule_task( sem, task, ts ) ) {
+						// The other tasks refer to this frame, so do the work here
+						task( );
+					}
+				}
+			}
+			ts.wait_for( sem );
+		}
 	}
 
 	template<typename PartitionPolicy = split_range_t<>,
@@ -258,19 +595,25 @@ namespace daw::algorithm::parallel::impl {
 			}
 		}
 		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
-		auto results = std::vector<std::optional<T>>( ranges.size( ) );
+		auto scratch = scratch_scope( );
+		auto results = scratch.make_vector<padded_slot<std::optional<T>>>( ranges.size( ) );
 		auto sem = partition_range_pos(
 		  ranges,
 		  [&results, binary_op]( daw::view<Iterator> rng, size_t n ) {
-			  results[n] =
-			    std::accumulate( std::next( rng.cbegin( ) ), rng.cend( ), rng.front( ), binary_op );
+			  if constexpr( simd::is_contiguous_v<Iterator> and
+			                simd::is_vector_sum_v<simd::value_t<Iterator>, T, BinaryOp> ) {
+				  results[n].value = simd::sum( std::to_address( rng.begin( ) ), rng.size( ) );
+			  } else {
+				  results[n].value =
+				    std::accumulate( std::next( rng.cbegin( ) ), rng.cend( ), rng.front( ), binary_op );
+			  }
 		  },
 		  ts );
 		ts.wait_for( sem );
 		// At this point we know that all results optional have values
 		auto result = static_cast<result_t>( init );
 		for( size_t n = 0; n < ranges.size( ); ++n ) {
-			result = binary_op( result, *results[n] );
+			result = binary_op( result, *results[n].value );
 		}
 		return result;
 	}
@@ -282,22 +625,32 @@ namespace daw::algorithm::parallel::impl {
 			return range.end( );
 		}
 		struct min_element_worker {
-			std::vector<Iterator> &r;
+			std::pmr::vector<padded_slot<Iterator>> &r;
 			Compare c;
 
 			inline void operator( )( daw::view<Iterator> rng, size_t n ) const {
-				r[n] = std::min_element( rng.cbegin( ), rng.cend( ), c );
+				if constexpr( simd::is_vector_min_max_v<Iterator, Compare> ) {
+					r[n].value = simd::to_iterator(
+					  rng.begin( ),
+					  simd::extreme_element<false>( std::to_address( rng.begin( ) ), rng.size( ) ) );
+				} else {
+					r[n].value = std::min_element( rng.cbegin( ), rng.cend( ), c );
+				}
 			}
 		};
 		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
-		auto results = std::vector<Iterator>( ranges.size( ), range.end( ) );
+		auto scratch = scratch_scope( );
+		auto results =
+		  scratch.make_vector( ranges.size( ), padded_slot<Iterator>{ range.end( ) } );
 		auto sem = partition_range_pos( ranges, min_element_worker{ results, cmp }, ts );
 		ts.wait_for( sem );
 
-		return *std::min_element(
-		  results.cbegin( ),
-		  results.cend( ),
-		  [cmp]( auto const &lhs, auto const &rhs ) { return cmp( *lhs, *rhs ); } );
+		return std::min_element( results.cbegin( ),
+		                         results.cend( ),
+		                         [cmp]( auto const &lhs, auto const &rhs ) {
+			                         return cmp( *lhs.value, *rhs.value );
+		                         } )
+		  ->value;
 	}
 
 	template<typename PartitionPolicy = split_range_t<>, typename Iterator, typename Compare>
@@ -306,46 +659,185 @@ namespace daw::algorithm::parallel::impl {
 		if( range.empty( ) ) {
 			return range.end( );
 		}
+		struct max_element_worker {
+			std::pmr::vector<padded_slot<Iterator>> &r;
+			Compare c;
+
+			inline void operator( )( daw::view<Iterator> rng, size_t n ) const {
+				if constexpr( simd::is_vector_min_max_v<Iterator, Compare> ) {
+					r[n].value = simd::to_iterator(
+					  rng.begin( ),
+					  simd::extreme_element<true>( std::to_address( rng.begin( ) ), rng.size( ) ) );
+				} else {
+					r[n].value = std::max_element( rng.cbegin( ), rng.cend( ), c );
+				}
+			}
+		};
 		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
-		std::vector<Iterator> results( ranges.size( ), range.end( ) );
-		auto sem = partition_range_pos(
-		  ranges,
-		  [&results, cmp]( daw::view<Iterator> rng, size_t n ) {
-			  results[n] =
-			    std::max_element( rng.cbegin( ), rng.cend( ), [cmp]( auto const &lhs, auto const &rhs ) {
-				    return cmp( lhs, rhs );
-			    } );
-		  },
-		  ts );
+		auto scratch = scratch_scope( );
+		auto results =
+		  scratch.make_vector( ranges.size( ), padded_slot<Iterator>{ range.end( ) } );
+		auto sem = partition_range_pos( ranges, max_element_worker{ results, cmp }, ts );
 		ts.wait_for( sem );
-		return *std::max_element(
-		  results.cbegin( ),
-		  results.cend( ),
-		  [cmp]( auto const &lhs, auto const &rhs ) { return cmp( *lhs, *rhs ); } );
+
+		return std::max_element( results.cbegin( ),
+		                         results.cend( ),
+		                         [cmp]( auto const &lhs, auto const &rhs ) {
+			                         return cmp( *lhs.value, *rhs.value );
+		                         } )
+		  ->value;
 	}
 
-	template<typename PartitionPolicy = split_range_t<>,
+	/// The smallest and largest items in one pass.  As std::minmax_element, the
+	/// first of the smallest and the last of the largest
+	template<typename PartitionPolicy = split_range_t<>, typename Iterator, typename Compare>
+	[[nodiscard]] std::pair<Iterator, Iterator>
+	parallel_minmax_element( daw::view<Iterator> range, Compare cmp, task_scheduler ts ) {
+		if( range.empty( ) ) {
+			return { range.end( ), range.end( ) };
+		}
+		using result_t = std::pair<Iterator, Iterator>;
+		struct minmax_element_worker {
+			std::pmr::vector<padded_slot<result_t>> &r;
+			Compare c;
+
+			inline void operator( )( daw::view<Iterator> rng, size_t n ) const {
+				r[n].value = std::minmax_element( rng.begin( ), rng.end( ), c );
+			}
+		};
+		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
+		auto scratch = scratch_scope( );
+		auto results = scratch.make_vector(
+		  ranges.size( ), padded_slot<result_t>{ result_t( range.end( ), range.end( ) ) } );
+		auto sem = partition_range_pos( ranges, minmax_element_worker{ results, cmp }, ts );
+		ts.wait_for( sem );
+
+		auto result = results.front( ).value;
+		for( size_t n = 1; n < results.size( ); ++n ) {
+			auto const &part = results[n].value;
+			if( cmp( *part.first, *result.first ) ) {
+				result.first = part.first;
+			}
+			if( not cmp( *part.second, *result.second ) ) {
+				result.second = part.second;
+			}
+		}
+		return result;
+	}
+
+	/// Compute the result of each aggregator over the range in one pass.  Each
+	/// task adds its items to a state per aggregator, and the states are merged
+	/// in part order
+	template<typename PartitionPolicy = split_range_t<>, typename Iterator, typename... Aggregators>
+	[[nodiscard]] auto
+	parallel_aggregate( daw::view<Iterator> range, task_scheduler ts, Aggregators... aggs ) {
+		using value_t = daw::remove_cvref_t<decltype( *range.begin( ) )>;
+		using state_t = std::tuple<decltype( aggs.template state<value_t>( ) )...>;
+		auto const init = state_t( aggs.template state<value_t>( )... );
+		auto const aggregators = std::tuple<Aggregators...>( aggs... );
+
+		auto const result = [&]( state_t const &states ) {
+			return std::apply(
+			  [&]( auto const &...a ) {
+				  return std::apply(
+				    [&]( auto const &...s ) { return std::tuple( a.result( s )... ); }, states );
+			  },
+			  aggregators );
+		};
+		auto const add_range = [&aggregators]( state_t &states, daw::view<Iterator> rng ) {
+			std::apply(
+			  [&]( auto &...s ) {
+				  std::apply(
+				    [&]( auto const &...a ) {
+					    for( auto const &item : rng ) {
+						    ( a.add( s, item ), ... );
+					    }
+				    },
+				    aggregators );
+			  },
+			  states );
+		};
+		if( PartitionPolicy::min_range_size > range.size( ) ) {
+			auto states = init;
+			add_range( states, range );
+			return result( states );
+		}
+		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
+		auto scratch = scratch_scope( );
+		auto results = scratch.make_vector( ranges.size( ), padded_slot<state_t>{ init } );
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [&]( daw::view<Iterator> rng, size_t n ) { add_range( results[n].value, rng ); },
+		  ts ) );
+
+		auto states = DAW_MOVE( results.front( ).value );
+		for( size_t n = 1; n < results.size( ); ++n ) {
+			[&]<size_t... Is>( std::index_sequence<Is...> ) {
+				( std::get<Is>( aggregators )
+				    .merge( std::get<Is>( states ), std::get<Is>( results[n].value ) ),
+				  ... );
+			}( std::index_sequence_for<Aggregators...>{ } );
+		}
+		return result( states );
+	}
+
+	template<typename PartitionPolicy = aligned_split_range_t<>,
 	         typename Iterator,
 	         typename OutputIterator,
 	         typename UnaryOperation>
 	void parallel_map( daw::view<Iterator> range_in,
 	                   OutputIterator first_out,
 	                   UnaryOperation unary_op,
-	                   task_scheduler ts ) {
+	                   task_scheduler ts,
+	                   store_policy policy = store_policy::automatic ) {
 
-		partition_range<PartitionPolicy>(
-		  range_in,
-		  [first_in = range_in.begin( ), first_out, unary_op]( Iterator first, Iterator last ) {
-			  auto const step = std::distance( first_in, first );
+		auto const ranges = partition_for_output<PartitionPolicy>( range_in, ts.size( ), first_out );
+		bool const stream = use_stream_stores<OutputIterator>( policy, range_in.size( ) );
+		partition_range(
+		  ranges,
+		  [first_in = range_in.begin( ), first_out, unary_op, stream](
+		    daw::view<Iterator> rng ) mutable {
+			  auto const step = std::distance( first_in, rng.begin( ) );
 			  daw::exception::dbg_precondition_check( step >= 0 );
 
-			  daw::algorithm::map( first, last, std::next( first_out, step ), unary_op );
+			  if constexpr( std::contiguous_iterator<OutputIterator> and
+			                is_streamable_v<std::iter_value_t<OutputIterator>> ) {
+				  if( stream ) {
+					  stream_map(
+					    rng.begin( ), rng.size( ), std::to_address( first_out ) + step, unary_op );
+					  return;
+				  }
+			  }
+			  daw::algorithm::map( rng.begin( ), rng.end( ), std::next( first_out, step ), unary_op );
 		  },
 		  ts )
 		  .wait( );
 	}
 
-	template<typename PartitionPolicy = split_range_t<>,
+	template<typename PartitionPolicy = aligned_split_range_t<>, typename Iterator, typename T>
+	void parallel_fill( daw::view<Iterator> range,
+	                    T const &value,
+	                    store_policy policy,
+	                    task_scheduler ts ) {
+		auto const ranges = partition_for_output<PartitionPolicy>( range, ts.size( ), range.begin( ) );
+		bool const stream = use_stream_stores<Iterator>( policy, range.size( ) );
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [&value, stream]( daw::view<Iterator> rng, size_t ) {
+			  using value_t = std::iter_value_t<Iterator>;
+			  if constexpr( std::contiguous_iterator<Iterator> and is_streamable_v<value_t> and
+			                std::is_constructible_v<value_t, T const &> ) {
+				  if( stream ) {
+					  stream_fill( std::to_address( rng.begin( ) ), rng.size( ), value_t( value ) );
+					  return;
+				  }
+			  }
+			  std::fill( rng.begin( ), rng.end( ), value );
+		  },
+		  ts ) );
+	}
+
+	template<typename PartitionPolicy = aligned_split_range_t<>,
 	         typename Iterator1,
 	         typename Iterator2,
 	         typename OutputIterator,
@@ -356,17 +848,17 @@ namespace daw::algorithm::parallel::impl {
 	                   BinaryOperation binary_op,
 	                   task_scheduler ts ) {
 
-		partition_range<PartitionPolicy>(
-		  range_in1,
+		auto const ranges = partition_for_output<PartitionPolicy>( range_in1, ts.size( ), first_out );
+		partition_range(
+		  ranges,
 		  [first_in1 = range_in1.begin( ), first_out, first_in2 = range_in2.begin( ), binary_op](
-		    Iterator1 first1,
-		    Iterator1 last1 ) {
-			  auto const step = std::distance( first_in1, first1 );
+		    daw::view<Iterator1> rng1 ) {
+			  auto const step = std::distance( first_in1, rng1.begin( ) );
 			  daw::exception::dbg_precondition_check( step >= 0 );
 			  auto out_it = std::next( first_out, step );
 			  auto in_it2 = std::next( first_in2, step );
 
-			  daw::algorithm::map( first1, last1, in_it2, out_it, binary_op );
+			  daw::algorithm::map( rng1.begin( ), rng1.end( ), in_it2, out_it, binary_op );
 		  },
 		  ts )
 		  .wait( );
@@ -390,7 +882,8 @@ namespace daw::algorithm::parallel::impl {
 		                                                 map_function( range.front( ) ) ) )>;
 
 		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
-		auto results = std::vector<std::optional<result_t>>( ranges.size( ) );
+		auto scratch = scratch_scope( );
+		auto results = scratch.make_vector<padded_slot<std::optional<result_t>>>( ranges.size( ) );
 
 		auto sem = partition_range_pos(
 		  ranges,
@@ -399,19 +892,19 @@ namespace daw::algorithm::parallel::impl {
 			  while( not rng.empty( ) ) {
 				  result = reduce_function( result, map_function( rng.pop_front( ) ) );
 			  }
-			  results[n] = DAW_MOVE( result );
+			  results[n].value = DAW_MOVE( result );
 		  },
 		  ts );
 
 		ts.wait_for( sem );
-		auto result = reduce_function( map_function( init ), *results[0] );
+		auto result = reduce_function( map_function( init ), *results[0].value );
 		for( size_t n = 1; n < ranges.size( ); ++n ) {
-			result = reduce_function( result, *results[n] );
+			result = reduce_function( result, *results[n].value );
 		}
 		return result;
 	}
 
-	template<typename PartitionPolicy = split_range_t<>,
+	template<typename PartitionPolicy = aligned_split_range_t<>,
 	         typename Iterator,
 	         typename OutputIterator,
 	         typename BinaryOp>
@@ -430,17 +923,20 @@ namespace daw::algorithm::parallel::impl {
 		using value_t =
 		  daw::remove_cvref_t<decltype( DAW_FWD( binary_op )( range_in.front( ), range_in.front( ) ) )>;
 
-		auto const ranges = PartitionPolicy{ }( range_in, ts.size( ) );
-		auto p1_results = std::vector<std::optional<value_t>>( ranges.size( ) );
-		auto mut_p1_results = std::vector<daw::spin_lock>( ranges.size( ) );
+		auto const ranges =
+		  partition_for_output<PartitionPolicy>( range_in, ts.size( ), range_out.begin( ) );
+		auto scratch = scratch_scope( );
+		auto p1_results = scratch.make_vector<padded_slot<std::optional<value_t>>>( ranges.size( ) );
+		auto mut_p1_results = scratch.make_vector<padded_slot<daw::spin_lock>>( ranges.size( ) );
 
 		auto const add_result = [&]( size_t pos, value_t const &value ) {
 			for( size_t n = pos + 1; n < p1_results.size( ); ++n ) {
-				std::lock_guard<daw::spin_lock> lck( mut_p1_results[n] );
-				if( p1_results[n] ) {
-					p1_results[n] = binary_op( *p1_results[n], value );
+				std::lock_guard<daw::spin_lock> lck( mut_p1_results[n].value );
+				auto &result = p1_results[n].value;
+				if( result ) {
+					result = binary_op( *result, value );
 				} else {
-					p1_results[n] = value;
+					result = value;
 				}
 			}
 		};
@@ -474,7 +970,7 @@ namespace daw::algorithm::parallel::impl {
 			  auto out_pos =
 			    std::next( range_out->begin( ), std::distance( range_in->begin( ), cur_range.begin( ) ) );
 
-			  auto sum = ( *binary_op )( *p1_results[n], cur_range.pop_front( ) );
+			  auto sum = ( *binary_op )( *p1_results[n].value, cur_range.pop_front( ) );
 
 			  *( out_pos++ ) = sum;
 			  while( not cur_range.empty( ) ) {
@@ -492,21 +988,22 @@ namespace daw::algorithm::parallel::impl {
 	parallel_find_if( daw::view<Iterator> range_in, UnaryPredicate &&pred, task_scheduler ts ) {
 
 		auto const ranges = PartitionPolicy{ }( range_in, ts.size( ) );
-		auto results = std::vector<std::optional<Iterator>>( ranges.size( ) );
+		auto scratch = scratch_scope( );
+		auto results = scratch.make_vector<padded_slot<std::optional<Iterator>>>( ranges.size( ) );
 
 		ts.wait_for( partition_range_pos(
 		  ranges,
 		  [&results, pred]( daw::view<Iterator> range, size_t pos ) {
 			  auto it = std::find_if( range.begin( ), range.end( ), pred );
 			  if( it != range.end( ) ) {
-				  results[pos] = it;
+				  results[pos].value = it;
 			  }
 		  },
 		  ts ) );
 
 		for( auto const &it : results ) {
-			if( it ) {
-				return *it;
+			if( it.value ) {
+				return *it.value;
 			}
 		}
 		return range_in.end( );
@@ -525,17 +1022,24 @@ namespace daw::algorithm::parallel::impl {
 		if( std::distance( first1, last1 ) != std::distance( first2, last2 ) ) {
 			return false;
 		}
-		auto const ranges1 = PartitionPolicy{ }( first1, last1, ts.size( ) );
-		auto const ranges2 = PartitionPolicy{ }( first2, last2, ts.size( ) );
+		auto const ranges = PartitionPolicy{ }( first1, last1, ts.size( ) );
 
 		std::atomic_char all_equal = static_cast<char>( true );
 
+		// The second range has the same size, so its parts start at the same
+		// offsets
 		ts.wait_for( partition_range_pos(
-		  ranges1,
-		  [&ranges2, pred, &all_equal]( daw::view<Iterator1> range1, size_t pos ) {
-			  auto range2 = ranges2[pos];
-			  all_equal &=
-			    std::equal( range1.cbegin( ), range1.cend( ), range2.cbegin( ), range2.cend( ), pred );
+		  ranges,
+		  [first1, first2, pred, &all_equal]( daw::view<Iterator1> range1, size_t ) {
+			  auto const range2_first = std::next( first2, std::distance( first1, range1.begin( ) ) );
+			  if constexpr( simd::is_vector_equal_v<Iterator1, Iterator2, BinaryPredicate> ) {
+				  // memcmp is vectorized, and picked for the cpu, by the C library
+				  all_equal &= std::memcmp( std::to_address( range1.begin( ) ),
+				                            std::to_address( range2_first ),
+				                            range1.size( ) * sizeof( *range1.begin( ) ) ) == 0;
+			  } else {
+				  all_equal &= std::equal( range1.cbegin( ), range1.cend( ), range2_first, pred );
+			  }
 		  },
 		  ts ) );
 		return static_cast<bool>( all_equal );
@@ -556,16 +1060,1005 @@ namespace daw::algorithm::parallel::impl {
 			return std::count_if( range_in.begin( ), range_in.end( ), pred );
 		}
 		auto const ranges = PartitionPolicy{ }( range_in, ts.size( ) );
-		std::vector<result_t> results( ranges.size( ), 0 );
+		auto scratch = scratch_scope( );
+		auto results = scratch.make_vector<padded_slot<result_t>>( ranges.size( ) );
 
 		auto sem = partition_range_pos(
 		  ranges,
 		  [&results, pred]( daw::view<RandomIterator> range, size_t n ) {
-			  results[n] = std::count_if( range.cbegin( ), range.cend( ), pred );
+			  if constexpr( simd::is_vector_count_v<RandomIterator, UnaryPredicate> ) {
+				  results[n].value = static_cast<result_t>(
+				    simd::count( std::to_address( range.begin( ) ), range.size( ), *pred.value ) );
+			  } else {
+				  results[n].value = std::count_if( range.cbegin( ), range.cend( ), pred );
+			  }
+		  },
+		  ts );
+
+		ts.wait_for( sem );
+		auto result = static_cast<result_t>( 0 );
+		for( auto const &r : results ) {
+			result += r.value;
+		}
+		return result;
+	}
+
+	/// Call func( n ) for each n in [0, count), each in a task of its own, and
+	/// wait for them
+	template<typename Func>
+	void run_indexed_tasks( size_t count, Func func, task_scheduler &ts ) {
+		auto sem = daw::shared_cnt_sem( 1 );
+		{
+			auto const ae = on_scope_exit( [sem]( ) mutable { sem.notify( ); } );
+			for( size_t n = 0; n < count; ++n ) {
+				auto const task = [&func, n] {
+					func( n );
+				};
+				if( not schedule_task( sem, task, ts ) ) {
+					// The other tasks refer to this frame, so do the work here
+					task( );
+				}
+			}
+		}
+		ts.wait_for( sem );
+	}
+
+	/// Construct the items of each part with construct( part, n ), which leaves
+	/// nothing constructed in its part when it throws.  When a part throws, the
+	/// items of the others are destroyed with destroy( part, n ) and the first
+	/// exception is rethrown, so no items are left constructed
+	template<typename Ranges, typename Construct, typename Destroy>
+	void construct_parts( Ranges const &ranges,
+	                      Construct construct,
+	                      Destroy destroy,
+	                      task_scheduler &ts ) {
+		auto scratch = scratch_scope( );
+		auto errors = scratch.make_vector<padded_slot<std::exception_ptr>>( ranges.size( ) );
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [&errors, &construct]( auto rng, size_t n ) {
+			  try {
+				  construct( rng, n );
+			  } catch( ... ) {
+				  errors[n].value = std::current_exception( );
+			  }
+		  },
+		  ts ) );
+		auto const failed = std::find_if( errors.begin( ), errors.end( ), []( auto const &e ) {
+			return static_cast<bool>( e.value );
+		} );
+		if( failed == errors.end( ) ) {
+			return;
+		}
+		run_indexed_tasks(
+		  ranges.size( ),
+		  [&]( size_t n ) {
+			  if( not errors[n].value ) {
+				  destroy( ranges[n], n );
+			  }
+		  },
+		  ts );
+		std::rethrow_exception( failed->value );
+	}
+
+	/// Count the items of each part with count( view, n ), then replace each
+	/// count with where the part's items start in the output
+	/// @returns the total count
+	template<typename Ranges, typename Count>
+	[[nodiscard]] size_t count_part_offsets( Ranges const &ranges,
+	                                         std::pmr::vector<padded_slot<size_t>> &offsets,
+	                                         Count count,
+	                                         task_scheduler &ts ) {
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [&offsets, count]( auto rng, size_t n ) { offsets[n].value = count( rng, n ); },
+		  ts ) );
+		size_t total = 0;
+		for( auto &offset : offsets ) {
+			total += std::exchange( offset.value, total );
+		}
+		return total;
+	}
+
+	/// Move the count items of buffer to first and destroy them, in parallel
+	template<typename Iterator, typename T>
+	void move_from_buffer( T *buffer, size_t count, Iterator first, task_scheduler ts ) {
+		auto const ranges = partition_for_output<aligned_split_range_t<>>(
+		  daw::view( buffer, buffer + count ), ts.size( ), first );
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [buffer, first]( daw::view<T *> rng, size_t ) {
+			  auto const ae = on_scope_exit( [rng]( ) { std::destroy( rng.begin( ), rng.end( ) ); } );
+			  std::move( rng.begin( ), rng.end( ), std::next( first, rng.begin( ) - buffer ) );
+		  },
+		  ts ) );
+	}
+
+	/// Copy the items pred is true for to first_out, keeping their order.
+	/// pred is called twice for each item, once to count and once to copy
+	template<typename PartitionPolicy = split_range_t<>,
+	         typename Iterator,
+	         typename OutputIterator,
+	         typename UnaryPredicate>
+	[[nodiscard]] OutputIterator parallel_copy_if( daw::view<Iterator> range,
+	                                               OutputIterator first_out,
+	                                               UnaryPredicate pred,
+	                                               task_scheduler ts ) {
+		if( range.empty( ) ) {
+			return first_out;
+		}
+		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
+		auto scratch = scratch_scope( );
+		auto offsets = scratch.make_vector<padded_slot<size_t>>( ranges.size( ) );
+		auto const total = count_part_offsets(
+		  ranges,
+		  offsets,
+		  [pred]( daw::view<Iterator> rng, size_t ) {
+			  return static_cast<size_t>( std::count_if( rng.begin( ), rng.end( ), pred ) );
+		  },
+		  ts );
+
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [&offsets, first_out, pred]( daw::view<Iterator> rng, size_t n ) {
+			  auto const out = std::next( first_out, static_cast<std::ptrdiff_t>( offsets[n].value ) );
+			  std::copy_if( rng.begin( ), rng.end( ), out, pred );
+		  },
+		  ts ) );
+		return std::next( first_out, static_cast<std::ptrdiff_t>( total ) );
+	}
+
+	/// The end of the items of part n in a buffer, the start of the next part
+	/// or total for the last
+	[[nodiscard]] inline size_t part_end( std::pmr::vector<padded_slot<size_t>> const &offsets,
+	                               size_t n,
+	                               size_t total ) {
+		return n + 1 < offsets.size( ) ? offsets[n + 1].value : total;
+	}
+
+	/// Remove the items pred is true for, keeping the order of the rest.  The
+	/// kept items are moved through uninitialized scratch memory
+	template<typename PartitionPolicy = split_range_t<>, typename Iterator, typename UnaryPredicate>
+	[[nodiscard]] Iterator
+	parallel_remove_if( daw::view<Iterator> range, UnaryPredicate pred, task_scheduler ts ) {
+		using value_t = daw::remove_cvref_t<decltype( *range.begin( ) )>;
+		if( range.empty( ) ) {
+			return range.begin( );
+		}
+		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
+		auto scratch = scratch_scope( );
+		auto offsets = scratch.make_vector<padded_slot<size_t>>( ranges.size( ) );
+		auto const total = count_part_offsets(
+		  ranges,
+		  offsets,
+		  [pred]( daw::view<Iterator> rng, size_t ) {
+			  return static_cast<size_t>(
+			    std::count_if( rng.begin( ), rng.end( ), [&]( auto const &item ) {
+				    return not pred( item );
+			    } ) );
+		  },
+		  ts );
+		if( total == range.size( ) ) {
+			return range.end( );
+		}
+
+		auto *const buffer = scratch.allocate<value_t>( total );
+		construct_parts(
+		  ranges,
+		  [&offsets, buffer, pred]( daw::view<Iterator> rng, size_t n ) {
+			  auto *const part_first = buffer + offsets[n].value;
+			  auto *out = part_first;
+			  try {
+				  for( auto &item : rng ) {
+					  if( not pred( item ) ) {
+						  std::construct_at( out, DAW_MOVE( item ) );
+						  ++out;
+					  }
+				  }
+			  } catch( ... ) {
+				  std::destroy( part_first, out );
+				  throw;
+			  }
+		  },
+		  [&offsets, buffer, total]( daw::view<Iterator>, size_t n ) {
+			  std::destroy( buffer + offsets[n].value, buffer + part_end( offsets, n, total ) );
+		  },
+		  ts );
+		move_from_buffer( buffer, total, range.begin( ), ts );
+		return std::next( range.begin( ), static_cast<std::ptrdiff_t>( total ) );
+	}
+
+	/// Remove all but the first of each run of items pred says are equal.
+	/// The kept items are moved through uninitialized scratch memory
+	template<typename PartitionPolicy = split_range_t<>, typename Iterator, typename BinaryPredicate>
+	[[nodiscard]] Iterator
+	parallel_unique( daw::view<Iterator> range, BinaryPredicate pred, task_scheduler ts ) {
+		using value_t = daw::remove_cvref_t<decltype( *range.begin( ) )>;
+		if( range.size( ) < 2 ) {
+			return range.end( );
+		}
+		auto const first = range.begin( );
+		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
+		auto scratch = scratch_scope( );
+		auto offsets = scratch.make_vector<padded_slot<size_t>>( ranges.size( ) );
+		// Whether the first item of each part is kept, as the item before it may
+		// be moved by the time the part is copied
+		auto first_kept = scratch.make_vector<padded_slot<bool>>( ranges.size( ) );
+		auto const total = count_part_offsets(
+		  ranges,
+		  offsets,
+		  [first, pred, &first_kept]( daw::view<Iterator> rng, size_t n ) {
+			  auto const is_kept = rng.begin( ) == first or not pred( rng.begin( )[-1], rng.front( ) );
+			  first_kept[n].value = is_kept;
+			  size_t result = is_kept ? 1 : 0;
+			  for( auto it = std::next( rng.begin( ) ); it != rng.end( ); ++it ) {
+				  if( not pred( it[-1], *it ) ) {
+					  ++result;
+				  }
+			  }
+			  return result;
+		  },
+		  ts );
+		if( total == range.size( ) ) {
+			return range.end( );
+		}
+
+		auto *const buffer = scratch.allocate<value_t>( total );
+		construct_parts(
+		  ranges,
+		  [&offsets, &first_kept, buffer, pred]( daw::view<Iterator> rng, size_t n ) {
+			  auto *const part_first = buffer + offsets[n].value;
+			  auto *out = part_first;
+			  try {
+				  // When the previous item was kept it has been moved, compare with its
+				  // copy in the buffer instead
+				  bool prev_kept = first_kept[n].value;
+				  if( prev_kept ) {
+					  std::construct_at( out, DAW_MOVE( rng.front( ) ) );
+					  ++out;
+				  }
+				  for( auto it = std::next( rng.begin( ) ); it != rng.end( ); ++it ) {
+					  auto const &prev = prev_kept ? out[-1] : it[-1];
+					  prev_kept = not pred( prev, *it );
+					  if( prev_kept ) {
+						  std::construct_at( out, DAW_MOVE( *it ) );
+						  ++out;
+					  }
+				  }
+			  } catch( ... ) {
+				  std::destroy( part_first, out );
+				  throw;
+			  }
+		  },
+		  [&offsets, buffer, total]( daw::view<Iterator>, size_t n ) {
+			  std::destroy( buffer + offsets[n].value, buffer + part_end( offsets, n, total ) );
+		  },
+		  ts );
+		move_from_buffer( buffer, total, first, ts );
+		return std::next( first, static_cast<std::ptrdiff_t>( total ) );
+	}
+
+	/// Put the items pred is true for before the rest, keeping the order
+	/// within both groups.  The items are moved through uninitialized scratch
+	/// memory
+	template<typename PartitionPolicy = split_range_t<>, typename Iterator, typename UnaryPredicate>
+	[[nodiscard]] Iterator
+	parallel_stable_partition( daw::view<Iterator> range, UnaryPredicate pred, task_scheduler ts ) {
+		using value_t = daw::remove_cvref_t<decltype( *range.begin( ) )>;
+		if( range.empty( ) ) {
+			return range.begin( );
+		}
+		auto const first = range.begin( );
+		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
+		auto scratch = scratch_scope( );
+		auto offsets = scratch.make_vector<padded_slot<size_t>>( ranges.size( ) );
+		auto const true_count = count_part_offsets(
+		  ranges,
+		  offsets,
+		  [pred]( daw::view<Iterator> rng, size_t ) {
+			  return static_cast<size_t>( std::count_if( rng.begin( ), rng.end( ), pred ) );
 		  },
 		  ts );
+		if( true_count == 0 or true_count == range.size( ) ) {
+			return std::next( first, static_cast<std::ptrdiff_t>( true_count ) );
+		}
 
+		// The items of part n pred is true for go after those of the parts before
+		// it, the rest after the true items and the rest of the parts before it
+		auto const false_offset = [&offsets, first, true_count]( daw::view<Iterator> rng, size_t n ) {
+			auto const start = static_cast<size_t>( std::distance( first, rng.begin( ) ) );
+			return true_count + start - offsets[n].value;
+		};
+		auto *const buffer = scratch.allocate<value_t>( range.size( ) );
+		construct_parts(
+		  ranges,
+		  [&offsets, &false_offset, buffer, pred]( daw::view<Iterator> rng, size_t n ) {
+			  auto *const true_first = buffer + offsets[n].value;
+			  auto *const false_first = buffer + false_offset( rng, n );
+			  auto *out_true = true_first;
+			  auto *out_false = false_first;
+			  try {
+				  for( auto &item : rng ) {
+					  if( pred( item ) ) {
+						  std::construct_at( out_true, DAW_MOVE( item ) );
+						  ++out_true;
+					  } else {
+						  std::construct_at( out_false, DAW_MOVE( item ) );
+						  ++out_false;
+					  }
+				  }
+			  } catch( ... ) {
+				  std::destroy( true_first, out_true );
+				  std::destroy( false_first, out_false );
+				  throw;
+			  }
+		  },
+		  [&offsets, &false_offset, buffer, true_count]( daw::view<Iterator> rng, size_t n ) {
+			  auto const true_size = part_end( offsets, n, true_count ) - offsets[n].value;
+			  std::destroy_n( buffer + offsets[n].value, true_size );
+			  std::destroy_n( buffer + false_offset( rng, n ), rng.size( ) - true_size );
+		  },
+		  ts );
+		move_from_buffer( buffer, range.size( ), first, ts );
+		return std::next( first, static_cast<std::ptrdiff_t>( true_count ) );
+	}
+
+	/// A run of items in a range, used to pair up the misplaced items of a
+	/// partition
+	struct misplaced_run_t {
+		// The position of the first item in the range, and of the first item in
+		// the sequence of all the misplaced items
+		size_t first;
+		size_t rank;
+	};
+
+	/// Put the items pred is true for before the rest, in place.  Each part is
+	/// partitioned on its own, then the items that are on the wrong side of
+	/// the final partition point are swapped in parallel
+	template<typename PartitionPolicy = split_range_t<>, typename Iterator, typename UnaryPredicate>
+	[[nodiscard]] Iterator
+	parallel_partition( daw::view<Iterator> range, UnaryPredicate pred, task_scheduler ts ) {
+		if( range.empty( ) ) {
+			return range.begin( );
+		}
+		auto const first = range.begin( );
+		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
+		auto scratch = scratch_scope( );
+		auto true_counts = scratch.make_vector<padded_slot<size_t>>( ranges.size( ) );
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [&true_counts, pred]( daw::view<Iterator> rng, size_t n ) {
+			  auto const mid = std::partition( rng.begin( ), rng.end( ), pred );
+			  true_counts[n].value = static_cast<size_t>( std::distance( rng.begin( ), mid ) );
+		  },
+		  ts ) );
+		size_t true_count = 0;
+		for( auto const &c : true_counts ) {
+			true_count += c.value;
+		}
+
+		// Each part now holds a run of true items then a run of false items.
+		// The false runs before true_count and the true runs after it are
+		// misplaced, and there are as many misplaced items of each
+		auto false_runs = scratch.reserve_vector<misplaced_run_t>( ranges.size( ) + 1 );
+		auto true_runs = scratch.reserve_vector<misplaced_run_t>( ranges.size( ) + 1 );
+		size_t false_rank = 0;
+		size_t true_rank = 0;
+		for( size_t n = 0; n < ranges.size( ); ++n ) {
+			auto const start = static_cast<size_t>( std::distance( first, ranges[n].begin( ) ) );
+			auto const mid = start + true_counts[n].value;
+			auto const last = start + ranges[n].size( );
+			if( mid < true_count and mid < last ) {
+				false_runs.push_back( misplaced_run_t{ mid, false_rank } );
+				false_rank += std::min( last, true_count ) - mid;
+			}
+			auto const true_first = std::max( start, true_count );
+			if( true_first < mid ) {
+				true_runs.push_back( misplaced_run_t{ true_first, true_rank } );
+				true_rank += mid - true_first;
+			}
+		}
+		assert( false_rank == true_rank );
+		if( false_rank == 0 ) {
+			return std::next( first, static_cast<std::ptrdiff_t>( true_count ) );
+		}
+		// Sentinels holding the end of the last run
+		false_runs.push_back( misplaced_run_t{ true_count, false_rank } );
+		true_runs.push_back( misplaced_run_t{ range.size( ), true_rank } );
+
+		// Where the item of a rank is, and how many items are left in its run
+		auto const locate = []( auto const &runs, size_t rank ) {
+			auto const run = std::prev( std::upper_bound(
+			  runs.begin( ), runs.end( ), rank, []( size_t r, misplaced_run_t const &mr ) {
+				  return r < mr.rank;
+			  } ) );
+			return std::pair<size_t, size_t>( run->first + ( rank - run->rank ),
+			                                  std::next( run )->rank - rank );
+		};
+		auto const swap_items = [&]( size_t rank, size_t const last_rank ) {
+			auto [false_pos, false_left] = locate( false_runs, rank );
+			auto [true_pos, true_left] = locate( true_runs, rank );
+			while( rank < last_rank ) {
+				auto const count = std::min( { false_left, true_left, last_rank - rank } );
+				std::swap_ranges( std::next( first, static_cast<std::ptrdiff_t>( false_pos ) ),
+				                  std::next( first, static_cast<std::ptrdiff_t>( false_pos + count ) ),
+				                  std::next( first, static_cast<std::ptrdiff_t>( true_pos ) ) );
+				rank += count;
+				if( rank < last_rank ) {
+					std::tie( false_pos, false_left ) = locate( false_runs, rank );
+					std::tie( true_pos, true_left ) = locate( true_runs, rank );
+				}
+			}
+		};
+		auto const task_count = std::min( ts.size( ), false_rank );
+		auto sem = daw::shared_cnt_sem( 1 );
+		{
+			auto const ae = on_scope_exit( [sem]( ) mutable { sem.notify( ); } );
+			for( size_t n = 0; n < task_count; ++n ) {
+				auto const first_rank = false_rank * n / task_count;
+				auto const last_rank = false_rank * ( n + 1 ) / task_count;
+				auto task = [&swap_items, first_rank, last_rank] {
+					swap_items( first_rank, last_rank );
+				};
+				if( not schedule_task( sem, task, ts ) ) {
+					// The other tasks refer to this frame, so do the work here
+					task( );
+				}
+			}
+		}
 		ts.wait_for( sem );
-		return std::accumulate( results.cbegin( ), results.cend( ), static_cast<result_t>( 0 ) );
+		return std::next( first, static_cast<std::ptrdiff_t>( true_count ) );
+	}
+
+	/// Below this many items nth_element is done sequentially
+	inline constexpr size_t sequential_select_size = 32'768;
+
+	/// Put the item that belongs at nth in the order of cmp there, with no
+	/// item after it ordered before it and none before it ordered after.
+	/// Each round sorts a sample of the range, takes two pivots from it around
+	/// nth's place and partitions the range in parallel, keeping the part
+	/// that holds nth.  The pivots are close, so the part is small and the
+	/// total work is linear
+	template<typename Iterator, typename Compare>
+	void parallel_nth_element( daw::view<Iterator> range,
+	                           Iterator nth,
+	                           Compare cmp,
+	                           task_scheduler ts ) {
+		using value_t = daw::remove_cvref_t<decltype( *nth )>;
+		constexpr size_t sample_size = 1'024;
+		// Either side of nth's place in the sample, about twice the deviation
+		// of its rank
+		constexpr size_t band = 32;
+
+		auto first = range.begin( );
+		auto last = range.end( );
+		if( nth == last ) {
+			return;
+		}
+		auto sample = std::vector<value_t>( );
+		sample.reserve( sample_size );
+		while( static_cast<size_t>( std::distance( first, last ) ) > sequential_select_size ) {
+			auto const size = static_cast<size_t>( std::distance( first, last ) );
+			sample.clear( );
+			for( size_t n = 0; n < sample_size; ++n ) {
+				sample.push_back( first[static_cast<std::ptrdiff_t>( n * size / sample_size )] );
+			}
+			std::sort( sample.begin( ), sample.end( ), cmp );
+			auto const rank =
+			  static_cast<size_t>( std::distance( first, nth ) ) * sample_size / size;
+			auto const lo = sample[rank > band ? rank - band : 0];
+			auto const hi = sample[std::min( rank + band, sample_size - 1 )];
+
+			auto const lo_mid = parallel_partition(
+			  daw::view( first, last ), [&]( auto const &item ) { return cmp( item, lo ); }, ts );
+			auto const hi_mid = parallel_partition(
+			  daw::view( lo_mid, last ), [&]( auto const &item ) { return not cmp( hi, item ); }, ts );
+
+			auto next_first = hi_mid;
+			auto next_last = last;
+			if( nth < lo_mid ) {
+				next_first = first;
+				next_last = lo_mid;
+			} else if( nth < hi_mid ) {
+				next_first = lo_mid;
+				next_last = hi_mid;
+			}
+			if( next_first == first and next_last == last ) {
+				// Every item is between the pivots
+				break;
+			}
+			first = next_first;
+			last = next_last;
+		}
+		std::nth_element( first, nth, last, cmp );
+	}
+
+	/// Sort the items that belong in [first, middle) in the order of cmp
+	/// there, the rest are left in an unspecified order
+	template<typename Iterator, typename Compare>
+	void parallel_partial_sort( daw::view<Iterator> range,
+	                            Iterator middle,
+	                            Compare cmp,
+	                            task_scheduler ts ) {
+		if( middle == range.begin( ) ) {
+			return;
+		}
+		parallel_nth_element( range, std::prev( middle ), cmp, ts );
+		parallel_sort( daw::view( range.begin( ), middle ), sorter, cmp, ts );
+	}
+
+	/// The k items that come first in the order of cmp, in that order.  Each
+	/// task keeps the best k of its part in a heap and the heaps are merged
+	template<typename PartitionPolicy = split_range_t<>, typename Iterator, typename Compare>
+	[[nodiscard]] auto
+	parallel_top_k( daw::view<Iterator> range, size_t k, Compare cmp, task_scheduler ts ) {
+		using value_t = daw::remove_cvref_t<decltype( *range.begin( ) )>;
+		auto result = std::vector<value_t>( );
+		k = std::min( k, range.size( ) );
+		if( k == 0 ) {
+			return result;
+		}
+		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
+		auto scratch = scratch_scope( );
+		auto heaps = scratch.make_vector<padded_slot<std::vector<value_t>>>( ranges.size( ) );
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [&heaps, k, cmp]( daw::view<Iterator> rng, size_t n ) {
+			  // The front of the heap is the last of the best k in cmp order
+			  auto &heap = heaps[n].value;
+			  heap.reserve( std::min( k, rng.size( ) ) );
+			  for( auto const &item : rng ) {
+				  if( heap.size( ) < k ) {
+					  heap.push_back( item );
+					  std::push_heap( heap.begin( ), heap.end( ), cmp );
+				  } else if( cmp( item, heap.front( ) ) ) {
+					  std::pop_heap( heap.begin( ), heap.end( ), cmp );
+					  heap.back( ) = item;
+					  std::push_heap( heap.begin( ), heap.end( ), cmp );
+				  }
+			  }
+		  },
+		  ts ) );
+
+		size_t total = 0;
+		for( auto const &heap : heaps ) {
+			total += heap.value.size( );
+		}
+		result.reserve( total );
+		for( auto &heap : heaps ) {
+			std::move( heap.value.begin( ), heap.value.end( ), std::back_inserter( result ) );
+		}
+		auto const middle = std::next( result.begin( ), static_cast<std::ptrdiff_t>( k ) );
+		std::partial_sort( result.begin( ), middle, result.end( ), cmp );
+		result.erase( middle, result.end( ) );
+		return result;
+	}
+
+	/// The counts of one part for a cache line worth of buckets.  The bins of
+	/// each part are whole lines, so no two tasks count on the same line
+	inline constexpr size_t bins_per_line = cache_line_size / sizeof( size_t );
+	using bin_line_t = padded_slot<std::array<size_t, bins_per_line>>;
+
+	/// The number of items in each of bucket_count buckets, bucket( item ) must
+	/// be less than bucket_count.  Each task counts its part into bins of its
+	/// own in one pass, then the tasks each sum a slice of the buckets over
+	/// the bins of all parts
+	template<typename PartitionPolicy = split_range_t<>, typename Iterator, typename Bucket>
+	[[nodiscard]] std::vector<size_t> parallel_histogram( daw::view<Iterator> range,
+	                                                      Bucket bucket,
+	                                                      size_t bucket_count,
+	                                                      task_scheduler ts ) {
+		auto result = std::vector<size_t>( bucket_count );
+		if( range.empty( ) or bucket_count == 0 ) {
+			return result;
+		}
+		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
+		auto const line_count = ( bucket_count + bins_per_line - 1 ) / bins_per_line;
+		auto scratch = scratch_scope( );
+		auto bins = scratch.make_vector<bin_line_t>( ranges.size( ) * line_count );
+		auto const bin = [&bins, line_count]( size_t part, size_t b ) -> size_t & {
+			return bins[part * line_count + b / bins_per_line].value[b % bins_per_line];
+		};
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [bin, bucket, bucket_count]( daw::view<Iterator> rng, size_t n ) {
+			  for( auto const &item : rng ) {
+				  auto const b = static_cast<size_t>( bucket( item ) );
+				  daw::exception::dbg_precondition_check( b < bucket_count,
+				                                          "Bucket must be less than bucket_count" );
+				  ++bin( n, b );
+			  }
+		  },
+		  ts ) );
+
+		// Only worth splitting when there are many buckets to sum
+		auto const out = daw::view( result.begin( ), result.end( ) );
+		ts.wait_for( partition_range_pos(
+		  aligned_split_range_t<4096>{ }( out, ts.size( ) ),
+		  [bin, out, part_count = ranges.size( )]( auto rng, size_t ) {
+			  auto const first = static_cast<size_t>( std::distance( out.begin( ), rng.begin( ) ) );
+			  for( size_t n = 0; n < part_count; ++n ) {
+				  auto b = first;
+				  for( auto &count : rng ) {
+					  count += bin( n, b++ );
+				  }
+			  }
+		  },
+		  ts ) );
+		return result;
+	}
+
+	/// The number of items for each value of key( item ).  Each task counts
+	/// its part into one map per shard of the keys in one pass, then each task
+	/// merges one shard of all the parts
+	template<typename PartitionPolicy = split_range_t<>, typename Iterator, typename KeyFunction>
+	[[nodiscard]] auto
+	parallel_count_by_key( daw::view<Iterator> range, KeyFunction key, task_scheduler ts ) {
+		using key_t = daw::remove_cvref_t<decltype( key( *range.begin( ) ) )>;
+		using map_t = std::unordered_map<key_t, size_t>;
+		auto result = map_t( );
+		if( range.empty( ) ) {
+			return result;
+		}
+		auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
+		auto const shard_count = ranges.size( );
+		auto scratch = scratch_scope( );
+		auto part_maps = scratch.make_vector<padded_slot<std::vector<map_t>>>( ranges.size( ) );
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [&part_maps, key, shard_count]( daw::view<Iterator> rng, size_t n ) {
+			  auto &shards = part_maps[n].value;
+			  shards.resize( shard_count );
+			  auto const hash = typename map_t::hasher{ };
+			  for( auto const &item : rng ) {
+				  auto k = key( item );
+				  auto const shard = hash( k ) % shard_count;
+				  ++shards[shard][DAW_MOVE( k )];
+			  }
+		  },
+		  ts ) );
+
+		// Each shard of the keys is merged by one task, into the maps of the
+		// first part
+		run_indexed_tasks(
+		  shard_count,
+		  [&part_maps]( size_t shard ) {
+			  auto &merged = part_maps[0].value[shard];
+			  for( size_t n = 1; n < part_maps.size( ); ++n ) {
+				  for( auto const &[k, count] : part_maps[n].value[shard] ) {
+					  merged[k] += count;
+				  }
+			  }
+		  },
+		  ts );
+
+		// The shards have no keys in common, so their nodes are moved as is
+		for( auto &shard : part_maps[0].value ) {
+			result.merge( shard );
+		}
+		return result;
+	}
+
+	/// Combine the values of equal keys with reducer, which must be
+	/// associative.  Each task aggregates its part into an open addressing
+	/// table per shard of the key hashes, then each shard is merged by a task
+	/// of its own so no table is shared.  Values of a key are combined in the
+	/// order of the items
+	/// @returns the keys and their values, in no particular order
+	template<typename PartitionPolicy = split_range_t<>,
+	         typename KeyIterator,
+	         typename ValueIterator,
+	         typename BinaryOperation>
+	[[nodiscard]] auto parallel_reduce_by_key( daw::view<KeyIterator> keys,
+	                                           ValueIterator first_value,
+	                                           BinaryOperation reducer,
+	                                           task_scheduler ts ) {
+		using key_t = daw::remove_cvref_t<decltype( *keys.begin( ) )>;
+		using value_t = daw::remove_cvref_t<decltype( *first_value )>;
+		using table_t = aggregate_table<key_t, value_t>;
+		auto result = std::vector<std::pair<key_t, value_t>>( );
+		if( keys.empty( ) ) {
+			return result;
+		}
+		auto const ranges = PartitionPolicy{ }( keys, ts.size( ) );
+		auto const shard_bits = static_cast<int>( std::bit_width( ranges.size( ) - 1 ) );
+		auto const shard_count = size_t{ 1 } << static_cast<unsigned>( shard_bits );
+		auto scratch = scratch_scope( );
+		auto tables = scratch.make_vector<padded_slot<std::vector<table_t>>>( ranges.size( ) );
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [&tables, &reducer, first_key = keys.begin( ), first_value, shard_count, shard_bits](
+		    daw::view<KeyIterator> rng, size_t n ) {
+			  auto &shards = tables[n].value;
+			  shards.resize( shard_count );
+			  auto value_it = std::next( first_value, std::distance( first_key, rng.begin( ) ) );
+			  for( auto const &key : rng ) {
+				  auto const hash = table_t::hash( key );
+				  shards[table_t::shard( hash, shard_bits )].combine( hash, key, *value_it, reducer );
+				  ++value_it;
+			  }
+		  },
+		  ts ) );
+
+		// Merge the parts of each shard into the first part's, in part order
+		run_indexed_tasks(
+		  shard_count,
+		  [&tables, &reducer]( size_t shard ) {
+			  auto &merged = tables[0].value[shard];
+			  for( size_t n = 1; n < tables.size( ); ++n ) {
+				  tables[n].value[shard].for_each( [&]( std::uint64_t hash, auto &item ) {
+					  merged.combine( hash, DAW_MOVE( item.first ), DAW_MOVE( item.second ), reducer );
+				  } );
+				  tables[n].value[shard] = table_t( );
+			  }
+		  },
+		  ts );
+
+		auto offsets = scratch.make_vector<size_t>( shard_count + 1 );
+		for( size_t shard = 0; shard < shard_count; ++shard ) {
+			offsets[shard + 1] = offsets[shard] + tables[0].value[shard].size( );
+		}
+		result.resize( offsets.back( ) );
+		run_indexed_tasks(
+		  shard_count,
+		  [&tables, &offsets, &result]( size_t shard ) {
+			  auto out = std::next( result.begin( ), static_cast<std::ptrdiff_t>( offsets[shard] ) );
+			  tables[0].value[shard].for_each( [&]( std::uint64_t, auto &item ) {
+				  *out = DAW_MOVE( item );
+				  ++out;
+			  } );
+		  },
+		  ts );
+		return result;
+	}
+
+	/// Whether the items at Iterator are copied to those at OutputIterator by
+	/// stream_copy
+	template<typename Iterator, typename OutputIterator>
+	inline constexpr bool is_stream_copyable_v =
+	  std::contiguous_iterator<Iterator> and std::contiguous_iterator<OutputIterator> and
+	  std::is_same_v<std::remove_cv_t<std::iter_value_t<Iterator>>,
+	                 std::iter_value_t<OutputIterator>> and
+	  is_streamable_v<std::iter_value_t<OutputIterator>>;
+
+	template<typename PartitionPolicy = aligned_split_range_t<>,
+	         typename Iterator,
+	         typename OutputIterator>
+	void parallel_copy( daw::view<Iterator> range,
+	                    OutputIterator first_out,
+	                    store_policy policy,
+	                    task_scheduler ts ) {
+		auto const ranges = partition_for_output<PartitionPolicy>( range, ts.size( ), first_out );
+		bool const stream = use_stream_stores<OutputIterator>( policy, range.size( ) );
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [first = range.begin( ), first_out, stream]( daw::view<Iterator> rng, size_t ) {
+			  auto const out = std::next( first_out, std::distance( first, rng.begin( ) ) );
+			  if constexpr( is_stream_copyable_v<Iterator, OutputIterator> ) {
+				  if( stream ) {
+					  stream_copy( std::to_address( rng.begin( ) ), rng.size( ), std::to_address( out ) );
+					  return;
+				  }
+			  }
+			  std::copy( rng.begin( ), rng.end( ), out );
+		  },
+		  ts ) );
+	}
+
+	template<typename PartitionPolicy = aligned_split_range_t<>,
+	         typename Iterator,
+	         typename OutputIterator>
+	void parallel_uninitialized_copy( daw::view<Iterator> range,
+	                                  OutputIterator first_out,
+	                                  store_policy policy,
+	                                  task_scheduler ts ) {
+		auto const ranges = partition_for_output<PartitionPolicy>( range, ts.size( ), first_out );
+		bool const stream = use_stream_stores<OutputIterator>( policy, range.size( ) );
+		auto const out_of = [first = range.begin( ), first_out]( daw::view<Iterator> rng ) {
+			return std::next( first_out, std::distance( first, rng.begin( ) ) );
+		};
+		construct_parts(
+		  ranges,
+		  [&]( daw::view<Iterator> rng, size_t ) {
+			  if constexpr( is_stream_copyable_v<Iterator, OutputIterator> ) {
+				  if( stream ) {
+					  stream_copy(
+					    std::to_address( rng.begin( ) ), rng.size( ), std::to_address( out_of( rng ) ) );
+					  return;
+				  }
+			  }
+			  std::uninitialized_copy( rng.begin( ), rng.end( ), out_of( rng ) );
+		  },
+		  [&]( daw::view<Iterator> rng, size_t ) {
+			  std::destroy_n( out_of( rng ), rng.size( ) );
+		  },
+		  ts );
+	}
+
+	/// Construct item( n ) at out + n for each n in [0, count), destroying
+	/// those constructed when one throws
+	template<typename OutputIterator, typename Item>
+	void construct_n( OutputIterator out, size_t count, Item &item ) {
+		size_t n = 0;
+		try {
+			for( ; n < count; ++n ) {
+				std::construct_at( std::addressof( *std::next( out, static_cast<std::ptrdiff_t>( n ) ) ),
+				                   item( n ) );
+			}
+		} catch( ... ) {
+			std::destroy_n( out, n );
+			throw;
+		}
+	}
+
+	/// Construct the result of item( n ) for each n in [0, range.size( ) ) at
+	/// the uninitialized items of range, destroying them all when one throws
+	template<typename PartitionPolicy = aligned_split_range_t<>, typename Iterator, typename Item>
+	void parallel_uninitialized_generate( daw::view<Iterator> range,
+	                                      Item item,
+	                                      store_policy policy,
+	                                      task_scheduler ts ) {
+		using value_t = std::iter_value_t<Iterator>;
+		auto const ranges = partition_for_output<PartitionPolicy>( range, ts.size( ), range.begin( ) );
+		bool const stream = use_stream_stores<Iterator>( policy, range.size( ) );
+		construct_parts(
+		  ranges,
+		  [&]( daw::view<Iterator> rng, size_t ) {
+			  auto const offset = static_cast<size_t>( std::distance( range.begin( ), rng.begin( ) ) );
+			  auto part_item = [&]( size_t n ) -> decltype( auto ) {
+				  return item( offset + n );
+			  };
+			  if constexpr( std::contiguous_iterator<Iterator> and is_streamable_v<value_t> ) {
+				  if( stream ) {
+					  stream_generate( rng.size( ), std::to_address( rng.begin( ) ), part_item );
+					  return;
+				  }
+			  }
+			  construct_n( rng.begin( ), rng.size( ), part_item );
+		  },
+		  [&]( daw::view<Iterator> rng, size_t ) { std::destroy( rng.begin( ), rng.end( ) ); },
+		  ts );
+	}
+
+	/// Assign item( n ) to the item n of range
+	template<typename PartitionPolicy = aligned_split_range_t<>, typename Iterator, typename Item>
+	void parallel_generate( daw::view<Iterator> range,
+	                        Item item,
+	                        store_policy policy,
+	                        task_scheduler ts ) {
+		using value_t = std::iter_value_t<Iterator>;
+		auto const ranges = partition_for_output<PartitionPolicy>( range, ts.size( ), range.begin( ) );
+		bool const stream = use_stream_stores<Iterator>( policy, range.size( ) );
+		ts.wait_for( partition_range_pos(
+		  ranges,
+		  [&]( daw::view<Iterator> rng, size_t ) {
+			  auto const offset = static_cast<size_t>( std::distance( range.begin( ), rng.begin( ) ) );
+			  if constexpr( std::contiguous_iterator<Iterator> and is_streamable_v<value_t> ) {
+				  if( stream ) {
+					  stream_generate( rng.size( ),
+					                   std::to_address( rng.begin( ) ),
+					                   [&]( size_t n ) -> decltype( auto ) { return item( offset + n ); } );
+					  return;
+				  }
+			  }
+			  auto it = rng.begin( );
+			  for( size_t n = 0; n < rng.size( ); ++n, ++it ) {
+				  *it = item( offset + n );
+			  }
+		  },
+		  ts ) );
+	}
+
+	template<typename PartitionPolicy = aligned_split_range_t<>, typename Iterator>
+	void parallel_destroy( daw::view<Iterator> range, task_scheduler ts ) {
+		if constexpr( not std::is_trivially_destructible_v<std::iter_value_t<Iterator>> ) {
+			auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
+			ts.wait_for( partition_range_pos(
+			  ranges,
+			  []( daw::view<Iterator> rng, size_t ) { std::destroy( rng.begin( ), rng.end( ) ); },
+			  ts ) );
+		}
+	}
+
+	/// Iterators that can only be walked one item at a time, so the range
+	/// cannot be partitioned up front
+	template<typename Iterator>
+	concept block_input_iterator =
+	  std::input_iterator<Iterator> and not std::random_access_iterator<Iterator>;
+
+	/// The number of items read from a block_input_iterator for each task
+	inline constexpr size_t input_block_size = 1024;
+
+	/// Call block_func( block ) for consecutive blocks of up to block_size
+	/// items of [first, last), where block is a daw::view.  The calling thread
+	/// reads the blocks, while the tasks process the blocks read before.  A
+	/// block of forward iterators is the range of the items, as those can be
+	/// read again.  The items of input iterators are copied into a buffer first.
+	/// At most two blocks per thread are in flight, and when the limit is
+	/// reached the calling thread runs tasks instead of reading.  When
+	/// block_func throws, no more blocks are read and the first exception, in
+	/// block order, is rethrown after the tasks finish
+	/// @returns the results of block_func in block order
+	template<typename Result, block_input_iterator Iterator, typename BlockFunc>
+	[[nodiscard]] std::deque<Result> parallel_map_blocks( Iterator first,
+	                                                      Iterator last,
+	                                                      BlockFunc block_func,
+	                                                      task_scheduler ts,
+	                                                      size_t block_size = input_block_size ) {
+		using buffer_t = std::conditional_t<std::forward_iterator<Iterator>,
+		                                    daw::view<Iterator>,
+		                                    std::vector<std::iter_value_t<Iterator>>>;
+		struct block_t {
+			buffer_t items{ };
+			Result value{ };
+			std::exception_ptr error{ };
+		};
+		// A deque does not move its items when it grows, so the tasks can use
+		// theirs while the calling thread adds more
+		auto blocks = std::deque<padded_slot<block_t>>( );
+		auto failed = std::atomic<bool>( false );
+		auto limit = daw::in_flight_limit( 2 * ts.size( ), daw::in_flight_policy::help );
+		auto const run_block = [&]( block_t &block ) {
+			try {
+				if constexpr( std::forward_iterator<Iterator> ) {
+					block.value = block_func( block.items );
+				} else {
+					block.value = block_func(
+					  daw::view( block.items.data( ), block.items.data( ) + block.items.size( ) ) );
+					// Only the blocks in flight hold their items
+					block.items = buffer_t( );
+				}
+			} catch( ... ) {
+				block.error = std::current_exception( );
+				failed.store( true, std::memory_order_relaxed );
+			}
+			limit.release( );
+		};
+
+		auto read_error = std::exception_ptr( );
+		auto sem = daw::shared_cnt_sem( 1 );
+		{
+			auto const ae = on_scope_exit( [sem]( ) mutable { sem.notify( ); } );
+			// The tasks in flight refer to this frame, so a failure to read waits
+			// for them like any other
+			try {
+				while( first != last and not failed.load( std::memory_order_relaxed ) ) {
+					(void)limit.acquire( ts );
+					auto &block = blocks.emplace_back( ).value;
+					if constexpr( std::forward_iterator<Iterator> ) {
+						auto const block_first = first;
+						for( size_t n = 0; n < block_size and first != last; ++n ) {
+							++first;
+						}
+						block.items = daw::view<Iterator>( block_first, first );
+					} else {
+						block.items.reserve( block_size );
+						for( ; block.items.size( ) < block_size and first != last; ++first ) {
+							block.items.push_back( *first );
+						}
+					}
+					auto const task = [&run_block, &block] {
+						run_block( block );
+					};
+					if( not schedule_task( sem, task, ts ) ) {
+						// The other tasks refer to this frame, so do the work here
+						task( );
+					}
+				}
+			} catch( ... ) { read_error = std::current_exception( ); }
+		}
+		ts.wait_for( sem );
+
+		auto results = std::deque<Result>( );
+		for( auto &block : blocks ) {
+			if( block.value.error ) {
+				std::rethrow_exception( block.value.error );
+			}
+			results.push_back( DAW_MOVE( block.value.value ) );
+		}
+		if( read_error ) {
+			std::rethrow_exception( read_error );
+		}
+		return results;
 	}
 } // namespace daw::algorithm::parallel::impl
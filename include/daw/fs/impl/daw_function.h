@@ -165,7 +165,8 @@ namespace daw::fs::impl {
 			Function *fp = nullptr;
 
 			template<typename... Args>
-			requires( not invocable_result<Function, void, Args...> ) //
+			requires( std::is_invocable_v<Function *, Args...> and
+			          not invocable_result<Function, void, Args...> ) //
 			  constexpr decltype( auto )
 			  operator( )( Args &&...args ) const
 			  noexcept( std::is_nothrow_invocable_v<std::add_pointer_t<Function>, Args...> ) {
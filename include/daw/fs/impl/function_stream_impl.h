@@ -29,6 +29,25 @@
 
 #include "../task_scheduler.h"
 
+namespace daw {
+	namespace impl {
+		template<typename... Functions>
+		struct fused_function_t;
+	} // namespace impl
+
+	template<typename T>
+	inline constexpr bool is_fused_function_v = false;
+
+	template<typename... Functions>
+	inline constexpr bool is_fused_function_v<impl::fused_function_t<Functions...>> = true;
+
+	/// Stages for which this is true are combined with adjacent fusible stages
+	/// at compile time and run as a single task.  Specialize it for cheap, pure
+	/// function types or mark a callable with daw::fusible
+	template<typename T>
+	inline constexpr bool is_fusible_stage_v = is_fused_function_v<T>;
+} // namespace daw
+
 namespace daw::impl {
 	template<size_t S, typename Tuple>
 	using is_function_tag =
@@ -65,49 +84,57 @@ namespace daw::impl {
 	                            last_function_tag>::type;
 
 	template<size_t pos, typename Package>
-	void call_task( Package &&, last_function_tag );
+	void call_task( Package &&, continuation_policy, last_function_tag );
 
 	template<size_t pos, typename Package>
-	void call_task( Package &&, function_tag );
+	void call_task( Package &&, continuation_policy, function_tag );
 
+	/// Run the function at pos.  The first function is always scheduled so that
+	/// the caller is not blocked, policy chooses where the ones after it run
 	template<size_t pos, typename Package>
-	void call( Package &&package ) {
-		if( not get_task_scheduler( ).add_task( [package =
-		                                           daw::mutable_capture( DAW_FWD( package ) )]( ) {
-			    using which_t =
-			      typename impl::which_type_t<pos, decltype( ( *package )->function_list( ) )>::category;
-
-			    call_task<pos>( package.move_out( ), which_t{ } );
-		    } ) ) {
+	void call( Package &&package, continuation_policy policy ) {
+		auto ts = get_task_scheduler( );
+		if( not schedule_continuation(
+		      pos == 0 ? continuation_policy::scheduled : policy,
+		      [package = daw::mutable_capture( DAW_FWD( package ) ), policy]( ) {
+			      using which_t = typename impl::
+			        which_type_t<pos, decltype( ( *package )->function_list( ) )>::category;
+
+			      call_task<pos>( package.move_out( ), policy, which_t{ } );
+		      },
+		      ts ) ) {
 
 			throw daw::unable_to_add_task_exception( );
 		}
 	}
 
 	template<size_t pos, typename Package>
-	void call_task( Package &&package, last_function_tag ) {
+	void call_task( Package &&package, continuation_policy, last_function_tag ) {
 		if( not package->continue_processing( ) ) {
 			return;
 		}
-		auto func = std::get<pos>( package->function_list( ) );
 		auto client_data = package->result( ).lock( );
 		if( client_data ) {
-			client_data->from_code(
-			  [&]( ) { return std::apply( func, DAW_MOVE( package->targs( ) ) ); } );
+			client_data->from_code( [&]( ) { return package->template apply_last<pos>( ); } );
 		} else {
-			(void)std::apply( func, DAW_MOVE( package->targs( ) ) );
+			(void)package->template apply_last<pos>( );
 		}
 	}
 
 	template<size_t pos, typename Package>
-	void call_task( Package &&package, function_tag ) {
-		if( package->continue_processing( ) ) {
+	void call_task( Package &&package, continuation_policy policy, function_tag ) {
+		if( not package->continue_processing( ) ) {
 			return;
 		}
-		auto func = std::get<pos>( package->function_list( ) );
 		try {
-			call<pos + 1>( package->next_package( std::apply( func, DAW_MOVE( package->targs( ) ) ) ) );
+			// The result replaces the arguments in the same package
+			package->template apply_next<pos>( );
+			call<pos + 1>( DAW_MOVE( package ), policy );
 		} catch( ... ) {
+			if( not package ) {
+				// The package was lost with the task that could not be scheduled
+				return;
+			}
 			auto result = package->result( ).lock( );
 			if( result ) {
 				result->set_exception( std::current_exception( ) );
@@ -217,6 +244,97 @@ namespace daw::impl {
 		}
 	};
 
+	/// A group of adjacent stages run as one task body.  Each result is passed
+	/// directly to the next function with no package, tuple, or task between
+	/// them
+	template<typename... Functions>
+	struct [[nodiscard]] fused_function_t {
+		static_assert( sizeof...( Functions ) > 0 );
+		std::tuple<Functions...> funcs;
+
+	private:
+		template<size_t pos, typename Self, typename... Args>
+		static constexpr decltype( auto ) apply_from( Self &&self, Args &&...args ) {
+			if constexpr( pos + 1 == sizeof...( Functions ) ) {
+				return std::get<pos>( DAW_FWD( self ).funcs )( DAW_FWD( args )... );
+			} else {
+				return apply_from<pos + 1>( DAW_FWD( self ),
+				                            std::get<pos>( self.funcs )( DAW_FWD( args )... ) );
+			}
+		}
+
+	public:
+		template<typename... Args>
+		constexpr decltype( auto ) operator( )( Args &&...args ) const & {
+			return apply_from<0>( *this, DAW_FWD( args )... );
+		}
+
+		template<typename... Args>
+		constexpr decltype( auto ) operator( )( Args &&...args ) & {
+			return apply_from<0>( *this, DAW_FWD( args )... );
+		}
+
+		template<typename... Args>
+		constexpr decltype( auto ) operator( )( Args &&...args ) && {
+			return apply_from<0>( DAW_MOVE( *this ), DAW_FWD( args )... );
+		}
+	};
+
+	template<typename... Functions>
+	fused_function_t( std::tuple<Functions...> ) -> fused_function_t<Functions...>;
+
+	template<typename T>
+	[[nodiscard]] constexpr auto as_fused_tuple( T &&func ) {
+		if constexpr( daw::is_fused_function_v<daw::remove_cvref_t<T>> ) {
+			return DAW_FWD( func ).funcs;
+		} else {
+			return std::tuple<daw::remove_cvref_t<T>>( DAW_FWD( func ) );
+		}
+	}
+
+	template<typename... Functions>
+	[[nodiscard]] constexpr auto make_fused_function( Functions &&...funcs ) {
+		return fused_function_t( std::tuple_cat( as_fused_tuple( DAW_FWD( funcs ) )... ) );
+	}
+
+	template<typename Tuple, size_t... Is>
+	[[nodiscard]] constexpr auto tuple_tail( Tuple &&tp, std::index_sequence<Is...> ) {
+		return std::tuple<std::tuple_element_t<Is + 1, daw::remove_cvref_t<Tuple>>...>(
+		  std::get<Is + 1>( DAW_FWD( tp ) )... );
+	}
+
+	/// Merge each run of adjacent fusible stages into one fused_function_t.  The
+	/// other stages are left as they are
+	[[nodiscard]] constexpr std::tuple<> fuse_stages( ) {
+		return { };
+	}
+
+	template<typename Function, typename... Functions>
+	[[nodiscard]] constexpr auto fuse_stages( Function &&func, Functions &&...funcs ) {
+		auto rest = fuse_stages( DAW_FWD( funcs )... );
+		using rest_t = decltype( rest );
+		if constexpr( std::tuple_size_v<rest_t> > 0 ) {
+			if constexpr( daw::is_fusible_stage_v<daw::remove_cvref_t<Function>> and
+			              daw::is_fusible_stage_v<std::tuple_element_t<0, rest_t>> ) {
+				return std::tuple_cat(
+				  std::tuple( make_fused_function( DAW_FWD( func ), std::get<0>( DAW_MOVE( rest ) ) ) ),
+				  tuple_tail( DAW_MOVE( rest ),
+				              std::make_index_sequence<std::tuple_size_v<rest_t> - 1>{ } ) );
+			} else {
+				return std::tuple_cat( std::tuple<daw::remove_cvref_t<Function>>( DAW_FWD( func ) ),
+				                       DAW_MOVE( rest ) );
+			}
+		} else {
+			return std::tuple<daw::remove_cvref_t<Function>>( DAW_FWD( func ) );
+		}
+	}
+
+	template<typename Tuple>
+	[[nodiscard]] constexpr auto fuse_stage_tuple( Tuple &&funcs ) {
+		return std::apply( []( auto &&...fs ) { return fuse_stages( DAW_FWD( fs )... ); },
+		                   DAW_FWD( funcs ) );
+	}
+
 	template<typename NextFunction, typename... Functions>
 	[[nodiscard]] constexpr decltype( auto ) operator|( function_composer_t<Functions...> const &lhs,
 	                                                    NextFunction &&next_func ) noexcept {
@@ -112,20 +112,24 @@ namespace daw {
 			}
 		};
 
-		template<typename... Functions, typename... Results, typename Arg>
-		[[nodiscard]] daw::shared_cnt_sem add_fork_task( task_scheduler &ts,
-		                                                 std::tuple<Results...> &results,
-		                                                 std::tuple<Functions...> &funcs,
-		                                                 Arg &&arg ) {
-
-			auto sem = daw::shared_cnt_sem( 1 );
-			auto const ae = on_scope_exit( [sem]( ) mutable { sem.notify( ); } );
+		template<typename... Functions, typename... Results, typename... Args>
+		void add_fork_task( task_scheduler &ts,
+		                    continuation_policy policy,
+		                    std::tuple<Results...> &results,
+		                    std::tuple<Functions...> &funcs,
+		                    Args const &...args ) {
+
 			auto const fork_task = [&]<std::size_t N>( std::integral_constant<std::size_t, N> ) {
-				return ts.add_task( [r = daw::mutable_capture( std::get<N>( results ) ),
-				                     func = daw::mutable_capture( std::get<N>( funcs ) ),
-				                     arg = daw::mutable_capture( arg )]( ) //
-				                    { r->from_code( func.move_out( ), arg.move_out( ) ); },
-				                    sem );
+				return schedule_continuation(
+				  policy,
+				  [r = daw::mutable_capture( std::get<N>( results ) ),
+				   func = daw::mutable_capture( std::get<N>( funcs ) ),
+				   tpargs = daw::mutable_capture( std::tuple<Args...>( args... ) )]( ) {
+					  std::apply(
+					    [&]( auto &&...a ) { r->from_code( func.move_out( ), DAW_FWD( a )... ); },
+					    tpargs.move_out( ) );
+				  },
+				  ts );
 			};
 			auto const fork_tasks = [&]<std::size_t... Is>( std::index_sequence<Is...> ) {
 				return ( fork_task( std::integral_constant<std::size_t, Is>{ } ) and ... );
@@ -133,7 +137,84 @@ namespace daw {
 			if( not fork_tasks( std::make_index_sequence<sizeof...( Functions )>{ } ) ) {
 				throw daw::unable_to_add_task_exception{ };
 			}
-			return sem;
+		}
+
+		template<typename Function, typename... Args>
+		using fork_branch_result_t = std::invoke_result_t<Function &, Args const &...>;
+
+		/// Shared state of a fork_join.  Each branch stores its result and
+		/// decrements the remaining count, the branch that brings it to zero runs
+		/// the joiner inline.  No task ever blocks waiting on the others.
+		template<typename Joiner, typename ArgTuple, typename... Functions>
+		struct fork_join_state_t;
+
+		template<typename Joiner, typename... Args, typename... Functions>
+		struct [[nodiscard]] fork_join_state_t<Joiner, std::tuple<Args...>, Functions...> {
+			static_assert( ( not std::is_void_v<fork_branch_result_t<Functions, Args...>> and ... ),
+			               "The forked functions must return a value to pass to the joiner" );
+
+			using branch_results_t = std::tuple<
+			  daw::expected_t<daw::remove_cvref_t<fork_branch_result_t<Functions, Args...>>>...>;
+
+			using join_result_t = daw::remove_cvref_t<
+			  std::invoke_result_t<Joiner &, fork_branch_result_t<Functions, Args...>...>>;
+
+			future_result_t<join_result_t> m_result;
+			Joiner m_joiner;
+			std::tuple<Functions...> m_funcs;
+			std::tuple<Args...> m_args;
+			branch_results_t m_branch_results = branch_results_t( );
+			std::atomic<std::size_t> m_remaining = sizeof...( Functions );
+
+			template<typename J, typename TpFuncs, typename... A>
+			fork_join_state_t( future_result_t<join_result_t> result,
+			                   J &&joiner,
+			                   TpFuncs &&funcs,
+			                   A &&...args )
+			  : m_result( DAW_MOVE( result ) )
+			  , m_joiner( DAW_FWD( joiner ) )
+			  , m_funcs( DAW_FWD( funcs ) )
+			  , m_args( DAW_FWD( args )... ) {}
+
+			template<std::size_t N>
+			void run_branch( ) {
+				std::get<N>( m_branch_results ) = daw::expected_from_code( [&]( ) {
+					return std::apply( std::get<N>( m_funcs ), std::as_const( m_args ) );
+				} );
+
+				if( m_remaining.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) {
+					join( );
+				}
+			}
+
+		private:
+			void join( ) {
+				m_result.from_code( [&]( ) {
+					return std::apply(
+					  [&]( auto &...branch_results ) {
+						  return m_joiner( DAW_MOVE( branch_results ).get( )... );
+					  },
+					  m_branch_results );
+				} );
+			}
+		};
+
+		template<typename State>
+		void add_fork_join_tasks( task_scheduler &ts,
+		                          continuation_policy policy,
+		                          std::shared_ptr<State> const &state ) {
+			constexpr auto branch_count = std::tuple_size_v<typename State::branch_results_t>;
+			// Every branch must run before the joiner can, so one that cannot be
+			// scheduled is run here
+			auto const fork_task = [&]<std::size_t N>( std::integral_constant<std::size_t, N> ) {
+				if( not schedule_continuation(
+				      policy, [state]( ) { state->template run_branch<N>( ); }, ts ) ) {
+					state->template run_branch<N>( );
+				}
+			};
+			[&]<std::size_t... Is>( std::index_sequence<Is...> ) {
+				( fork_task( std::integral_constant<std::size_t, Is>{ } ), ... );
+			}( std::make_index_sequence<branch_count>{ } );
 		}
 
 		template<typename Result>
@@ -274,9 +355,15 @@ namespace daw {
 				} catch( ... ) { set_exception( std::current_exception( ) ); }
 			}
 
-			template<typename Function>
+			template<not_cvref_of<continuation_policy> Function>
 			requires( not std::is_function_v<std::remove_reference_t<Function>> ) //
 			  [[nodiscard]] auto next( Function &&func ) {
+				return next( continuation_policy::scheduled, DAW_FWD( func ) );
+			}
+
+			template<typename Function>
+			requires( not std::is_function_v<std::remove_reference_t<Function>> ) //
+			  [[nodiscard]] auto next( continuation_policy policy, Function &&func ) {
 				assert( m_data );
 				auto nxt = m_data->m_next.get( );
 				assert( not( *nxt ) ); // can only set next function once
@@ -288,16 +375,20 @@ namespace daw {
 				*nxt = [result = daw::mutable_capture( result ),
 				        func = daw::mutable_capture( DAW_FWD( func ) ),
 				        ts = daw::mutable_capture( m_data->m_task_scheduler ),
+				        policy,
 				        self = *this]( expected_result_t value ) -> void {
 					if( not value.has_value( ) ) {
 						result->set_exception( value.get_exception_ptr( ) );
 						return;
 					}
-					if( not ts->add_task( [result = daw::mutable_capture( result.move_out( ) ),
-					                       func = daw::mutable_capture( func.move_out( ) ),
-					                       v = daw::mutable_capture( DAW_MOVE( value ).get( ) )]( ) {
-						    result->from_code( func.move_out( ), v.move_out( ) );
-					    } ) ) {
+					if( not schedule_continuation(
+					      policy,
+					      [result = daw::mutable_capture( result.move_out( ) ),
+					       func = daw::mutable_capture( func.move_out( ) ),
+					       v = daw::mutable_capture( DAW_MOVE( value ).get( ) )]( ) {
+						      result->from_code( func.move_out( ), v.move_out( ) );
+					      },
+					      *ts ) ) {
 
 						throw daw::unable_to_add_task_exception{ };
 					}
@@ -313,8 +404,13 @@ namespace daw {
 				return result;
 			}
 
-			template<typename... Functions>
+			template<not_cvref_of<continuation_policy>... Functions>
 			[[nodiscard]] auto fork( Functions &&...funcs ) {
+				return fork( continuation_policy::scheduled, DAW_FWD( funcs )... );
+			}
+
+			template<typename... Functions>
+			[[nodiscard]] auto fork( continuation_policy policy, Functions &&...funcs ) {
 				assert( m_data );
 				auto nxt = m_data->m_next.get( );
 				assert( not( *nxt ) ); // can only set next function once
@@ -333,12 +429,10 @@ namespace daw {
 				        tpfuncs = daw::mutable_capture(
 				          std::tuple<daw::remove_cvref_t<Functions>...>( DAW_FWD( funcs )... ) ),
 				        ts = daw::mutable_capture( m_data->m_task_scheduler ),
+				        policy,
 				        self = *this]( cvref_of<expected_result_t> auto &&value ) {
 					if( value.has_value( ) ) {
-						if( not ts->add_task( impl::add_fork_task( *ts, *result, *tpfuncs, value.get( ) ) ) ) {
-
-							throw daw::unable_to_add_task_exception{ };
-						}
+						impl::add_fork_task( *ts, policy, *result, *tpfuncs, value.get( ) );
 					} else {
 						daw::tuple::apply( *result, [ptr = value.get_exception_ptr( )]( auto &t ) {
 							t.set_exception( ptr );
@@ -355,28 +449,56 @@ namespace daw {
 				return result;
 			}
 
-			template<typename Function, typename... Functions>
+			template<not_cvref_of<continuation_policy> Function, typename... Functions>
 			[[nodiscard]] auto fork_join( Function &&joiner, Functions &&...funcs ) {
+				return fork_join( continuation_policy::scheduled, DAW_FWD( joiner ), DAW_FWD( funcs )... );
+			}
 
-				// TODO: finish implementing
-				Unused( joiner );
-				Unused( funcs... );
+			template<typename Function, typename... Functions>
+			[[nodiscard]] auto
+			fork_join( continuation_policy policy, Function &&joiner, Functions &&...funcs ) {
 				assert( m_data );
+				static_assert( sizeof...( Functions ) > 0, "At least one function must be forked" );
+				static_assert( ( std::is_invocable_v<Functions, base_result_t const &> and ... ),
+				               "Each forked function must be callable with the result of the future" );
+
 				auto nxt = m_data->m_next.get( );
-				assert( *nxt ); // can only set next function once
+				assert( not( *nxt ) ); // can only set next function once
 
-				static_assert( (
-				  std::is_invocable_v<Functions, decltype( std::declval<expected_result_t>( ).get( ) )> and
-				  ... ) );
+				using state_t = impl::fork_join_state_t<daw::remove_cvref_t<Function>,
+				                                        std::tuple<base_result_t>,
+				                                        daw::remove_cvref_t<Functions>...>;
+				using join_result_t = typename state_t::join_result_t;
 
-				/* TODO Finish
-				using result_temp_t =
-				  std::tuple<future_result_t<daw::remove_cvref_t<decltype(
-				    funcs( std::declval<expected_result_t>( ).get( ) ) )>>...>;
-				*/
-				// using result_final_t =
-				// not implemented
-				std::abort( );
+				auto result = future_result_t<join_result_t>( m_data->m_task_scheduler );
+
+				*nxt = [result = daw::mutable_capture( result ),
+				        joiner = daw::mutable_capture( DAW_FWD( joiner ) ),
+				        tpfuncs = daw::mutable_capture(
+				          std::tuple<daw::remove_cvref_t<Functions>...>( DAW_FWD( funcs )... ) ),
+				        ts = daw::mutable_capture( m_data->m_task_scheduler ),
+				        policy,
+				        self = *this]( expected_result_t value ) -> void {
+					if( not value.has_value( ) ) {
+						result->set_exception( value.get_exception_ptr( ) );
+						return;
+					}
+					impl::add_fork_join_tasks( *ts,
+					                           policy,
+					                           std::make_shared<state_t>( result.move_out( ),
+					                                                      joiner.move_out( ),
+					                                                      tpfuncs.move_out( ),
+					                                                      DAW_MOVE( value ).get( ) ) );
+				};
+				if( future_status::ready == m_data->status( ) ) {
+					pass_next( DAW_MOVE( m_data->m_result ) );
+					m_data->status( future_status::continued );
+				} else {
+					m_data->status( future_status::continued );
+					nxt.release( );
+					m_data->notify( );
+				}
+				return result;
 			}
 
 			void wait( ) const {
@@ -476,8 +598,13 @@ namespace daw {
 				} catch( ... ) { set_exception( std::current_exception( ) ); }
 			}
 
-			template<typename Function>
+			template<not_cvref_of<continuation_policy> Function>
 			[[nodiscard]] auto next( Function &&func ) {
+				return next( continuation_policy::scheduled, DAW_FWD( func ) );
+			}
+
+			template<typename Function>
+			[[nodiscard]] auto next( continuation_policy policy, Function &&func ) {
 				auto nxt = m_data->m_next.get( );
 				daw::exception::precondition_check( not *nxt, "Can only set next function once" );
 				using next_result_t = decltype( std::declval<std::remove_reference_t<Function>>( )( ) );
@@ -487,12 +614,16 @@ namespace daw {
 				*nxt = [result = daw::mutable_capture( result ),
 				        func = daw::mutable_capture( DAW_FWD( func ) ),
 				        ts = daw::mutable_capture( m_data->m_task_scheduler ),
+				        policy,
 				        self = *this]( expected_result_t value ) -> void {
 					if( value.has_value( ) ) {
-						if( ts->add_task( [result = daw::mutable_capture( result.move_out( ) ),
-						                   func = daw::mutable_capture( func.move_out( ) )]( ) {
-							    result->from_code( func.move_out( ) );
-						    } ) ) {
+						if( not schedule_continuation(
+						      policy,
+						      [result = daw::mutable_capture( result.move_out( ) ),
+						       func = daw::mutable_capture( func.move_out( ) )]( ) {
+							      result->from_code( func.move_out( ) );
+						      },
+						      *ts ) ) {
 
 							throw daw::unable_to_add_task_exception{ };
 						}
@@ -511,8 +642,13 @@ namespace daw {
 				return result;
 			}
 
-			template<typename... Functions>
+			template<not_cvref_of<continuation_policy>... Functions>
 			[[nodiscard]] auto fork( Functions &&...funcs ) {
+				return fork( continuation_policy::scheduled, DAW_FWD( funcs )... );
+			}
+
+			template<typename... Functions>
+			[[nodiscard]] auto fork( continuation_policy policy, Functions &&...funcs ) {
 				auto nxt = m_data->m_next.get( );
 				daw::exception::precondition_check( not( *nxt ), "Can only set next function once" );
 				using result_t = std::tuple<future_result_t<daw::remove_cvref_t<decltype( funcs( ) )>>...>;
@@ -526,12 +662,15 @@ namespace daw {
 				auto result = daw::construct_a<result_t>( construct_future( funcs )... );
 
 				auto tpfuncs = std::tuple<daw::remove_cvref_t<Functions>...>( DAW_FWD( funcs )... );
-				*nxt = [result, tpfuncs = DAW_MOVE( tpfuncs ), ts = m_data->m_task_scheduler, self = *this](
-				         cvref_of<expected_result_t> auto &&value ) mutable {
+				*nxt = [result,
+				        tpfuncs = DAW_MOVE( tpfuncs ),
+				        ts = m_data->m_task_scheduler,
+				        policy,
+				        self = *this]( cvref_of<expected_result_t> auto &&value ) mutable {
 					if( value.has_value( ) ) {
-						ts.add_task( impl::add_fork_task( ts, result, tpfuncs ) );
+						impl::add_fork_task( ts, policy, result, tpfuncs );
 					} else {
-						daw::tuple::apply( result, [ptr = value.get_exeption_ptr( )]( auto &&t ) {
+						daw::tuple::apply( result, [ptr = value.get_exception_ptr( )]( auto &&t ) {
 							t.set_exception( ptr );
 						} );
 					}
@@ -547,38 +686,43 @@ namespace daw {
 				return result;
 			}
 
-			template<typename Function, typename... Functions>
+			template<not_cvref_of<continuation_policy> Function, typename... Functions>
 			[[nodiscard]] auto fork_join( Function &&joiner, Functions &&...funcs ) {
-				// TODO: finish implementing
-				Unused( joiner );
+				return fork_join( continuation_policy::scheduled, DAW_FWD( joiner ), DAW_FWD( funcs )... );
+			}
+
+			template<typename Function, typename... Functions>
+			[[nodiscard]] auto
+			fork_join( continuation_policy policy, Function &&joiner, Functions &&...funcs ) {
+				static_assert( sizeof...( Functions ) > 0, "At least one function must be forked" );
 				static_assert( ( std::is_invocable_v<Functions> and ... ) );
 				auto nxt = m_data->m_next.get( );
 				daw::exception::precondition_check( not( *nxt ), "Can only set next function once" );
 
-				auto const construct_future = [&]( auto &&f ) {
-					// Default constructs a future of the result type with the task
-					// scheduler
-					Unused( f );
-					return future_result_t<daw::remove_cvref_t<decltype( f( ) )>>( m_data->m_task_scheduler );
-				};
-
-				// Create a place to put results of functions
-				auto result = std::tuple( construct_future( funcs )... );
+				using state_t = impl::fork_join_state_t<daw::remove_cvref_t<Function>,
+				                                        std::tuple<>,
+				                                        daw::remove_cvref_t<Functions>...>;
+				using join_result_t = typename state_t::join_result_t;
 
-				auto tpfuncs = std::tuple( DAW_FWD( funcs )... );
+				auto result = future_result_t<join_result_t>( m_data->m_task_scheduler );
 
 				*nxt = [result = daw::mutable_capture( result ),
-				        tpfuncs = daw::mutable_capture( DAW_MOVE( tpfuncs ) ),
+				        joiner = daw::mutable_capture( DAW_FWD( joiner ) ),
+				        tpfuncs = daw::mutable_capture(
+				          std::tuple<daw::remove_cvref_t<Functions>...>( DAW_FWD( funcs )... ) ),
 				        ts = daw::mutable_capture( m_data->m_task_scheduler ),
-				        self = *this]( auto const &value ) {
-					static_assert( std::is_same_v<expected_result_t, DAW_TYPEOF( value )> );
-					if( value.has_value( ) ) {
-						ts->add_task( impl::add_fork_task( ts, result, tpfuncs ) );
+				        policy,
+				        self = *this]( expected_result_t value ) -> void {
+					if( not value.has_value( ) ) {
+						result->set_exception( value.get_exception_ptr( ) );
 						return;
 					}
-					daw::tuple::apply( result, [ptr = value.get_exception_ptr( )]( auto &&t ) {
-						DAW_FWD( t ).set_exception( ptr );
-					} );
+					impl::add_fork_join_tasks(
+					  *ts,
+					  policy,
+					  std::make_shared<state_t>( result.move_out( ),
+					                             joiner.move_out( ),
+					                             tpfuncs.move_out( ) ) );
 				};
 				if( future_status::ready == m_data->status( ) ) {
 					pass_next( DAW_MOVE( m_data->m_result ) );
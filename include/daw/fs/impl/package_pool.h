@@ -0,0 +1,150 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace daw::impl {
+	/// Recycles blocks of one size and alignment.  Each thread caches freed
+	/// blocks and only moves them to or from the list shared by all threads in
+	/// batches, so once warm an allocation is a pointer pop.  Blocks are never
+	/// released to operator delete, the pool keeps its peak size
+	template<std::size_t Size, std::size_t Align>
+	class package_pool {
+		struct node_t {
+			node_t *next;
+			node_t *next_batch;
+			std::size_t batch_count;
+		};
+
+		static constexpr std::size_t block_size = std::max( Size, sizeof( node_t ) );
+		static constexpr std::size_t block_align = std::max( Align, alignof( node_t ) );
+		static constexpr std::size_t batch_size = 32;
+
+		struct shared_list_t {
+			std::mutex mut{ };
+			node_t *batches = nullptr;
+
+			shared_list_t( ) = default;
+			shared_list_t( shared_list_t const & ) = delete;
+			shared_list_t &operator=( shared_list_t const & ) = delete;
+
+			void push( node_t *batch, std::size_t count ) {
+				auto const lck = std::lock_guard( mut );
+				batch->batch_count = count;
+				batch->next_batch = batches;
+				batches = batch;
+			}
+
+			[[nodiscard]] node_t *pop( ) {
+				auto const lck = std::lock_guard( mut );
+				if( batches ) {
+					return std::exchange( batches, batches->next_batch );
+				}
+				return nullptr;
+			}
+		};
+
+		struct local_cache_t {
+			node_t *head = nullptr;
+			std::size_t count = 0;
+
+			local_cache_t( ) = default;
+			local_cache_t( local_cache_t const & ) = delete;
+			local_cache_t &operator=( local_cache_t const & ) = delete;
+
+			~local_cache_t( ) {
+				if( head ) {
+					shared_list( ).push( head, count );
+				}
+			}
+		};
+
+		/// Never destroyed, the caches of threads that exit after static
+		/// destruction, such as task_scheduler workers, still push to it
+		[[nodiscard]] static shared_list_t &shared_list( ) {
+			static shared_list_t *const result = new shared_list_t{ };
+			return *result;
+		}
+
+		[[nodiscard]] static local_cache_t &local_cache( ) {
+			static thread_local local_cache_t result{ };
+			return result;
+		}
+
+	public:
+		[[nodiscard]] static void *allocate( ) {
+			auto &cache = local_cache( );
+			if( not cache.head ) {
+				cache.head = shared_list( ).pop( );
+				if( not cache.head ) {
+					return ::operator new( block_size, std::align_val_t{ block_align } );
+				}
+				cache.count = cache.head->batch_count;
+			}
+			--cache.count;
+			return std::exchange( cache.head, cache.head->next );
+		}
+
+		static void deallocate( void *ptr ) noexcept {
+			auto &cache = local_cache( );
+			auto *node = ::new( ptr ) node_t{ cache.head, nullptr, 0 };
+			cache.head = node;
+			if( ++cache.count < 2 * batch_size ) {
+				return;
+			}
+			// Give a full batch to the shared list for threads that allocate more
+			// than they free
+			auto *last = node;
+			for( std::size_t n = 1; n < batch_size; ++n ) {
+				last = last->next;
+			}
+			cache.head = std::exchange( last->next, nullptr );
+			cache.count -= batch_size;
+			shared_list( ).push( node, batch_size );
+		}
+	};
+
+	/// Allocator for std::allocate_shared that takes single objects from a
+	/// package_pool
+	template<typename T>
+	struct package_allocator {
+		using value_type = T;
+
+		package_allocator( ) = default;
+
+		template<typename U>
+		constexpr package_allocator( package_allocator<U> const & ) noexcept {}
+
+		[[nodiscard]] T *allocate( std::size_t n ) {
+			if( n != 1 ) {
+				return std::allocator<T>{ }.allocate( n );
+			}
+			return static_cast<T *>( package_pool<sizeof( T ), alignof( T )>::allocate( ) );
+		}
+
+		void deallocate( T *ptr, std::size_t n ) noexcept {
+			if( n != 1 ) {
+				std::allocator<T>{ }.deallocate( ptr, n );
+				return;
+			}
+			package_pool<sizeof( T ), alignof( T )>::deallocate( ptr );
+		}
+
+		template<typename U>
+		constexpr bool operator==( package_allocator<U> const & ) const noexcept {
+			return true;
+		}
+	};
+} // namespace daw::impl
@@ -0,0 +1,480 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+// The kernels are written with the vector extensions of gcc and clang, and
+// compiled once per instruction set with the target attribute.  Elsewhere, or
+// with DAW_FS_NO_SIMD defined, the algorithms use their scalar loops
+#if not defined( DAW_FS_NO_SIMD ) and ( defined( __GNUC__ ) or defined( __clang__ ) )
+#define DAW_FS_HAS_SIMD
+#if defined( __x86_64__ ) or defined( __i386__ )
+#define DAW_FS_HAS_SIMD_X86
+#include <immintrin.h>
+#endif
+#endif
+
+namespace daw::algorithm::parallel::impl {
+	/// A predicate that is true for items equal to value, used by count so that
+	/// the vector kernels can be picked for it
+	template<typename T>
+	struct equal_to_value {
+		T const *value;
+
+		template<typename U>
+		[[nodiscard]] constexpr bool operator( )( U const &item ) const {
+			return *value == item;
+		}
+	};
+} // namespace daw::algorithm::parallel::impl
+
+namespace daw::algorithm::parallel::impl::simd {
+	/// The instruction sets the kernels are built for
+	enum class isa_t : std::uint8_t { scalar, sse2, avx2, avx512 };
+
+	/// The best instruction set this cpu supports
+	[[nodiscard]] inline isa_t supported_isa( ) noexcept {
+#if defined( DAW_FS_HAS_SIMD_X86 )
+		static isa_t const result = [] {
+			__builtin_cpu_init( );
+			// The narrow lanes of the 512 bit kernels need avx512bw
+			if( __builtin_cpu_supports( "avx512f" ) and __builtin_cpu_supports( "avx512bw" ) ) {
+				return isa_t::avx512;
+			}
+			if( __builtin_cpu_supports( "avx2" ) ) {
+				return isa_t::avx2;
+			}
+			if( __builtin_cpu_supports( "sse2" ) ) {
+				return isa_t::sse2;
+			}
+			return isa_t::scalar;
+		}( );
+		return result;
+#elif defined( DAW_FS_HAS_SIMD )
+		// The baseline vector unit of the target, e.g. NEON
+		return isa_t::sse2;
+#else
+		return isa_t::scalar;
+#endif
+	}
+
+	namespace detail {
+		[[nodiscard]] inline std::atomic<isa_t> &isa_override( ) noexcept {
+			static auto result = std::atomic<isa_t>( isa_t::avx512 );
+			return result;
+		}
+	} // namespace detail
+
+	/// The instruction set the kernels run with
+	[[nodiscard]] inline isa_t current_isa( ) noexcept {
+		return std::min( supported_isa( ), detail::isa_override( ).load( std::memory_order_relaxed ) );
+	}
+
+	/// Run the kernels with at most isa, e.g. to compare instruction sets
+	inline void limit_isa( isa_t isa ) noexcept {
+		detail::isa_override( ).store( isa, std::memory_order_relaxed );
+	}
+
+	/// The element types the kernels handle.  bool is left out as its values
+	/// may not be only 0 or 1
+	template<typename T>
+	inline constexpr bool is_vectorizable_v =
+	  std::is_arithmetic_v<T> and not std::is_same_v<T, bool> and
+	  ( sizeof( T ) == 1 or sizeof( T ) == 2 or sizeof( T ) == 4 or sizeof( T ) == 8 );
+
+	/// An iterator to items in memory, as the kernels read them through a pointer
+	template<typename Iterator>
+	inline constexpr bool is_contiguous_v =
+	  std::contiguous_iterator<Iterator> and
+	  is_vectorizable_v<std::remove_cv_t<std::iter_value_t<Iterator>>>;
+
+	template<typename Iterator>
+	using value_t = std::remove_cv_t<std::iter_value_t<Iterator>>;
+
+	template<typename Op>
+	inline constexpr bool is_plus_v = false;
+
+	template<typename T>
+	inline constexpr bool is_plus_v<std::plus<T>> = true;
+
+	template<typename Op>
+	inline constexpr bool is_less_v = false;
+
+	template<typename T>
+	inline constexpr bool is_less_v<std::less<T>> = true;
+
+	template<typename Op>
+	inline constexpr bool is_equal_to_v = false;
+
+	template<typename T>
+	inline constexpr bool is_equal_to_v<std::equal_to<T>> = true;
+
+	/// reducer( T, T ) is a sum of the same type, so the order of the additions
+	/// is all that changes.  Narrower types promote when added and are left out
+	template<typename T, typename Init, typename BinaryOp>
+	inline constexpr bool is_vector_sum_v = [] {
+		if constexpr( is_plus_v<BinaryOp> and is_vectorizable_v<T> and std::is_same_v<T, Init> ) {
+			return std::is_same_v<T, std::remove_cvref_t<std::invoke_result_t<BinaryOp, T, T>>>;
+		} else {
+			return false;
+		}
+	}( );
+
+	/// Comparisons of integers are a total order, so the kernels find the same
+	/// item as the scalar loop.  NaN leaves floating point out
+	template<typename Iterator, typename Compare>
+	inline constexpr bool is_vector_min_max_v = is_contiguous_v<Iterator> and
+	                                            std::is_integral_v<value_t<Iterator>> and
+	                                            is_less_v<Compare>;
+
+	template<typename Iterator, typename Predicate>
+	inline constexpr bool is_vector_count_v = false;
+
+	template<typename Iterator, typename T>
+	inline constexpr bool is_vector_count_v<Iterator, equal_to_value<T>> =
+	  is_contiguous_v<Iterator> and std::is_same_v<value_t<Iterator>, T>;
+
+	/// Integers are equal when their bytes are
+	template<typename Iterator1, typename Iterator2, typename Predicate>
+	inline constexpr bool is_vector_equal_v =
+	  is_contiguous_v<Iterator1> and is_contiguous_v<Iterator2> and
+	  std::is_integral_v<value_t<Iterator1>> and
+	  std::is_same_v<value_t<Iterator1>, value_t<Iterator2>> and is_equal_to_v<Predicate>;
+
+#if defined( DAW_FS_HAS_SIMD )
+	namespace kernels {
+		/// Accumulators kept apart so the additions of one do not wait on another
+		inline constexpr std::size_t unroll = 4;
+
+		template<std::size_t Bytes, typename T>
+		using vec_t [[gnu::vector_size( Bytes )]] = T;
+
+		/// Vectors are passed by reference, the kernels' callers are built without
+		/// the instruction set that passes them in registers
+		template<typename Vec, typename T>
+		[[gnu::always_inline]] inline void load( Vec &result, T const *ptr ) noexcept {
+			std::memcpy( &result, ptr, sizeof( Vec ) );
+		}
+
+		/// Integers are added as unsigned, so they wrap as the scalar loop's do
+		/// when converted back rather than overflow
+		template<typename T>
+		using sum_t = typename std::conditional_t<std::is_integral_v<T>,
+		                                          std::make_unsigned<T>,
+		                                          std::type_identity<T>>::type;
+
+		template<std::size_t Bytes, typename T>
+		[[gnu::always_inline]] inline T sum( T const *first, std::size_t size ) noexcept {
+			using vec = vec_t<Bytes, sum_t<T>>;
+			constexpr std::size_t lanes = Bytes / sizeof( T );
+			vec acc[unroll] = { };
+			vec v;
+			std::size_t n = 0;
+			for( ; n + unroll * lanes <= size; n += unroll * lanes ) {
+				for( std::size_t u = 0; u < unroll; ++u ) {
+					load( v, first + n + u * lanes );
+					acc[u] += v;
+				}
+			}
+			for( std::size_t u = 1; u < unroll; ++u ) {
+				acc[0] += acc[u];
+			}
+			sum_t<T> result{ };
+			for( std::size_t l = 0; l < lanes; ++l ) {
+				result += acc[0][l];
+			}
+			for( ; n < size; ++n ) {
+				result += static_cast<sum_t<T>>( first[n] );
+			}
+			return static_cast<T>( result );
+		}
+
+		template<std::size_t Bytes, typename T>
+		[[gnu::always_inline]] inline std::size_t
+		count( T const *first, std::size_t size, T value ) noexcept {
+			using vec = vec_t<Bytes, T>;
+			// Lanes of the same width as T, all ones where the lane compared equal
+			using mask = decltype( vec{ } == vec{ } );
+			constexpr std::size_t lanes = Bytes / sizeof( T );
+			// Narrow lane counts are added to the total before they can overflow
+			constexpr std::size_t max_steps =
+			  sizeof( T ) >= 4 ? ~std::size_t{ 0 } : ( std::size_t{ 1 } << ( 8 * sizeof( T ) - 1 ) ) - 1;
+			auto const needle = vec{ } + value;
+			vec v;
+			std::size_t result = 0;
+			std::size_t n = 0;
+			while( n + lanes <= size ) {
+				mask acc = { };
+				for( std::size_t step = 0; step < max_steps and n + lanes <= size;
+				     ++step, n += lanes ) {
+					load( v, first + n );
+					acc += v == needle;
+				}
+				for( std::size_t l = 0; l < lanes; ++l ) {
+					result -= static_cast<std::size_t>( static_cast<std::int64_t>( acc[l] ) );
+				}
+			}
+			for( ; n < size; ++n ) {
+				result += static_cast<std::size_t>( first[n] == value );
+			}
+			return result;
+		}
+
+		/// The first of the least items, or of the greatest when Max.  The
+		/// extreme of each block is found with vectors, and only the block that
+		/// holds the result is searched for its position
+		template<std::size_t Bytes, bool Max, typename T>
+		[[gnu::always_inline]] inline T const *extreme( T const *first, std::size_t size ) noexcept {
+			using vec = vec_t<Bytes, T>;
+			constexpr std::size_t lanes = Bytes / sizeof( T );
+			constexpr std::size_t block = 64 * lanes;
+			auto const better = []( T lhs, T rhs ) {
+				if constexpr( Max ) {
+					return rhs < lhs;
+				} else {
+					return lhs < rhs;
+				}
+			};
+			T best = *first;
+			T const *best_block = first;
+			std::size_t best_size = std::min( size, block );
+			std::size_t n = 0;
+			for( ; n + block <= size; n += block ) {
+				vec acc;
+				vec v;
+				load( acc, first + n );
+				for( std::size_t m = lanes; m < block; m += lanes ) {
+					load( v, first + n + m );
+					if constexpr( Max ) {
+						acc = acc < v ? v : acc;
+					} else {
+						acc = v < acc ? v : acc;
+					}
+				}
+				T block_best = acc[0];
+				for( std::size_t l = 1; l < lanes; ++l ) {
+					if( better( acc[l], block_best ) ) {
+						block_best = acc[l];
+					}
+				}
+				// Strictly better, so of equal blocks the first is kept
+				if( better( block_best, best ) or n == 0 ) {
+					best = block_best;
+					best_block = first + n;
+					best_size = block;
+				}
+			}
+			T const *tail_best = nullptr;
+			for( auto p = first + n; p < first + size; ++p ) {
+				if( better( *p, best ) ) {
+					best = *p;
+					tail_best = p;
+				}
+			}
+			if( tail_best ) {
+				return tail_best;
+			}
+			return std::find( best_block, best_block + best_size, best );
+		}
+
+#define DAW_FS_SIMD_KERNELS( Isa, Target, Bytes )                                          \
+	template<typename T>                                                                     \
+	[[Target]] T sum_##Isa( T const *first, std::size_t size ) noexcept {     \
+		return sum<Bytes>( first, size );                                                      \
+	}                                                                                        \
+	template<typename T>                                                                     \
+	[[Target]] std::size_t count_##Isa( T const *first,                     \
+	                                                    std::size_t size,                   \
+	                                                    T value ) noexcept {                \
+		return count<Bytes>( first, size, value );                                             \
+	}                                                                                        \
+	template<bool Max, typename T>                                                           \
+	[[Target]] T const *extreme_##Isa( T const *first,                       \
+	                                                   std::size_t size ) noexcept {         \
+		return extreme<Bytes, Max>( first, size );                                             \
+	}
+
+#if defined( DAW_FS_HAS_SIMD_X86 )
+		DAW_FS_SIMD_KERNELS( sse2, gnu::target( "sse2" ), 16 )
+		DAW_FS_SIMD_KERNELS( avx2, gnu::target( "avx2" ), 32 )
+		DAW_FS_SIMD_KERNELS( avx512, gnu::target( "avx512f,avx512bw" ), 64 )
+#else
+		// The baseline vector unit of the target
+		DAW_FS_SIMD_KERNELS( sse2, , 16 )
+#endif
+#undef DAW_FS_SIMD_KERNELS
+
+#if defined( DAW_FS_HAS_SIMD_X86 )
+		// Copy lines of 64 bytes to dst, which is aligned to them, with stores
+		// that bypass the cache.  src moves on by src_step bytes a line, 0 writes
+		// the same line over and over
+		[[gnu::target( "sse2" )]] inline void stream_lines_sse2( std::byte *dst,
+		                                                         std::byte const *src,
+		                                                         std::size_t lines,
+		                                                         std::size_t src_step ) noexcept {
+			for( std::size_t n = 0; n < lines; ++n, dst += 64, src += src_step ) {
+				for( std::size_t m = 0; m < 64; m += 16 ) {
+					_mm_stream_si128( reinterpret_cast<__m128i *>( dst + m ),
+					                  _mm_loadu_si128( reinterpret_cast<__m128i const *>( src + m ) ) );
+				}
+			}
+		}
+
+		[[gnu::target( "avx2" )]] inline void stream_lines_avx2( std::byte *dst,
+		                                                         std::byte const *src,
+		                                                         std::size_t lines,
+		                                                         std::size_t src_step ) noexcept {
+			for( std::size_t n = 0; n < lines; ++n, dst += 64, src += src_step ) {
+				for( std::size_t m = 0; m < 64; m += 32 ) {
+					_mm256_stream_si256(
+					  reinterpret_cast<__m256i *>( dst + m ),
+					  _mm256_loadu_si256( reinterpret_cast<__m256i const *>( src + m ) ) );
+				}
+			}
+		}
+
+		[[gnu::target( "avx512f" )]] inline void stream_lines_avx512( std::byte *dst,
+		                                                              std::byte const *src,
+		                                                              std::size_t lines,
+		                                                              std::size_t src_step ) noexcept {
+			for( std::size_t n = 0; n < lines; ++n, dst += 64, src += src_step ) {
+				_mm512_stream_si512( reinterpret_cast<__m512i *>( dst ), _mm512_loadu_si512( src ) );
+			}
+		}
+#endif
+	} // namespace kernels
+#endif
+
+	/// Whether stream_lines bypasses the cache
+#if defined( DAW_FS_HAS_SIMD_X86 )
+	inline constexpr bool has_stream_stores = true;
+#else
+	inline constexpr bool has_stream_stores = false;
+#endif
+
+	/// Write lines of 64 bytes to dst, which is aligned to them, bypassing the
+	/// cache when the cpu can.  src moves on by src_step bytes a line, 0 writes
+	/// the line at src over and over.  Call stream_fence before the writes are
+	/// read by another thread
+	inline void
+	stream_lines( void *dst, void const *src, std::size_t lines, std::size_t src_step ) noexcept {
+		auto *out = static_cast<std::byte *>( dst );
+		auto const *in = static_cast<std::byte const *>( src );
+#if defined( DAW_FS_HAS_SIMD_X86 )
+		switch( current_isa( ) ) {
+		case isa_t::avx512:
+			kernels::stream_lines_avx512( out, in, lines, src_step );
+			return;
+		case isa_t::avx2:
+			kernels::stream_lines_avx2( out, in, lines, src_step );
+			return;
+		case isa_t::sse2:
+			kernels::stream_lines_sse2( out, in, lines, src_step );
+			return;
+		default:
+			break;
+		}
+#endif
+		for( std::size_t n = 0; n < lines; ++n, out += 64, in += src_step ) {
+			std::memcpy( out, in, 64 );
+		}
+	}
+
+	/// Order the stores of stream_lines before the ones that follow, such as
+	/// the release of a task's completion
+	inline void stream_fence( ) noexcept {
+#if defined( DAW_FS_HAS_SIMD_X86 )
+		_mm_sfence( );
+#endif
+	}
+
+	/// The sum of the size items at first
+	template<typename T>
+	[[nodiscard]] T sum( T const *first, std::size_t size ) {
+#if defined( DAW_FS_HAS_SIMD )
+		switch( current_isa( ) ) {
+#if defined( DAW_FS_HAS_SIMD_X86 )
+		case isa_t::avx512:
+			return kernels::sum_avx512( first, size );
+		case isa_t::avx2:
+			return kernels::sum_avx2( first, size );
+#endif
+		case isa_t::sse2:
+			return kernels::sum_sse2( first, size );
+		default:
+			break;
+		}
+#endif
+		T result{ };
+		for( std::size_t n = 0; n < size; ++n ) {
+			result += first[n];
+		}
+		return result;
+	}
+
+	/// The number of the size items at first that equal value
+	template<typename T>
+	[[nodiscard]] std::size_t count( T const *first, std::size_t size, T value ) {
+#if defined( DAW_FS_HAS_SIMD )
+		switch( current_isa( ) ) {
+#if defined( DAW_FS_HAS_SIMD_X86 )
+		case isa_t::avx512:
+			return kernels::count_avx512( first, size, value );
+		case isa_t::avx2:
+			return kernels::count_avx2( first, size, value );
+#endif
+		case isa_t::sse2:
+			return kernels::count_sse2( first, size, value );
+		default:
+			break;
+		}
+#endif
+		return static_cast<std::size_t>( std::count( first, first + size, value ) );
+	}
+
+	/// The first of the least, or greatest when Max, of the size items at first.
+	/// size must not be 0
+	template<bool Max, typename T>
+	[[nodiscard]] T const *extreme_element( T const *first, std::size_t size ) {
+#if defined( DAW_FS_HAS_SIMD )
+		switch( current_isa( ) ) {
+#if defined( DAW_FS_HAS_SIMD_X86 )
+		case isa_t::avx512:
+			return kernels::extreme_avx512<Max>( first, size );
+		case isa_t::avx2:
+			return kernels::extreme_avx2<Max>( first, size );
+#endif
+		case isa_t::sse2:
+			return kernels::extreme_sse2<Max>( first, size );
+		default:
+			break;
+		}
+#endif
+		if constexpr( Max ) {
+			return std::max_element( first, first + size );
+		} else {
+			return std::min_element( first, first + size );
+		}
+	}
+
+	/// The iterator to the item of the range that ptr points to
+	template<typename Iterator, typename T>
+	[[nodiscard]] Iterator to_iterator( Iterator first, T const *ptr ) {
+		return std::next( first, ptr - std::to_address( first ) );
+	}
+} // namespace daw::algorithm::parallel::impl::simd
@@ -0,0 +1,83 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include <daw/daw_move.h>
+#include <daw/daw_traits.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace daw::impl {
+	template<typename Function, typename Tuple, typename Is>
+	inline constexpr bool is_applicable_impl_v = false;
+
+	template<typename Function, typename Tuple, std::size_t... Is>
+	inline constexpr bool is_applicable_impl_v<Function, Tuple, std::index_sequence<Is...>> =
+	  std::is_invocable_v<Function, decltype( std::get<Is>( std::declval<Tuple>( ) ) )...>;
+
+	/// std::apply( func, args ) is well formed
+	template<typename Function, typename Tuple>
+	inline constexpr bool is_applicable_v = is_applicable_impl_v<
+	  Function,
+	  Tuple,
+	  std::make_index_sequence<std::tuple_size_v<daw::remove_cvref_t<Tuple>>>>;
+
+	/// Call a stage with the argument tuple it owns.  The arguments are moved
+	/// in, or passed as lvalues when the stage takes them by non-const
+	/// reference so it can work on the buffer in place
+	template<typename Function, typename Tuple>
+	constexpr decltype( auto ) apply_stage( Function &func, Tuple &args ) {
+		if constexpr( is_applicable_v<Function &, Tuple &&> ) {
+			return std::apply( func, DAW_MOVE( args ) );
+		} else {
+			return std::apply( func, args );
+		}
+	}
+
+	/// Call a stage with the one argument it owns, see apply_stage
+	template<typename Function, typename T>
+	constexpr decltype( auto ) invoke_stage( Function &func, T &arg ) {
+		if constexpr( std::is_invocable_v<Function &, T &&> ) {
+			return std::invoke( func, DAW_MOVE( arg ) );
+		} else {
+			return std::invoke( func, arg );
+		}
+	}
+
+	template<typename Function, typename Tuple>
+	using apply_stage_result_t =
+	  decltype( apply_stage( std::declval<Function &>( ), std::declval<Tuple &>( ) ) );
+
+	template<typename Function, typename T>
+	using invoke_stage_result_t =
+	  decltype( invoke_stage( std::declval<Function &>( ), std::declval<T &>( ) ) );
+
+	/// The value a stage passes on.  When the stage returns a reference into
+	/// storage, the buffer it owns such as its argument modified in place, the
+	/// value is moved out of it rather than copied
+	template<typename Result, typename Storage>
+	constexpr daw::remove_cvref_t<Result> take_stage_result( Result &&result,
+	                                                         Storage const &storage ) {
+		using value_t = std::remove_reference_t<Result>;
+		if constexpr( std::is_lvalue_reference_v<Result> and not std::is_const_v<value_t> ) {
+			auto const *ptr = reinterpret_cast<std::byte const *>( std::addressof( result ) );
+			auto const *first = reinterpret_cast<std::byte const *>( std::addressof( storage ) );
+			if( std::less_equal<>{ }( first, ptr ) and
+			    std::less<>{ }( ptr, first + sizeof( Storage ) ) ) {
+				return DAW_MOVE( result );
+			}
+		}
+		return DAW_FWD( result );
+	}
+} // namespace daw::impl
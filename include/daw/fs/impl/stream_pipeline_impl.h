@@ -0,0 +1,493 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include "../task_scheduler.h"
+#include "stage_invoke.h"
+
+#include <daw/daw_exception.h>
+#include <daw/daw_move.h>
+#include <daw/daw_traits.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace daw {
+	/// The default number of items that can be in a streaming function_stream at
+	/// once
+	inline constexpr std::size_t default_stream_buffer_size = 1024;
+
+	/// Whether the results of a parallel stage keep the order of its input
+	enum class parallel_order { ordered, unordered };
+
+	namespace impl {
+		/// A stage that function_stream::run may call from up to degree tasks at
+		/// once.  Anywhere else it is called like func
+		template<typename Function>
+		struct parallel_stage_t {
+			Function func;
+			std::size_t degree;
+			parallel_order order;
+
+			template<typename... Args>
+			requires( std::is_invocable_v<Function const &, Args...> ) //
+			  constexpr decltype( auto ) operator( )( Args &&...args ) const {
+				return std::invoke( func, DAW_FWD( args )... );
+			}
+		};
+	} // namespace impl
+
+	template<typename T>
+	inline constexpr bool is_parallel_stage_v = false;
+
+	template<typename Function>
+	inline constexpr bool is_parallel_stage_v<impl::parallel_stage_t<Function>> = true;
+
+	/// True for the stages made by daw::tumbling_window and daw::sliding_window.
+	/// They pass on the windows they close, so most items end at them, and run
+	/// flushes them when its input ends
+	template<typename T>
+	inline constexpr bool is_window_stage_v = false;
+
+	namespace impl {
+		/// Fixed capacity single producer/single consumer FIFO holding the input of
+		/// one stage.  The producer is the stage before it and the consumer is the
+		/// one drainer allowed to run at a time, push reports when one needs to be
+		/// started.  The pipeline never has more items in flight than the capacity
+		template<typename T>
+		class stream_buffer_t {
+			static constexpr std::size_t cache_line_size = 64;
+
+			std::vector<std::optional<T>> m_items;
+			alignas( cache_line_size ) std::atomic<std::size_t> m_head = 0;
+			alignas( cache_line_size ) std::atomic<std::size_t> m_tail = 0;
+			alignas( cache_line_size ) std::atomic<bool> m_draining = false;
+
+		public:
+			explicit stream_buffer_t( std::size_t capacity )
+			  : m_items( capacity ) {}
+
+			/// @returns true when no drainer is running and the caller must start one
+			[[nodiscard]] bool push( T &&value ) {
+				auto const tail = m_tail.load( std::memory_order_relaxed );
+				// The slot is free once the consumer's pop of it is visible
+				while( tail - m_head.load( std::memory_order_acquire ) >= m_items.size( ) ) {
+					std::this_thread::yield( );
+				}
+				m_items[tail % m_items.size( )] = DAW_MOVE( value );
+				m_tail.store( tail + 1, std::memory_order_seq_cst );
+				return not m_draining.load( std::memory_order_seq_cst ) and
+				       not m_draining.exchange( true, std::memory_order_seq_cst );
+			}
+
+			/// Take the next item.  When empty the drainer is released and an empty
+			/// optional is returned
+			[[nodiscard]] std::optional<T> pop( ) {
+				auto const head = m_head.load( std::memory_order_relaxed );
+				if( head == m_tail.load( std::memory_order_acquire ) ) {
+					m_draining.store( false, std::memory_order_seq_cst );
+					// A push may have raced with releasing the drainer and not started
+					// a new one
+					if( head == m_tail.load( std::memory_order_seq_cst ) or
+					    m_draining.exchange( true, std::memory_order_seq_cst ) ) {
+						return { };
+					}
+				}
+				auto &item = m_items[head % m_items.size( )];
+				auto result = std::optional<T>( DAW_MOVE( *item ) );
+				item.reset( );
+				m_head.store( head + 1, std::memory_order_release );
+				return result;
+			}
+		};
+
+		/// Input buffer and reorder buffer of a parallel stage.  Up to degree
+		/// workers pop items, each tagged with its position in the stage's input,
+		/// and hand their results to emit.  Results leave one at a time so the
+		/// next stage still sees a single producer.  When ordered, results that
+		/// finish early wait in a slot for the ones before them
+		template<typename T, typename Out>
+		class parallel_stream_buffer_t {
+			std::mutex m_mut{ };
+			std::vector<std::optional<T>> m_items;
+			std::size_t m_front = 0;
+			std::size_t m_size = 0;
+			std::size_t m_next_seq = 0;
+			std::size_t m_workers = 0;
+			std::size_t m_degree;
+			bool m_is_ordered;
+
+			std::mutex m_out_mut{ };
+			std::vector<std::optional<std::optional<Out>>> m_reorder;
+			std::size_t m_next_out = 0;
+
+		public:
+			struct config_t {
+				std::size_t capacity;
+				std::size_t degree;
+				parallel_order order;
+			};
+
+			explicit parallel_stream_buffer_t( config_t const &cfg )
+			  : m_items( cfg.capacity )
+			  , m_degree( cfg.degree )
+			  , m_is_ordered( cfg.order == parallel_order::ordered )
+			  , m_reorder( m_is_ordered ? cfg.capacity : 0U ) {
+
+				daw::exception::precondition_check( cfg.degree > 0,
+				                                    "The degree of a parallel stage must be positive" );
+			}
+
+			/// @returns true when fewer than degree workers are running and the caller
+			/// must start another
+			[[nodiscard]] bool push( T &&value ) {
+				auto const lck = std::lock_guard( m_mut );
+				assert( m_size < m_items.size( ) );
+				m_items[( m_front + m_size ) % m_items.size( )] = DAW_MOVE( value );
+				++m_size;
+				if( m_workers < m_degree ) {
+					++m_workers;
+					return true;
+				}
+				return false;
+			}
+
+			/// Take the next item and its sequence number.  When empty the worker is
+			/// released and an empty optional is returned
+			[[nodiscard]] std::optional<std::pair<std::size_t, T>> pop( ) {
+				auto const lck = std::lock_guard( m_mut );
+				if( m_size == 0 ) {
+					--m_workers;
+					return { };
+				}
+				auto &item = m_items[m_front];
+				auto result = std::optional<std::pair<std::size_t, T>>( std::in_place,
+				                                                        m_next_seq++,
+				                                                        DAW_MOVE( *item ) );
+				item.reset( );
+				m_front = ( m_front + 1 ) % m_items.size( );
+				--m_size;
+				return result;
+			}
+
+			/// Pass the result of item seq to deliver, and when ordered any results
+			/// after it that were waiting.  An empty result marks a failed item and
+			/// is delivered too so the items after it are not held back
+			template<typename Deliver>
+			void emit( std::size_t seq, std::optional<Out> &&result, Deliver deliver ) {
+				auto const lck = std::lock_guard( m_out_mut );
+				if( not m_is_ordered ) {
+					deliver( DAW_MOVE( result ) );
+					return;
+				}
+				m_reorder[seq % m_reorder.size( )].emplace( DAW_MOVE( result ) );
+				while( auto &slot = m_reorder[m_next_out % m_reorder.size( )] ) {
+					auto next = DAW_MOVE( *slot );
+					slot.reset( );
+					++m_next_out;
+					deliver( DAW_MOVE( next ) );
+				}
+			}
+		};
+
+		/// What the last stage passes to a sink taking no arguments
+		struct stream_void_t {};
+
+		template<typename... Ts>
+		struct stream_input_list {
+			template<typename T>
+			using prepend = stream_input_list<T, Ts...>;
+
+			template<template<typename...> class Tmpl>
+			using apply = Tmpl<Ts...>;
+		};
+
+		/// The input type of each stage and the result of the last one
+		template<typename Input, typename... Functions>
+		struct stream_stage_types {
+			using inputs = stream_input_list<>;
+			using result_t = Input;
+		};
+
+		template<typename Input, typename Function, typename... Functions>
+		struct stream_stage_types<Input, Function, Functions...> {
+			static_assert( not std::is_void_v<Input>,
+			               "Only the last function in a stream can return void" );
+			using next_t =
+			  stream_stage_types<daw::remove_cvref_t<invoke_stage_result_t<Function, Input>>,
+			                     Functions...>;
+			using inputs = typename next_t::inputs::template prepend<Input>;
+			using result_t = typename next_t::result_t;
+		};
+
+		/// State shared by the tasks of one function_stream::run.  Items are moved
+		/// from buffer to buffer and only the source blocks, so the number of
+		/// scheduler threads does not matter.  sink is only called before run
+		/// returns so it is held by reference
+		template<typename Sink, typename Input, typename... Functions>
+		class [[nodiscard]] stream_pipeline_t
+		  : public std::enable_shared_from_this<stream_pipeline_t<Sink, Input, Functions...>> {
+
+			using stage_types = stream_stage_types<Input, Functions...>;
+			using inputs_t = typename stage_types::inputs::template apply<std::tuple>;
+			using result_t = typename stage_types::result_t;
+			static constexpr std::size_t stage_count = sizeof...( Functions );
+
+			static_assert( stage_count > 0, "At least one function is required" );
+
+			template<std::size_t Stage>
+			using stage_function_t = std::tuple_element_t<Stage, std::tuple<Functions...>>;
+
+			/// What stage passes on, the next stage's input or the sink's argument
+			template<std::size_t Stage>
+			using stage_output_t = typename std::conditional_t<
+			  ( Stage + 1 < stage_count ),
+			  std::tuple_element<std::min( Stage + 1, stage_count - 1 ), inputs_t>,
+			  std::conditional<std::is_void_v<result_t>, stream_void_t, result_t>>::type;
+
+			template<std::size_t Stage>
+			using stage_buffer_t =
+			  std::conditional_t<is_parallel_stage_v<stage_function_t<Stage>>,
+			                     parallel_stream_buffer_t<std::tuple_element_t<Stage, inputs_t>,
+			                                              stage_output_t<Stage>>,
+			                     stream_buffer_t<std::tuple_element_t<Stage, inputs_t>>>;
+
+			template<typename Is>
+			struct buffers_impl;
+
+			template<std::size_t... Is>
+			struct buffers_impl<std::index_sequence<Is...>> {
+				using type = std::tuple<stage_buffer_t<Is>...>;
+			};
+
+			using buffers_t = typename buffers_impl<std::make_index_sequence<stage_count>>::type;
+
+			task_scheduler m_ts;
+			std::tuple<Functions...> m_funcs;
+			Sink &m_sink;
+			std::size_t m_max_in_flight;
+			buffers_t m_buffers;
+			std::atomic<std::size_t> m_in_flight = 0;
+			std::atomic<bool> m_has_error = false;
+			std::exception_ptr m_error = nullptr;
+			std::once_flag m_error_flag{ };
+
+			template<std::size_t... Is>
+			stream_pipeline_t( std::index_sequence<Is...>,
+			                   task_scheduler ts,
+			                   std::tuple<Functions...> const &funcs,
+			                   Sink &sink,
+			                   std::size_t max_in_flight )
+			  : m_ts( DAW_MOVE( ts ) )
+			  , m_funcs( funcs )
+			  , m_sink( sink )
+			  , m_max_in_flight( max_in_flight )
+			  , m_buffers( buffer_config<Is>( max_in_flight )... ) {}
+
+			/// The buffers cannot be moved, so they are built in place from this
+			template<std::size_t Stage>
+			[[nodiscard]] auto buffer_config( std::size_t max_in_flight ) const {
+				if constexpr( is_parallel_stage_v<stage_function_t<Stage>> ) {
+					auto const &func = std::get<Stage>( m_funcs );
+					using config_t = typename stage_buffer_t<Stage>::config_t;
+					return config_t{ max_in_flight, func.degree, func.order };
+				} else {
+					return max_in_flight;
+				}
+			}
+
+		public:
+			stream_pipeline_t( task_scheduler ts,
+			                   std::tuple<Functions...> const &funcs,
+			                   Sink &sink,
+			                   std::size_t max_in_flight )
+			  : stream_pipeline_t( std::make_index_sequence<stage_count>{ },
+			                       DAW_MOVE( ts ),
+			                       funcs,
+			                       sink,
+			                       max_in_flight ) {
+
+				daw::exception::precondition_check( max_in_flight > 0,
+				                                    "The stream buffer size must be positive" );
+			}
+
+			/// Feed each element of [first, last) into the first stage and return
+			/// once every one has reached the sink.  When the pipeline is full the
+			/// caller runs pending tasks until there is room
+			template<typename Iterator, typename Last>
+			void run( Iterator first, Last last ) {
+				// The tasks refer to the sink, so whatever happens the items in flight
+				// are waited for before returning
+				try {
+					for( ; first != last and not m_has_error.load( std::memory_order_acquire ); ++first ) {
+						wait_while( [&]( ) {
+							return m_in_flight.load( std::memory_order_acquire ) >= m_max_in_flight;
+						} );
+						auto input = Input( *first );
+						m_in_flight.fetch_add( 1, std::memory_order_acq_rel );
+						try {
+							push<0>( DAW_MOVE( input ) );
+						} catch( ... ) {
+							complete_item( );
+							throw;
+						}
+					}
+				} catch( ... ) { set_exception( std::current_exception( ) ); }
+				wait_while( [&]( ) { return m_in_flight.load( std::memory_order_acquire ) > 0; } );
+				flush_windows( std::make_index_sequence<stage_count>{ } );
+				if( m_error ) {
+					std::rethrow_exception( m_error );
+				}
+			}
+
+		private:
+			template<typename Predicate>
+			void wait_while( Predicate pred ) {
+				while( pred( ) ) {
+					if( not m_ts.help_run_next_task( ) ) {
+						std::this_thread::yield( );
+					}
+				}
+			}
+
+			/// Pass on the windows still open once the input has ended, one window
+			/// stage at a time so those of a stage reach the stages after it first
+			template<std::size_t... Is>
+			void flush_windows( std::index_sequence<Is...> ) {
+				( flush_window<Is>( ), ... );
+			}
+
+			template<std::size_t Stage>
+			void flush_window( ) {
+				if constexpr( is_window_stage_v<stage_function_t<Stage>> ) {
+					if( m_has_error.load( std::memory_order_acquire ) ) {
+						return;
+					}
+					auto result = std::optional<stage_output_t<Stage>>( );
+					try {
+						result = std::get<Stage>( m_funcs ).flush( );
+					} catch( ... ) {
+						set_exception( std::current_exception( ) );
+						return;
+					}
+					m_in_flight.fetch_add( 1, std::memory_order_acq_rel );
+					deliver<Stage>( DAW_MOVE( result ) );
+					wait_while( [&]( ) { return m_in_flight.load( std::memory_order_acquire ) > 0; } );
+				}
+			}
+
+			void complete_item( ) {
+				m_in_flight.fetch_sub( 1, std::memory_order_acq_rel );
+			}
+
+			void set_exception( std::exception_ptr ptr ) {
+				std::call_once( m_error_flag, [&]( ) {
+					m_error = DAW_MOVE( ptr );
+					m_has_error.store( true, std::memory_order_release );
+				} );
+			}
+
+			template<std::size_t Stage, typename T>
+			void push( T &&item ) {
+				if( not std::get<Stage>( m_buffers ).push( DAW_FWD( item ) ) ) {
+					return;
+				}
+				// The item is in the buffer and this owns draining it, so when no task
+				// can be added for that the work is done here
+				bool is_added = false;
+				try {
+					is_added = m_ts.add_task( [self = this->shared_from_this( )]( ) {
+						self->template drain<Stage>( );
+					} );
+				} catch( ... ) {}
+				if( not is_added ) {
+					drain<Stage>( );
+				}
+			}
+
+			template<std::size_t Stage>
+			void drain( ) {
+				auto &buffer = std::get<Stage>( m_buffers );
+				if constexpr( is_parallel_stage_v<stage_function_t<Stage>> ) {
+					while( auto item = buffer.pop( ) ) {
+						buffer.emit( item->first,
+						             run_stage<Stage>( DAW_MOVE( item->second ) ),
+						             [&]( std::optional<stage_output_t<Stage>> &&result ) {
+							             deliver<Stage>( DAW_MOVE( result ) );
+						             } );
+					}
+				} else {
+					while( auto item = buffer.pop( ) ) {
+						deliver<Stage>( run_stage<Stage>( DAW_MOVE( *item ) ) );
+					}
+				}
+			}
+
+			/// @returns the output of stage, or nothing when it or an earlier item
+			/// failed
+			template<std::size_t Stage, typename T>
+			[[nodiscard]] std::optional<stage_output_t<Stage>> run_stage( T &&item ) {
+				if( m_has_error.load( std::memory_order_acquire ) ) {
+					return { };
+				}
+				try {
+					auto &func = std::get<Stage>( m_funcs );
+					if constexpr( std::is_same_v<stage_output_t<Stage>, stream_void_t> ) {
+						(void)invoke_stage( func, item );
+						return stream_void_t{ };
+					} else {
+						// A buffer modified in place and returned by reference is moved on
+						return stage_output_t<Stage>(
+						  take_stage_result( invoke_stage( func, item ), item ) );
+					}
+				} catch( ... ) { set_exception( std::current_exception( ) ); }
+				return { };
+			}
+
+			template<std::size_t Stage>
+			void deliver( std::optional<stage_output_t<Stage>> &&result ) {
+				if( not result ) {
+					complete_item( );
+					return;
+				}
+				if constexpr( is_window_stage_v<stage_function_t<Stage>> ) {
+					// Most items only update an aggregate and close no window
+					if( result->empty( ) ) {
+						complete_item( );
+						return;
+					}
+				}
+				try {
+					if constexpr( Stage + 1 < stage_count ) {
+						push<Stage + 1>( DAW_MOVE( *result ) );
+						return;
+					} else if constexpr( std::is_void_v<result_t> ) {
+						m_sink( );
+					} else {
+						m_sink( DAW_MOVE( *result ) );
+					}
+				} catch( ... ) { set_exception( std::current_exception( ) ); }
+				complete_item( );
+			}
+		};
+	} // namespace impl
+} // namespace daw
@@ -85,6 +85,11 @@ namespace daw {
 			return m_latch.try_wait( );
 		}
 
+		/// A default constructed task has nothing to run
+		[[nodiscard]] inline bool empty( ) const {
+			return not m_function;
+		}
+
 		void wait( ) const {
 			m_latch.wait( );
 		}
@@ -131,6 +136,11 @@ namespace daw {
 			return m_ftask->try_wait( );
 		}
 
+		[[nodiscard]] inline bool empty( ) const {
+			assert( m_ftask );
+			return m_ftask->empty( );
+		}
+
 		void wait( ) const {
 			assert( m_ftask );
 			m_ftask->wait( );
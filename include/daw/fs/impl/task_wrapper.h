@@ -23,6 +23,7 @@
 #pragma once
 
 #include <daw/daw_concepts.h>
+#include <daw/daw_scope_guard.h>
 
 #include <cstddef>
 #include <thread>
@@ -31,6 +32,29 @@ namespace daw::impl {
 	template<typename Iterator, typename Handle>
 	struct temp_task_runner;
 
+	/// A scheduler whose queue a task_wrapper on this thread is running, and
+	/// the one that was being drained when it started
+	struct task_wrapper_drain_t {
+		void const *ts;
+		task_wrapper_drain_t const *outer;
+	};
+
+	[[nodiscard]] inline task_wrapper_drain_t const *&task_wrapper_drains( ) noexcept {
+		thread_local task_wrapper_drain_t const *drains = nullptr;
+		return drains;
+	}
+
+	/// True while a task_wrapper on this thread is running the queued tasks of
+	/// ts
+	[[nodiscard]] inline bool task_wrapper_is_draining( void const *ts ) noexcept {
+		for( auto const *drain = task_wrapper_drains( ); drain; drain = drain->outer ) {
+			if( drain->ts == ts ) {
+				return true;
+			}
+		}
+		return false;
+	}
+
 	template<typename Handle, invocable Function>
 	struct task_wrapper {
 		std::size_t id;
@@ -53,6 +77,17 @@ namespace daw::impl {
 				return;
 			}
 			(void)func( );
+			// Only the outermost task of each scheduler drains its queue.  Nested
+			// ones would recurse once per queued task and overflow the stack.  A
+			// task of another scheduler still drains its own queue
+			void const *const ts = self->m_ts_impl.get( );
+			if( task_wrapper_is_draining( ts ) ) {
+				return;
+			}
+			auto &drains = task_wrapper_drains( );
+			auto const drain = task_wrapper_drain_t{ ts, drains };
+			drains = &drain;
+			auto const ae = on_scope_exit( [&drains, &drain]( ) { drains = drain.outer; } );
 			while( self->started( ) and self->run_next_task( id ) ) {
 				std::this_thread::yield( );
 			}
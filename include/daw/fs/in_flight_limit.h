@@ -0,0 +1,164 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include "task_scheduler.h"
+
+#include <daw/daw_exception.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace daw {
+	/// What a call does when its in_flight_limit is reached
+	enum class in_flight_policy : uint8_t {
+		/// Wait on the calling thread until a call finishes.  Do not use from a
+		/// task, it can take a worker that the calls in flight need
+		block,
+		/// Run pending tasks on the calling thread until a call finishes
+		help,
+		/// Do not start the call, its result holds a would_block_exception
+		would_block
+	};
+
+	/// The result of a call refused by an in_flight_limit with
+	/// in_flight_policy::would_block
+	struct would_block_exception : std::exception {
+		[[nodiscard]] char const *what( ) const noexcept override {
+			return "The limit of calls in flight was reached";
+		}
+	};
+
+	/// Bounds the number of calls that are started and not yet finished, so
+	/// that a producer calling faster than the tasks run cannot grow the task
+	/// queues without limit.  It can be shared by several function_streams or
+	/// batches of make_future_result and must outlive the calls that use it
+	class in_flight_limit {
+		std::size_t m_max;
+		in_flight_policy m_policy;
+		std::atomic<std::size_t> m_count = 0;
+		std::atomic<std::size_t> m_waiters = 0;
+		std::mutex m_mut{ };
+		std::condition_variable m_cv{ };
+
+	public:
+		explicit in_flight_limit( std::size_t max_in_flight,
+		                          in_flight_policy policy = in_flight_policy::help )
+		  : m_max( max_in_flight )
+		  , m_policy( policy ) {
+
+			daw::exception::precondition_check( max_in_flight > 0,
+			                                    "The in flight limit must be positive" );
+		}
+
+		in_flight_limit( in_flight_limit const & ) = delete;
+		in_flight_limit &operator=( in_flight_limit const & ) = delete;
+
+		[[nodiscard]] std::size_t max_in_flight( ) const noexcept {
+			return m_max;
+		}
+
+		[[nodiscard]] in_flight_policy policy( ) const noexcept {
+			return m_policy;
+		}
+
+		/// The number of calls currently in flight
+		[[nodiscard]] std::size_t size( ) const noexcept {
+			return m_count.load( std::memory_order_acquire );
+		}
+
+		/// Take a slot if one is free
+		[[nodiscard]] bool try_acquire( ) noexcept {
+			// seq_cst pairs with release so a blocked acquire cannot miss a slot
+			auto count = m_count.load( std::memory_order_seq_cst );
+			while( count < m_max ) {
+				if( m_count.compare_exchange_weak( count, count + 1, std::memory_order_acq_rel ) ) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/// Take a slot, waiting as the policy says when there are none
+		/// @returns false when the policy is would_block and no slot was free
+		[[nodiscard]] bool acquire( task_scheduler &ts ) {
+			if( try_acquire( ) ) {
+				return true;
+			}
+			switch( m_policy ) {
+			case in_flight_policy::would_block:
+				return false;
+			case in_flight_policy::help:
+				while( not try_acquire( ) ) {
+					if( not ts.help_run_next_task( ) ) {
+						std::this_thread::yield( );
+					}
+				}
+				return true;
+			case in_flight_policy::block:
+				break;
+			}
+			m_waiters.fetch_add( 1, std::memory_order_seq_cst );
+			auto lck = std::unique_lock( m_mut );
+			m_cv.wait( lck, [&]( ) { return try_acquire( ); } );
+			m_waiters.fetch_sub( 1, std::memory_order_relaxed );
+			return true;
+		}
+
+		/// Give back a slot when a call finishes
+		void release( ) noexcept {
+			m_count.fetch_sub( 1, std::memory_order_seq_cst );
+			// A waiter counted before this sees the slot or is notified
+			if( m_waiters.load( std::memory_order_seq_cst ) > 0 ) {
+				auto const lck = std::lock_guard( m_mut );
+				m_cv.notify_one( );
+			}
+		}
+	};
+
+	namespace impl {
+		/// An acquired slot of an in_flight_limit, given back when destroyed
+		class [[nodiscard]] in_flight_slot {
+			in_flight_limit *m_limit = nullptr;
+
+		public:
+			in_flight_slot( ) = default;
+
+			explicit in_flight_slot( in_flight_limit &limit ) noexcept
+			  : m_limit( &limit ) {}
+
+			in_flight_slot( in_flight_slot &&other ) noexcept
+			  : m_limit( std::exchange( other.m_limit, nullptr ) ) {}
+
+			in_flight_slot &operator=( in_flight_slot &&rhs ) noexcept {
+				if( this != &rhs ) {
+					reset( );
+					m_limit = std::exchange( rhs.m_limit, nullptr );
+				}
+				return *this;
+			}
+
+			~in_flight_slot( ) {
+				reset( );
+			}
+
+			void reset( ) noexcept {
+				if( auto *limit = std::exchange( m_limit, nullptr ); limit ) {
+					limit->release( );
+				}
+			}
+		};
+	} // namespace impl
+} // namespace daw
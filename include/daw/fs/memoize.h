@@ -0,0 +1,298 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include "impl/daw_function.h"
+
+#include <daw/daw_exception.h>
+#include <daw/daw_move.h>
+#include <daw/daw_traits.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace daw {
+	/// How a memoized stage chooses the entry to drop when its cache is full
+	enum class memo_eviction : uint8_t {
+		/// Drop the least recently used entry.  Every hit reorders the shard
+		lru,
+		/// Drop an entry not used since the clock hand last passed it.  Hits
+		/// only set a flag and can run concurrently
+		clock
+	};
+
+	struct memo_options {
+		/// Bytes the cache may use.  Each entry is counted as the size of its
+		/// key and value plus the bookkeeping around it, memory the key or value
+		/// owns on the heap is not counted
+		std::size_t memory_budget = 16U * 1024U * 1024U;
+		/// Independently locked parts of the cache
+		std::size_t shard_count = 16;
+		memo_eviction eviction = memo_eviction::lru;
+	};
+
+	struct memo_stats {
+		std::size_t hits = 0;
+		std::size_t misses = 0;
+		std::size_t evictions = 0;
+		std::size_t size = 0;
+	};
+
+	namespace impl {
+		struct memo_key_hash {
+			template<typename... Ts>
+			[[nodiscard]] std::size_t operator( )( std::tuple<Ts...> const &key ) const {
+				return std::apply(
+				  []( auto const &...parts ) {
+					  std::size_t seed = 0;
+					  ( ( seed ^= std::hash<daw::remove_cvref_t<decltype( parts )>>{ }( parts ) +
+					               0x9e37'79b9'7f4a'7c15ULL + ( seed << 6U ) + ( seed >> 2U ) ),
+					    ... );
+					  return seed;
+				  },
+				  key );
+			}
+		};
+
+		struct memo_counters_t {
+			std::atomic<std::size_t> hits = 0;
+			std::atomic<std::size_t> misses = 0;
+			std::atomic<std::size_t> evictions = 0;
+		};
+
+		template<typename Key, typename Value>
+		class memo_lru_shard_t {
+			using list_t = std::list<std::pair<Key, Value>>;
+
+			mutable std::mutex m_mut{ };
+			list_t m_entries{ };
+			std::unordered_map<Key, typename list_t::iterator, memo_key_hash> m_index{ };
+			std::size_t m_capacity;
+
+		public:
+			/// The cost of one entry counted against the memory budget
+			static constexpr std::size_t entry_size =
+			  sizeof( typename list_t::value_type ) + sizeof( Key ) + 6 * sizeof( void * );
+
+			explicit memo_lru_shard_t( std::size_t capacity )
+			  : m_capacity( capacity ) {}
+
+			[[nodiscard]] std::optional<Value> find( Key const &key ) {
+				auto const lck = std::lock_guard( m_mut );
+				auto pos = m_index.find( key );
+				if( pos == m_index.end( ) ) {
+					return { };
+				}
+				m_entries.splice( m_entries.begin( ), m_entries, pos->second );
+				return pos->second->second;
+			}
+
+			/// @returns true when an entry was evicted to make room
+			bool insert( Key &&key, Value const &value ) {
+				auto const lck = std::lock_guard( m_mut );
+				if( m_index.find( key ) != m_index.end( ) ) {
+					return false;
+				}
+				bool evicted = false;
+				if( m_entries.size( ) >= m_capacity ) {
+					m_index.erase( m_entries.back( ).first );
+					m_entries.pop_back( );
+					evicted = true;
+				}
+				m_entries.emplace_front( key, value );
+				m_index.emplace( DAW_MOVE( key ), m_entries.begin( ) );
+				return evicted;
+			}
+
+			[[nodiscard]] std::size_t size( ) const {
+				auto const lck = std::lock_guard( m_mut );
+				return m_entries.size( );
+			}
+		};
+
+		template<typename Key, typename Value>
+		class memo_clock_shard_t {
+			struct slot_t {
+				std::optional<std::pair<Key, Value>> entry{ };
+				std::atomic<bool> referenced = false;
+			};
+
+			mutable std::shared_mutex m_mut{ };
+			std::unique_ptr<slot_t[]> m_slots;
+			std::unordered_map<Key, std::size_t, memo_key_hash> m_index{ };
+			std::size_t m_capacity;
+			std::size_t m_hand = 0;
+
+		public:
+			/// The cost of one entry counted against the memory budget
+			static constexpr std::size_t entry_size =
+			  sizeof( slot_t ) + sizeof( Key ) + 4 * sizeof( void * );
+
+			explicit memo_clock_shard_t( std::size_t capacity )
+			  : m_slots( std::make_unique<slot_t[]>( capacity ) )
+			  , m_capacity( capacity ) {}
+
+			[[nodiscard]] std::optional<Value> find( Key const &key ) {
+				auto const lck = std::shared_lock( m_mut );
+				auto pos = m_index.find( key );
+				if( pos == m_index.end( ) ) {
+					return { };
+				}
+				auto &slot = m_slots[pos->second];
+				slot.referenced.store( true, std::memory_order_relaxed );
+				return slot.entry->second;
+			}
+
+			/// @returns true when an entry was evicted to make room
+			bool insert( Key &&key, Value const &value ) {
+				auto const lck = std::lock_guard( m_mut );
+				if( m_index.find( key ) != m_index.end( ) ) {
+					return false;
+				}
+				// Give each referenced entry a second chance as the hand passes it
+				while( m_slots[m_hand].referenced.exchange( false, std::memory_order_relaxed ) ) {
+					m_hand = ( m_hand + 1 ) % m_capacity;
+				}
+				auto &slot = m_slots[m_hand];
+				m_hand = ( m_hand + 1 ) % m_capacity;
+				bool const evicted = slot.entry.has_value( );
+				if( evicted ) {
+					m_index.erase( slot.entry->first );
+				}
+				slot.entry.emplace( key, value );
+				m_index.emplace( DAW_MOVE( key ), static_cast<std::size_t>( &slot - m_slots.get( ) ) );
+				return evicted;
+			}
+
+			[[nodiscard]] std::size_t size( ) const {
+				auto const lck = std::shared_lock( m_mut );
+				return m_index.size( );
+			}
+		};
+
+		/// A cache split in shards, each with its own lock, chosen by the hash
+		/// of the key
+		template<typename Key, typename Value, typename Shard>
+		class memo_cache_t {
+			std::size_t m_shard_count;
+			std::unique_ptr<std::unique_ptr<Shard>[]> m_shards;
+			memo_counters_t m_counters{ };
+
+			[[nodiscard]] Shard &shard_for( Key const &key ) const {
+				return *m_shards[memo_key_hash{ }( key ) % m_shard_count];
+			}
+
+		public:
+			explicit memo_cache_t( memo_options const &opts )
+			  : m_shard_count( opts.shard_count )
+			  , m_shards( std::make_unique<std::unique_ptr<Shard>[]>( opts.shard_count ) ) {
+
+				daw::exception::precondition_check( opts.shard_count > 0,
+				                                    "A memoized stage needs at least one shard" );
+				auto const capacity =
+				  std::max<std::size_t>( 1, opts.memory_budget / opts.shard_count / Shard::entry_size );
+				for( std::size_t n = 0; n < m_shard_count; ++n ) {
+					m_shards[n] = std::make_unique<Shard>( capacity );
+				}
+			}
+
+			/// The cached value for key, or the result of compute( ) which is
+			/// added to the cache.  compute runs without holding a lock, so two
+			/// threads missing on the same key may both run it
+			template<typename Compute>
+			[[nodiscard]] Value get_or_compute( Key &&key, Compute &&compute ) {
+				auto &shard = shard_for( key );
+				if( auto cached = shard.find( key ); cached ) {
+					m_counters.hits.fetch_add( 1, std::memory_order_relaxed );
+					return DAW_MOVE( *cached );
+				}
+				m_counters.misses.fetch_add( 1, std::memory_order_relaxed );
+				auto result = Value( compute( ) );
+				if( shard.insert( DAW_MOVE( key ), result ) ) {
+					m_counters.evictions.fetch_add( 1, std::memory_order_relaxed );
+				}
+				return result;
+			}
+
+			[[nodiscard]] memo_stats stats( ) const {
+				auto result = memo_stats{ m_counters.hits.load( std::memory_order_relaxed ),
+				                          m_counters.misses.load( std::memory_order_relaxed ),
+				                          m_counters.evictions.load( std::memory_order_relaxed ),
+				                          0 };
+				for( std::size_t n = 0; n < m_shard_count; ++n ) {
+					result.size += m_shards[n]->size( );
+				}
+				return result;
+			}
+		};
+
+		/// A stage that returns cached results for arguments it has seen.  Copies
+		/// share the cache, as the copies of a function_stream's stages must
+		template<typename Function, typename... Args>
+		class memoized_function_t {
+			using key_t = std::tuple<daw::remove_cvref_t<Args>...>;
+			using value_t = daw::remove_cvref_t<std::invoke_result_t<Function const &, Args const &...>>;
+			using lru_cache_t = memo_cache_t<key_t, value_t, memo_lru_shard_t<key_t, value_t>>;
+			using clock_cache_t = memo_cache_t<key_t, value_t, memo_clock_shard_t<key_t, value_t>>;
+
+			static_assert( not std::is_void_v<value_t>, "A memoized function must return a value" );
+
+			Function m_func;
+			std::shared_ptr<lru_cache_t> m_lru_cache = nullptr;
+			std::shared_ptr<clock_cache_t> m_clock_cache = nullptr;
+
+		public:
+			template<typename F>
+			memoized_function_t( F &&func, memo_options const &opts )
+			  : m_func( DAW_FWD( func ) ) {
+				if( opts.eviction == memo_eviction::lru ) {
+					m_lru_cache = std::make_shared<lru_cache_t>( opts );
+				} else {
+					m_clock_cache = std::make_shared<clock_cache_t>( opts );
+				}
+			}
+
+			[[nodiscard]] value_t operator( )( Args const &...args ) const {
+				auto compute = [&]( ) -> value_t { return std::invoke( m_func, args... ); };
+				if( m_lru_cache ) {
+					return m_lru_cache->get_or_compute( key_t( args... ), compute );
+				}
+				return m_clock_cache->get_or_compute( key_t( args... ), compute );
+			}
+
+			[[nodiscard]] memo_stats stats( ) const {
+				return m_lru_cache ? m_lru_cache->stats( ) : m_clock_cache->stats( );
+			}
+		};
+	} // namespace impl
+
+	/// Wrap a pure function so that repeated arguments return a cached result
+	/// instead of calling it again.  Args are the argument types, which key the
+	/// cache and must be hashable with std::hash and equality comparable.  The
+	/// result, and any copy of it, reports hit/miss/eviction counts with stats( )
+	template<typename... Args, typename Function>
+	[[nodiscard]] auto memoize( Function &&func, memo_options const &opts = memo_options{ } ) {
+		static_assert( sizeof...( Args ) > 0, "The argument types of the function are required" );
+		using func_t = daw::remove_cvref_t<decltype( fs::impl::make_callable( DAW_FWD( func ) ) )>;
+		return impl::memoized_function_t<func_t, Args...>( fs::impl::make_callable( DAW_FWD( func ) ),
+		                                                  opts );
+	}
+} // namespace daw
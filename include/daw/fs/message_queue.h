@@ -29,6 +29,7 @@
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <thread>
 #include <utility>
 
 namespace daw::parallel {
@@ -115,6 +116,7 @@ namespace daw::parallel {
 		static_assert( std::is_invocable_v<Predicate> );
 		auto result = q.try_pop_front( );
 		while( not result and can_continue( ) ) {
+			std::this_thread::yield( );
 			result = q.try_pop_front( );
 		}
 		return result;
@@ -22,12 +22,19 @@
 
 #pragma once
 
+#include "impl/package_pool.h"
+#include "impl/stage_invoke.h"
+#include "in_flight_limit.h"
+
+#include <cstddef>
 #include <memory>
 #include <tuple>
+#include <type_traits>
 #include <utility>
+#include <variant>
 
 #include <daw/daw_move.h>
-#include <daw/daw_value_ptr.h>
+#include <daw/daw_traits.h>
 
 namespace daw {
 	template<typename Result, typename Functions, typename... Args>
@@ -52,119 +59,162 @@ namespace daw {
 	using weak_ptr_type_t = typename weak_ptr_type_impl<T>::type;
 
 	namespace impl {
-		template<typename functions_t, typename arguments_t, typename result_t,
-		         typename... Args>
-		struct [[nodiscard]] package_impl_t {
-			functions_t m_function_list;
-			arguments_t m_targs;
-			result_t m_result;
-			bool m_continue_on_result_destruction;
-
-			constexpr package_impl_t( bool continueonclientdestruction,
-			                          result_t result, functions_t functions,
-			                          Args &&... args )
-			  : m_function_list( DAW_MOVE( functions ) )
-			  , m_targs( DAW_FWD( args )... )
-			  , m_result( result )
-			  , m_continue_on_result_destruction( continueonclientdestruction ) {}
-		}; // package_impl_t
-	}    // namespace impl
-
+		template<typename Variant, typename T>
+		struct variant_prepend;
+
+		template<typename... Ts, typename T>
+		struct variant_prepend<std::variant<Ts...>, T> {
+			using type = std::variant<T, Ts...>;
+		};
+
+		/// A variant of the argument tuple of every function, alternative n holds
+		/// the arguments of function n
+		template<typename Arguments, typename... Functions>
+		struct package_arguments {
+			using type = std::variant<Arguments>;
+		};
+
+		template<typename Arguments, typename Function, typename Next, typename... Functions>
+		struct package_arguments<Arguments, Function, Next, Functions...> {
+			using next_arguments_t =
+			  std::tuple<daw::remove_cvref_t<apply_stage_result_t<Function, Arguments>>>;
+
+			using type = typename variant_prepend<
+			  typename package_arguments<next_arguments_t, Next, Functions...>::type,
+			  Arguments>::type;
+		};
+
+		template<typename Arguments, typename Functions>
+		struct package_arguments_from_tuple;
+
+		template<typename Arguments, typename... Functions>
+		struct package_arguments_from_tuple<Arguments, std::tuple<Functions...>> {
+			using type = typename package_arguments<Arguments, Functions...>::type;
+		};
+
+		/// The value the last function of a package returns
+		template<typename Functions, typename Arguments>
+		struct package_result;
+
+		template<typename... Functions, typename Arguments>
+		struct package_result<std::tuple<Functions...>, Arguments> {
+			using last_arguments_t =
+			  std::variant_alternative_t<sizeof...( Functions ) - 1,
+			                             typename package_arguments<Arguments, Functions...>::type>;
+			using last_function_t = std::tuple_element_t<sizeof...( Functions ) - 1,
+			                                             std::tuple<Functions...>>;
+			using type =
+			  daw::remove_cvref_t<apply_stage_result_t<last_function_t, last_arguments_t>>;
+		};
+
+		template<typename Functions, typename Arguments>
+		using package_result_t = typename package_result<Functions, Arguments>::type;
+	} // namespace impl
+
+	/// The state of one call of a function_stream.  It is allocated once per
+	/// call and the storage for the arguments, sized for the largest argument
+	/// tuple, is reused in place as each function's result becomes the next
+	/// one's arguments
 	template<typename Result, typename Functions, typename... Args>
 	struct [[nodiscard]] package_t {
 		using functions_t = daw::remove_cvref_t<Functions>;
 		using arguments_t = std::tuple<daw::remove_cvref_t<Args>...>;
 		using result_t = Result;
 		using result_value_t = typename result_t::type;
-		//	weak_ptr_type_t<result_t>;
 
 	private:
-		daw::value_ptr<
-		  impl::package_impl_t<functions_t, arguments_t, result_t, Args...>>
-		  m_impl;
+		using stage_arguments_t =
+		  typename impl::package_arguments_from_tuple<arguments_t, functions_t>::type;
+
+		functions_t m_function_list;
+		stage_arguments_t m_targs;
+		result_t m_result;
+		bool m_continue_on_result_destruction;
+		impl::in_flight_slot m_in_flight_slot{ };
 
 	public:
 		package_t( package_t const & ) = delete;
 		package_t &operator=( package_t const & ) = delete;
-
+		package_t( package_t && ) = delete;
+		package_t &operator=( package_t && ) = delete;
 		~package_t( ) noexcept = default;
-		constexpr package_t( package_t && ) noexcept = default;
-		constexpr package_t &operator=( package_t && ) noexcept = default;
-
-		constexpr package_t( bool continueonclientdestruction, result_t result,
-		                     functions_t &&functions, Args &&... args )
-		  : m_impl( continueonclientdestruction, DAW_MOVE( result ),
-		            DAW_MOVE( functions ), DAW_FWD( args )... ) {}
 
-		constexpr package_t( bool continueonclientdestruction, result_t result,
-		                     functions_t const &functions, Args &&... args )
-		  : m_impl( continueonclientdestruction, DAW_MOVE( result ), functions,
-		            DAW_FWD( args )... ) {}
+		template<typename F>
+		package_t( bool continueonclientdestruction, result_t result, F &&functions,
+		           Args &&... args )
+		  : m_function_list( DAW_FWD( functions ) )
+		  , m_targs( std::in_place_index<0>, DAW_FWD( args )... )
+		  , m_result( DAW_MOVE( result ) )
+		  , m_continue_on_result_destruction( continueonclientdestruction ) {}
 
 		[[nodiscard]] constexpr functions_t const &function_list( ) const noexcept {
-			return m_impl->m_function_list;
+			return m_function_list;
 		}
 
 		[[nodiscard]] constexpr functions_t &function_list( ) noexcept {
-			return m_impl->m_function_list;
+			return m_function_list;
 		}
 
 		[[nodiscard]] constexpr result_t const &result( ) const noexcept {
-			return m_impl->m_result;
+			return m_result;
 		}
 
 		[[nodiscard]] constexpr result_t &result( ) noexcept {
-			return m_impl->m_result;
+			return m_result;
 		}
 
 		[[nodiscard]] constexpr bool continue_processing( ) const {
-			return continue_on_result_destruction( );
-		}
-
-		template<typename... NewArgs>
-		[[nodiscard]] decltype( auto ) next_package( NewArgs && ... nargs ) {
-			return make_shared_package( continue_on_result_destruction( ),
-			                            DAW_MOVE( m_impl->m_result ),
-			                            DAW_MOVE( m_impl->m_function_list ),
-			                            DAW_FWD( nargs )... );
+			return m_continue_on_result_destruction;
 		}
 
-		[[nodiscard]] constexpr arguments_t const &targs( ) const noexcept {
-			return m_impl->m_targs;
+		/// Hold slot until the call is finished with the package
+		void set_in_flight_slot( impl::in_flight_slot &&slot ) noexcept {
+			m_in_flight_slot = DAW_MOVE( slot );
 		}
 
-		[[nodiscard]] constexpr arguments_t &targs( ) noexcept {
-			return m_impl->m_targs;
+		/// The arguments of the function at pos
+		template<std::size_t pos>
+		[[nodiscard]] constexpr auto &targs( ) noexcept {
+			return *std::get_if<pos>( &m_targs );
 		}
 
-	private:
-		[[nodiscard]] constexpr bool const &continue_on_result_destruction( )
-		  const noexcept {
-			return m_impl->m_continue_on_result_destruction;
+		/// Call the function at pos and replace its arguments with its result,
+		/// the arguments of the next function.  A buffer that the function
+		/// modified in place and returned by reference is moved, not copied
+		template<std::size_t pos>
+		void apply_next( ) {
+			auto value = impl::take_stage_result(
+			  impl::apply_stage( std::get<pos>( m_function_list ), targs<pos>( ) ),
+			  m_targs );
+			m_targs.template emplace<pos + 1>( DAW_MOVE( value ) );
 		}
 
-		[[nodiscard]] constexpr bool &continue_on_result_destruction( ) noexcept {
-			return m_impl->m_continue_on_result_destruction;
+		/// Call the last function, at pos, and return its result by value
+		template<std::size_t pos>
+		auto apply_last( ) {
+			auto &func = std::get<pos>( m_function_list );
+			using stage_result_t =
+			  impl::apply_stage_result_t<decltype( func ), decltype( targs<pos>( ) )>;
+			if constexpr( std::is_void_v<stage_result_t> ) {
+				impl::apply_stage( func, targs<pos>( ) );
+			} else {
+				return impl::take_stage_result( impl::apply_stage( func, targs<pos>( ) ), m_targs );
+			}
 		}
 	}; // package_t
 
-	template<typename Result, typename Functions, typename... Args>
-	[[nodiscard]] package_t<Result, Functions, Args...>
-	make_package( bool continue_on_result_destruction, Result &&result,
-	              Functions &&functions, Args &&... args ) {
-		return package_t<Result, Functions, Args...>(
-		  continue_on_result_destruction, DAW_FWD( result ),
-		  DAW_FWD( functions ), DAW_FWD( args )... );
-	}
-
+	/// Create the package for one call of a function_stream.  The package and
+	/// its reference count share one allocation that is taken from a per thread
+	/// pool, so repeated calls do not allocate once the pool is warm
 	template<typename Result, typename Functions, typename... Args>
 	[[nodiscard]] std::shared_ptr<package_t<Result, Functions, Args...>>
 	make_shared_package( bool continue_on_result_destruction, Result &&result,
 	                     Functions &&functions, Args &&... args ) {
-		return std::make_shared<package_t<Result, Functions, Args...>>(
-		  make_package(
-		    continue_on_result_destruction, DAW_FWD( result ),
-		    DAW_FWD( functions ), DAW_FWD( args )... ) );
+		using package_type = package_t<Result, Functions, Args...>;
+		return std::allocate_shared<package_type>( impl::package_allocator<package_type>{ },
+		                                           continue_on_result_destruction,
+		                                           DAW_FWD( result ),
+		                                           DAW_FWD( functions ),
+		                                           DAW_FWD( args )... );
 	}
-
 } // namespace daw
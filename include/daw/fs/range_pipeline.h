@@ -0,0 +1,359 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include "impl/algorithms_impl.h"
+#include "task_scheduler.h"
+
+#include <daw/daw_move.h>
+#include <daw/daw_view.h>
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// Lazy range pipelines, e.g.
+///   data | transform( f ) | filter( p ) | reduce( op )
+/// The stages only record the functions, and the reduce, count or for_each
+/// at the end runs all of them in one parallel pass over the range.  Each
+/// item goes through every stage before the next item is read, so there are
+/// no intermediate buffers and only one fork-join.  A pipeline refers to its
+/// range, which must outlive it
+namespace daw::algorithm::parallel {
+	namespace impl {
+		template<typename UnaryOperation>
+		struct transform_stage {
+			UnaryOperation unary_op;
+
+			template<typename T>
+			using output_t = std::invoke_result_t<UnaryOperation const &, T>;
+
+			template<typename T, typename Next>
+			constexpr void push( T &&item, Next &next ) const {
+				next( unary_op( DAW_FWD( item ) ) );
+			}
+		};
+
+		template<typename UnaryPredicate>
+		struct filter_stage {
+			UnaryPredicate pred;
+
+			template<typename T>
+			using output_t = T;
+
+			template<typename T, typename Next>
+			constexpr void push( T &&item, Next &next ) const {
+				if( pred( std::as_const( item ) ) ) {
+					next( DAW_FWD( item ) );
+				}
+			}
+		};
+
+		/// The type the last of Stages passes on for each item of type T
+		template<typename T, typename... Stages>
+		struct stage_output {
+			using type = T;
+		};
+
+		template<typename T, typename Stage, typename... Stages>
+		struct stage_output<T, Stage, Stages...> {
+			using type = typename stage_output<typename Stage::template output_t<T>, Stages...>::type;
+		};
+
+		/// Pass item through the stages from I on, and what comes out of the last
+		/// to sink
+		template<std::size_t I, typename Stages, typename T, typename Sink>
+		constexpr void push_item( Stages const &stages, T &&item, Sink &sink ) {
+			if constexpr( I == std::tuple_size_v<Stages> ) {
+				sink( DAW_FWD( item ) );
+			} else {
+				auto next = [&]( auto &&value ) {
+					push_item<I + 1>( stages, DAW_FWD( value ), sink );
+				};
+				std::get<I>( stages ).push( DAW_FWD( item ), next );
+			}
+		}
+
+		template<typename Iterator, typename... Stages>
+		class range_pipeline {
+			daw::view<Iterator> m_range;
+			std::tuple<Stages...> m_stages;
+
+		public:
+			/// The type of the items that come out of the last stage
+			using value_type = daw::remove_cvref_t<
+			  typename stage_output<std::iter_reference_t<Iterator>, Stages...>::type>;
+
+			constexpr range_pipeline( daw::view<Iterator> range, std::tuple<Stages...> stages )
+			  : m_range( range )
+			  , m_stages( DAW_MOVE( stages ) ) {}
+
+			[[nodiscard]] constexpr daw::view<Iterator> range( ) const {
+				return m_range;
+			}
+
+			template<typename Stage>
+			[[nodiscard]] constexpr range_pipeline<Iterator, Stages..., Stage>
+			add_stage( Stage stage ) const {
+				return range_pipeline<Iterator, Stages..., Stage>(
+				  m_range, std::tuple_cat( m_stages, std::tuple<Stage>( DAW_MOVE( stage ) ) ) );
+			}
+
+			/// Pass the items of rng, a part of the range, through the stages to sink
+			template<typename Sink>
+			constexpr void run( daw::view<Iterator> rng, Sink &sink ) const {
+				for( auto it = rng.begin( ); it != rng.end( ); ++it ) {
+					push_item<0>( m_stages, *it, sink );
+				}
+			}
+		};
+
+		template<typename T>
+		inline constexpr bool is_range_pipeline_v = false;
+
+		template<typename Iterator, typename... Stages>
+		inline constexpr bool is_range_pipeline_v<range_pipeline<Iterator, Stages...>> = true;
+
+		/// Run pipeline in one pass, each task adding the items that come out of
+		/// its part to its own copy of init with add( state, item ).  The states
+		/// are given to merge( state ) in part order.  When a stage throws, the
+		/// first exception, in part order, is rethrown after all tasks finish
+		template<typename PartitionPolicy = split_range_t<>,
+		         typename Iterator,
+		         typename... Stages,
+		         typename State,
+		         typename Add,
+		         typename Merge>
+		void parallel_pipeline( range_pipeline<Iterator, Stages...> const &pipeline,
+		                        State const &init,
+		                        Add add,
+		                        Merge merge,
+		                        task_scheduler ts ) {
+			struct part_t {
+				State state;
+				std::exception_ptr error{ };
+			};
+			auto const range = pipeline.range( );
+			auto const run_part = [&]( part_t &part, daw::view<Iterator> rng ) {
+				try {
+					auto sink = [&]( auto &&item ) { add( part.state, DAW_FWD( item ) ); };
+					pipeline.run( rng, sink );
+				} catch( ... ) { part.error = std::current_exception( ); }
+			};
+			auto const finish = [&]( part_t &part ) {
+				if( part.error ) {
+					std::rethrow_exception( part.error );
+				}
+				merge( DAW_MOVE( part.state ) );
+			};
+			if( PartitionPolicy::min_range_size > range.size( ) ) {
+				auto part = part_t{ init };
+				run_part( part, range );
+				finish( part );
+				return;
+			}
+			auto const ranges = PartitionPolicy{ }( range, ts.size( ) );
+			auto scratch = scratch_scope( );
+			auto parts = scratch.make_vector( ranges.size( ), padded_slot<part_t>{ part_t{ init } } );
+			ts.wait_for( partition_range_pos(
+			  ranges,
+			  [&]( daw::view<Iterator> rng, size_t n ) { run_part( parts[n].value, rng ); },
+			  ts ) );
+			for( auto &part : parts ) {
+				finish( part.value );
+			}
+		}
+
+		/// Use a value initialized item of the pipeline as the initial value
+		struct value_init_t {};
+
+		template<typename T, typename BinaryOperation>
+		struct reduce_terminal {
+			T init;
+			BinaryOperation binary_op;
+			task_scheduler ts;
+		};
+
+		struct count_terminal {
+			task_scheduler ts;
+		};
+
+		template<typename UnaryOperation>
+		struct for_each_terminal {
+			UnaryOperation unary_op;
+			task_scheduler ts;
+		};
+
+		template<typename T>
+		inline constexpr bool is_view_v = false;
+
+		template<typename Iterator>
+		inline constexpr bool is_view_v<daw::view<Iterator>> = true;
+
+		template<typename Range>
+		concept pipeline_source =
+		  not is_range_pipeline_v<daw::remove_cvref_t<Range>> and
+		  not is_view_v<daw::remove_cvref_t<Range>> and
+		  ( std::is_lvalue_reference_v<Range> or std::ranges::borrowed_range<Range> ) and
+		  requires( Range &&r ) {
+			  { std::begin( r ) } -> random_access_iterator;
+		  };
+
+		template<pipeline_source Range>
+		[[nodiscard]] constexpr auto make_pipeline( Range &&r ) {
+			using iterator_t = decltype( std::begin( r ) );
+			return range_pipeline<iterator_t>( daw::view<iterator_t>( std::begin( r ), std::end( r ) ),
+			                                   std::tuple<>( ) );
+		}
+
+		template<typename Iterator>
+		[[nodiscard]] constexpr auto make_pipeline( daw::view<Iterator> r ) {
+			return range_pipeline<Iterator>( r, std::tuple<>( ) );
+		}
+
+		template<typename Iterator, typename... Stages, typename UnaryOperation>
+		[[nodiscard]] constexpr auto operator|( range_pipeline<Iterator, Stages...> const &pipeline,
+		                                        transform_stage<UnaryOperation> stage ) {
+			return pipeline.add_stage( DAW_MOVE( stage ) );
+		}
+
+		template<typename Iterator, typename... Stages, typename UnaryPredicate>
+		[[nodiscard]] constexpr auto operator|( range_pipeline<Iterator, Stages...> const &pipeline,
+		                                        filter_stage<UnaryPredicate> stage ) {
+			return pipeline.add_stage( DAW_MOVE( stage ) );
+		}
+
+		template<typename Range, typename UnaryOperation>
+		requires( not is_range_pipeline_v<daw::remove_cvref_t<Range>> ) //
+		  [[nodiscard]] constexpr auto
+		  operator|( Range &&r, transform_stage<UnaryOperation> stage ) {
+			return make_pipeline( DAW_FWD( r ) ).add_stage( DAW_MOVE( stage ) );
+		}
+
+		template<typename Range, typename UnaryPredicate>
+		requires( not is_range_pipeline_v<daw::remove_cvref_t<Range>> ) //
+		  [[nodiscard]] constexpr auto
+		  operator|( Range &&r, filter_stage<UnaryPredicate> stage ) {
+			return make_pipeline( DAW_FWD( r ) ).add_stage( DAW_MOVE( stage ) );
+		}
+
+		template<typename Iterator, typename... Stages, typename T, typename BinaryOperation>
+		[[nodiscard]] auto operator|( range_pipeline<Iterator, Stages...> const &pipeline,
+		                              reduce_terminal<T, BinaryOperation> terminal ) {
+			using value_t = typename range_pipeline<Iterator, Stages...>::value_type;
+			using init_t = std::conditional_t<std::is_same_v<T, value_init_t>, value_t, T>;
+			using result_t = daw::remove_cvref_t<
+			  std::invoke_result_t<BinaryOperation &, init_t, value_t>>;
+
+			auto const &binary_op = terminal.binary_op;
+			auto result = [&]( ) -> result_t {
+				if constexpr( std::is_same_v<T, value_init_t> ) {
+					return static_cast<result_t>( value_t{ } );
+				} else {
+					return static_cast<result_t>( DAW_MOVE( terminal.init ) );
+				}
+			}( );
+			parallel_pipeline(
+			  pipeline,
+			  std::optional<result_t>( ),
+			  [&binary_op]( std::optional<result_t> &state, auto &&item ) {
+				  if( state ) {
+					  *state = binary_op( DAW_MOVE( *state ), DAW_FWD( item ) );
+				  } else {
+					  state.emplace( DAW_FWD( item ) );
+				  }
+			  },
+			  [&]( std::optional<result_t> &&state ) {
+				  if( state ) {
+					  result = binary_op( DAW_MOVE( result ), DAW_MOVE( *state ) );
+				  }
+			  },
+			  DAW_MOVE( terminal.ts ) );
+			return result;
+		}
+
+		template<typename Iterator, typename... Stages>
+		[[nodiscard]] std::size_t operator|( range_pipeline<Iterator, Stages...> const &pipeline,
+		                                     count_terminal terminal ) {
+			std::size_t result = 0;
+			parallel_pipeline(
+			  pipeline,
+			  std::size_t{ 0 },
+			  []( std::size_t &state, auto && ) { ++state; },
+			  [&]( std::size_t state ) { result += state; },
+			  DAW_MOVE( terminal.ts ) );
+			return result;
+		}
+
+		template<typename Iterator, typename... Stages, typename UnaryOperation>
+		void operator|( range_pipeline<Iterator, Stages...> const &pipeline,
+		                for_each_terminal<UnaryOperation> terminal ) {
+			auto const &unary_op = terminal.unary_op;
+			parallel_pipeline(
+			  pipeline,
+			  true,
+			  [&unary_op]( bool, auto &&item ) { (void)unary_op( DAW_FWD( item ) ); },
+			  []( bool ) {},
+			  DAW_MOVE( terminal.ts ) );
+		}
+	} // namespace impl
+
+	/// A pipeline stage passing on unary_op( item ) for each item
+	template<typename UnaryOperation>
+	[[nodiscard]] constexpr auto transform( UnaryOperation &&unary_op ) {
+		return impl::transform_stage{ daw::traits::lift_func( DAW_FWD( unary_op ) ) };
+	}
+
+	/// A pipeline stage passing on the items for which pred( item ) is true
+	template<typename UnaryPredicate>
+	[[nodiscard]] constexpr auto filter( UnaryPredicate &&pred ) {
+		return impl::filter_stage{ daw::traits::lift_func( DAW_FWD( pred ) ) };
+	}
+
+	/// End a pipeline with the reduction of its items with binary_op, starting
+	/// from init.  binary_op must be associative, as the items of each part
+	/// are reduced before the parts are
+	template<typename T, typename BinaryOperation>
+	requires( std::is_invocable_v<BinaryOperation &, T, T> ) //
+	  [[nodiscard]] auto reduce( T init,
+	                             BinaryOperation &&binary_op,
+	                             task_scheduler ts = get_task_scheduler( ) ) {
+		return impl::reduce_terminal{
+		  DAW_MOVE( init ), daw::traits::lift_func( DAW_FWD( binary_op ) ), DAW_MOVE( ts ) };
+	}
+
+	/// End a pipeline with the reduction of its items with binary_op, starting
+	/// from a value initialized item
+	template<typename BinaryOperation>
+	[[nodiscard]] auto reduce( BinaryOperation &&binary_op,
+	                           task_scheduler ts = get_task_scheduler( ) ) {
+		return impl::reduce_terminal{
+		  impl::value_init_t{ }, daw::traits::lift_func( DAW_FWD( binary_op ) ), DAW_MOVE( ts ) };
+	}
+
+	/// End a pipeline with the number of items that come out of it
+	[[nodiscard]] inline auto count( task_scheduler ts = get_task_scheduler( ) ) {
+		return impl::count_terminal{ DAW_MOVE( ts ) };
+	}
+
+	/// End a pipeline by calling unary_op on each item that comes out of it,
+	/// in no particular order
+	template<typename UnaryOperation>
+	[[nodiscard]] auto for_each( UnaryOperation &&unary_op,
+	                             task_scheduler ts = get_task_scheduler( ) ) {
+		return impl::for_each_terminal{ daw::traits::lift_func( DAW_FWD( unary_op ) ),
+		                                DAW_MOVE( ts ) };
+	}
+} // namespace daw::algorithm::parallel
@@ -0,0 +1,170 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace daw::algorithm::parallel {
+	/// Memory for the bookkeeping of the parallel algorithms, such as the
+	/// result slot of each task.  Allocation bumps a pointer and memory is only
+	/// given back when the call that allocated it returns, so the blocks are
+	/// kept and a thread calling an algorithm repeatedly does not allocate for
+	/// it after the first call.  Only used from one thread at a time
+	class scratch_arena : public std::pmr::memory_resource {
+		struct block_t {
+			std::unique_ptr<std::byte[]> data;
+			std::size_t size;
+		};
+
+		std::vector<block_t> m_blocks{ };
+		std::size_t m_block = 0;
+		std::size_t m_offset = 0;
+		std::size_t m_block_size;
+
+	public:
+		/// The position of the next allocation, see release
+		struct mark_t {
+			std::size_t block;
+			std::size_t offset;
+		};
+
+		/// block_size is the size of the first block, later ones double
+		explicit scratch_arena( std::size_t block_size = 64U * 1024U ) noexcept
+		  : m_block_size( std::max<std::size_t>( block_size, 64 ) ) {}
+
+		scratch_arena( scratch_arena const & ) = delete;
+		scratch_arena &operator=( scratch_arena const & ) = delete;
+
+		[[nodiscard]] mark_t mark( ) const noexcept {
+			return mark_t{ m_block, m_offset };
+		}
+
+		/// Free everything allocated since mark was taken, keeping the blocks
+		void release( mark_t const &m ) noexcept {
+			m_block = m.block;
+			m_offset = m.offset;
+		}
+
+		/// The bytes held in blocks, used or not
+		[[nodiscard]] std::size_t capacity( ) const noexcept {
+			std::size_t result = 0;
+			for( auto const &blk : m_blocks ) {
+				result += blk.size;
+			}
+			return result;
+		}
+
+	private:
+		void *do_allocate( std::size_t bytes, std::size_t alignment ) override {
+			while( m_block < m_blocks.size( ) ) {
+				auto &blk = m_blocks[m_block];
+				void *ptr = blk.data.get( ) + m_offset;
+				auto space = blk.size - m_offset;
+				if( std::align( alignment, bytes, ptr, space ) ) {
+					auto const used = static_cast<std::byte *>( ptr ) - blk.data.get( );
+					m_offset = static_cast<std::size_t>( used ) + bytes;
+					return ptr;
+				}
+				++m_block;
+				m_offset = 0;
+			}
+			auto const size = std::max( m_blocks.empty( ) ? m_block_size : 2U * m_blocks.back( ).size,
+			                            bytes + alignment );
+			m_blocks.push_back( block_t{ std::make_unique<std::byte[]>( size ), size } );
+			m_block = m_blocks.size( ) - 1;
+			m_offset = 0;
+			return do_allocate( bytes, alignment );
+		}
+
+		/// Memory is given back by release
+		void do_deallocate( void *, std::size_t, std::size_t ) override {}
+
+		[[nodiscard]] bool
+		do_is_equal( std::pmr::memory_resource const &other ) const noexcept override {
+			return this == &other;
+		}
+	};
+
+	namespace impl {
+		[[nodiscard]] inline scratch_arena *&current_scratch_arena( ) noexcept {
+			thread_local scratch_arena arena{ };
+			thread_local scratch_arena *current = &arena;
+			return current;
+		}
+
+		/// The scratch memory of one algorithm call.  Everything allocated from it
+		/// is freed when it is destroyed, calls nested on the same thread free
+		/// theirs first
+		class [[nodiscard]] scratch_scope {
+			scratch_arena *m_arena;
+			scratch_arena::mark_t m_mark;
+
+		public:
+			scratch_scope( ) noexcept
+			  : m_arena( current_scratch_arena( ) )
+			  , m_mark( m_arena->mark( ) ) {}
+
+			scratch_scope( scratch_scope const & ) = delete;
+			scratch_scope &operator=( scratch_scope const & ) = delete;
+
+			~scratch_scope( ) {
+				m_arena->release( m_mark );
+			}
+
+			/// A vector of count default constructed values in the scratch memory
+			template<typename T>
+			[[nodiscard]] std::pmr::vector<T> make_vector( std::size_t count ) {
+				return std::pmr::vector<T>( count, m_arena );
+			}
+
+			/// A vector of count copies of value in the scratch memory
+			template<typename T>
+			[[nodiscard]] std::pmr::vector<T> make_vector( std::size_t count, T const &value ) {
+				return std::pmr::vector<T>( count, value, m_arena );
+			}
+
+			/// Uninitialized memory for count values in the scratch memory.  The
+			/// caller destroys any values it constructs there
+			template<typename T>
+			[[nodiscard]] T *allocate( std::size_t count ) {
+				return static_cast<T *>( m_arena->allocate( count * sizeof( T ), alignof( T ) ) );
+			}
+
+			/// An empty vector with room for count values in the scratch memory
+			template<typename T>
+			[[nodiscard]] std::pmr::vector<T> reserve_vector( std::size_t count ) {
+				auto result = std::pmr::vector<T>( m_arena );
+				result.reserve( count );
+				return result;
+			}
+		};
+	} // namespace impl
+
+	/// Make the parallel algorithms called on this thread use arena for their
+	/// bookkeeping, instead of the thread's own, until destroyed
+	class [[nodiscard]] use_scratch_arena {
+		scratch_arena *m_previous;
+
+	public:
+		explicit use_scratch_arena( scratch_arena &arena ) noexcept
+		  : m_previous( std::exchange( impl::current_scratch_arena( ), &arena ) ) {}
+
+		use_scratch_arena( use_scratch_arena const & ) = delete;
+		use_scratch_arena &operator=( use_scratch_arena const & ) = delete;
+
+		~use_scratch_arena( ) {
+			impl::current_scratch_arena( ) = m_previous;
+		}
+	};
+} // namespace daw::algorithm::parallel
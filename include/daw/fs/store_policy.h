@@ -0,0 +1,55 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if __has_include( <unistd.h> )
+#include <unistd.h>
+#endif
+
+namespace daw::algorithm::parallel {
+	/// How fill, copy and transform write their output
+	enum class store_policy : std::uint8_t {
+		/// Stream outputs larger than streaming_threshold( )
+		automatic,
+		/// Write through the cache
+		cached,
+		/// Write whole cache lines of the output around the cache, so a large
+		/// output does not evict the data in it and its lines are not read first
+		streaming
+	};
+
+	namespace impl {
+		[[nodiscard]] inline std::atomic<std::size_t> &streaming_threshold_value( ) noexcept {
+			static auto result = std::atomic<std::size_t>( [] {
+				std::size_t bytes = 32U * 1024U * 1024U;
+#if defined( _SC_LEVEL3_CACHE_SIZE )
+				if( auto const l3 = ::sysconf( _SC_LEVEL3_CACHE_SIZE ); l3 > 0 ) {
+					bytes = static_cast<std::size_t>( l3 );
+				}
+#endif
+				return bytes;
+			}( ) );
+			return result;
+		}
+	} // namespace impl
+
+	/// The output size, in bytes, above which store_policy::automatic streams.
+	/// The size of the last level cache, or 32MB when it is unknown
+	[[nodiscard]] inline std::size_t streaming_threshold( ) noexcept {
+		return impl::streaming_threshold_value( ).load( std::memory_order_relaxed );
+	}
+
+	inline void set_streaming_threshold( std::size_t bytes ) noexcept {
+		impl::streaming_threshold_value( ).store( bytes, std::memory_order_relaxed );
+	}
+} // namespace daw::algorithm::parallel
@@ -0,0 +1,182 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include "task_scheduler.h"
+
+#include <daw/daw_exception.h>
+#include <daw/daw_move.h>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace daw {
+	/// A directed acyclic graph of tasks.  Each node runs once all of the nodes
+	/// with an edge to it have finished, found by counting down an atomic count
+	/// of its predecessors, so no task blocks waiting on another.  The graph is
+	/// built once and can be run many times, but not concurrently with itself
+	class task_graph {
+	public:
+		using node_id = std::size_t;
+
+	private:
+		struct node_t {
+			std::function<void( )> func;
+			std::vector<node_id> successors{ };
+			std::size_t predecessor_count = 0;
+		};
+
+		std::vector<node_t> m_nodes{ };
+		std::unique_ptr<std::atomic<std::size_t>[]> m_counts{ };
+		std::atomic<std::size_t> m_remaining = 0;
+		std::atomic<bool> m_has_error = false;
+		std::exception_ptr m_error = nullptr;
+		bool m_is_validated = false;
+
+	public:
+		task_graph( ) = default;
+		task_graph( task_graph const & ) = delete;
+		task_graph &operator=( task_graph const & ) = delete;
+
+		/// Add a node that runs func, a callable taking no arguments
+		/// @returns the id used to add edges to the node
+		template<typename Function>
+		node_id add_node( Function &&func ) {
+			m_nodes.push_back( node_t{ std::function<void( )>( DAW_FWD( func ) ) } );
+			m_is_validated = false;
+			return m_nodes.size( ) - 1;
+		}
+
+		/// Make node `to` wait for node `from` to finish
+		void add_edge( node_id from, node_id to ) {
+			daw::exception::precondition_check( from < m_nodes.size( ) and to < m_nodes.size( ),
+			                                    "Unknown node in task_graph edge" );
+			m_nodes[from].successors.push_back( to );
+			++m_nodes[to].predecessor_count;
+			m_is_validated = false;
+		}
+
+		[[nodiscard]] std::size_t size( ) const noexcept {
+			return m_nodes.size( );
+		}
+
+		/// Run every node on ts and return once all have finished.  The calling
+		/// thread runs pending tasks while it waits.  If a node throws, the nodes
+		/// that have not started are skipped and the first exception is rethrown
+		void run( task_scheduler ts = get_task_scheduler( ) ) {
+			if( m_nodes.empty( ) ) {
+				return;
+			}
+			validate( );
+			for( std::size_t n = 0; n < m_nodes.size( ); ++n ) {
+				m_counts[n].store( m_nodes[n].predecessor_count, std::memory_order_relaxed );
+			}
+			m_error = nullptr;
+			m_has_error.store( false, std::memory_order_relaxed );
+			m_remaining.store( m_nodes.size( ), std::memory_order_release );
+
+			for( node_id id = 0; id < m_nodes.size( ); ++id ) {
+				if( m_nodes[id].predecessor_count == 0 ) {
+					schedule( ts, id );
+				}
+			}
+			while( m_remaining.load( std::memory_order_acquire ) > 0 ) {
+				if( not ts.help_run_next_task( ) ) {
+					std::this_thread::yield( );
+				}
+			}
+			if( m_error ) {
+				std::rethrow_exception( m_error );
+			}
+		}
+
+	private:
+		/// Check that the graph has no cycles, otherwise run would never finish
+		void validate( ) {
+			if( m_is_validated ) {
+				return;
+			}
+			auto counts = std::vector<std::size_t>( m_nodes.size( ) );
+			auto ready = std::vector<node_id>( );
+			for( node_id id = 0; id < m_nodes.size( ); ++id ) {
+				counts[id] = m_nodes[id].predecessor_count;
+				if( counts[id] == 0 ) {
+					ready.push_back( id );
+				}
+			}
+			std::size_t visited = 0;
+			while( not ready.empty( ) ) {
+				auto const id = ready.back( );
+				ready.pop_back( );
+				++visited;
+				for( auto next : m_nodes[id].successors ) {
+					if( --counts[next] == 0 ) {
+						ready.push_back( next );
+					}
+				}
+			}
+			daw::exception::precondition_check( visited == m_nodes.size( ),
+			                                    "A task_graph cannot have cycles" );
+			m_counts = std::make_unique<std::atomic<std::size_t>[]>( m_nodes.size( ) );
+			m_is_validated = true;
+		}
+
+		/// Run node id on ts, or on this thread when it cannot be scheduled
+		void schedule( task_scheduler &ts, node_id id ) {
+			if( not ts.add_local_task( [this, ts, id]( ) mutable { run_from( ts, id ); } ) ) {
+				run_from( ts, id );
+			}
+		}
+
+		/// Run node id, then keep going with one of the successors it made ready
+		/// on this thread and schedule the others
+		void run_from( task_scheduler &ts, node_id id ) {
+			while( true ) {
+				auto &node = m_nodes[id];
+				if( not m_has_error.load( std::memory_order_acquire ) ) {
+					try {
+						node.func( );
+					} catch( ... ) {
+						// Only the first exception is kept.  It is read by run after the
+						// last node has been counted
+						if( not m_has_error.exchange( true, std::memory_order_acq_rel ) ) {
+							m_error = std::current_exception( );
+						}
+					}
+				}
+				auto next = m_nodes.size( );
+				for( auto successor : node.successors ) {
+					if( m_counts[successor].fetch_sub( 1, std::memory_order_acq_rel ) != 1 ) {
+						continue;
+					}
+					if( next == m_nodes.size( ) ) {
+						next = successor;
+					} else {
+						schedule( ts, successor );
+					}
+				}
+				bool const has_next = next != m_nodes.size( );
+				// Once the last node is counted, run can return and the graph can be
+				// destroyed, so nothing of this is used after it unless next, which is
+				// not counted yet, keeps the graph running
+				m_remaining.fetch_sub( 1, std::memory_order_acq_rel );
+				if( not has_next ) {
+					return;
+				}
+				id = next;
+			}
+		}
+	};
+} // namespace daw
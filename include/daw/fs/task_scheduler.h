@@ -35,6 +35,7 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <exception>
 #include <list>
@@ -91,7 +92,6 @@ namespace daw {
 		std::atomic<std::size_t> m_num_threads; // from ctor
 		std::deque<task_queue_t> m_tasks;       // from ctor
 		std::atomic<std::size_t> m_task_count = std::atomic<std::size_t>( 0ULL );
-		std::atomic<std::size_t> m_current_id = std::atomic<std::size_t>( 0ULL );
 		std::atomic<bool> m_continue = false;
 		bool m_block_on_destruction; // from ctor
 
@@ -115,11 +115,16 @@ namespace daw {
 
 		[[nodiscard]] bool has_empty_queue( ) const;
 		[[nodiscard]] std::size_t size( ) const;
+		/// Is the calling thread one of this scheduler's workers
+		[[nodiscard]] bool is_worker_thread( ) const;
 
 		[[nodiscard]] auto wait_for_scope( invocable auto &&func, ts_handle_t hnd )
 		  -> decltype( DAW_FWD( func )( ) ) {
-			if( not has_empty_queue( ) ) {
-				add_queue( m_num_threads++, DAW_MOVE( hnd ) );
+			// A worker blocked in func leaves its queue unserved, so a temporary
+			// worker takes its place until func returns
+			if( is_worker_thread( ) ) {
+				auto const runner = start_temp_task_runner( DAW_MOVE( hnd ) );
+				return DAW_FWD( func )( );
 			}
 			return DAW_FWD( func )( );
 		}
@@ -133,6 +138,7 @@ namespace daw {
 		[[nodiscard]] bool send_task( unique_task_t tsk, std::size_t id );
 		void run_task( unique_task_t tsk ) noexcept;
 		[[nodiscard]] std::size_t get_task_id( );
+		[[nodiscard]] std::size_t get_local_task_id( );
 		[[nodiscard]] bool run_next_task( std::size_t id );
 
 		struct temp_task_runner {
@@ -203,6 +209,7 @@ namespace daw {
 		void run_task( unique_task_t tsk ) noexcept;
 
 		[[nodiscard]] std::size_t get_task_id( );
+		[[nodiscard]] std::size_t get_local_task_id( );
 
 	public:
 		inline explicit task_scheduler( std::shared_ptr<ts_t> ts )
@@ -222,8 +229,22 @@ namespace daw {
 			return add_task( DAW_FWD( task ), DAW_MOVE( sem ), get_task_id( ) );
 		}
 
+		/// Add a task to the queue of the calling worker thread so that it runs
+		/// with a warm cache.  When not called from one of this scheduler's
+		/// workers it is the same as add_task
+		[[nodiscard]] bool add_local_task( invocable auto &&task ) {
+			return add_task( DAW_FWD( task ), get_local_task_id( ) );
+		}
+
 		[[nodiscard]] bool run_next_task( std::size_t id );
 
+		/// Run a pending task on the calling thread instead of blocking, starting
+		/// with its own queue when it is one of this scheduler's workers
+		/// @returns false if there were no tasks to run
+		[[nodiscard]] bool help_run_next_task( ) {
+			return run_next_task( get_local_task_id( ) );
+		}
+
 		void start( );
 		void stop( bool block = true ) noexcept;
 
@@ -257,7 +278,7 @@ namespace daw {
 	public:
 		[[nodiscard]] auto wait_for_scope( invocable auto &&func ) -> decltype( DAW_FWD( func )( ) ) {
 			assert( m_ts_impl );
-			m_ts_impl->wait_for_scope( DAW_FWD( func ), get_handle( ) );
+			return m_ts_impl->wait_for_scope( DAW_FWD( func ), get_handle( ) );
 		}
 
 		template<Waitable Waitable>
@@ -279,6 +300,50 @@ namespace daw {
 
 	task_scheduler get_task_scheduler( );
 
+	/// Where a continuation runs once the value it waits on is available
+	enum class continuation_policy : uint8_t {
+		scheduled,   // Add to the task scheduler like any other task
+		same_worker, // Add to the queue of the worker that completed the value
+		run_inline   // Run on the thread that completed the value
+	};
+
+	/// The number of continuations that can be nested inline on a thread before
+	/// further ones are scheduled.  This bounds the stack used by inline chains
+	inline constexpr std::size_t max_inline_continuation_depth = 64;
+
+	namespace impl {
+		[[nodiscard]] inline std::size_t &inline_continuation_depth( ) noexcept {
+			thread_local std::size_t depth = 0;
+			return depth;
+		}
+	} // namespace impl
+
+	/// Run a continuation task as requested by policy
+	///
+	/// @param policy where to run task
+	/// @param task Task of form void( ) to run
+	/// @param ts task_scheduler to add task to when it is not run inline
+	/// @returns false if the task could not be added to the task scheduler
+	[[nodiscard]] bool
+	schedule_continuation( continuation_policy policy, invocable auto &&task, task_scheduler &ts ) {
+		switch( policy ) {
+		case continuation_policy::run_inline:
+			if( auto &depth = impl::inline_continuation_depth( );
+			    depth < max_inline_continuation_depth ) {
+				++depth;
+				auto const ae = on_scope_exit( [&depth]( ) { --depth; } );
+				(void)DAW_FWD( task )( );
+				return true;
+			}
+			break;
+		case continuation_policy::same_worker:
+			return ts.add_local_task( DAW_FWD( task ) );
+		case continuation_policy::scheduled:
+			break;
+		}
+		return ts.add_task( DAW_FWD( task ) );
+	}
+
 	/// Add a single task to the supplied task scheduler and notify supplied
 	/// semaphore when complete
 	///
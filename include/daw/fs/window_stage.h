@@ -0,0 +1,560 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#pragma once
+
+#include "impl/daw_function.h"
+#include "impl/stream_pipeline_impl.h"
+#include "task_scheduler.h"
+
+#include <daw/daw_exception.h>
+#include <daw/daw_move.h>
+#include <daw/daw_traits.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace daw {
+	/// The aggregate of the items of one key with a time in [start, end)
+	template<typename Key, typename Time, typename Value>
+	struct window_result {
+		Key key;
+		Time start;
+		Time end;
+		Value value;
+	};
+
+	struct window_options {
+		/// Independently aggregated parts of the keys, each updated by one task at
+		/// a time.  0 uses one per thread of the task_scheduler
+		std::size_t shard_count = 0;
+		/// Items a shard collects before a task adds them to its aggregates
+		std::size_t batch_size = 256;
+	};
+
+	namespace impl {
+		[[nodiscard]] constexpr std::uint64_t window_mix( std::uint64_t x ) noexcept {
+			x ^= x >> 29U;
+			x *= 0xbf58'476d'1ce4'e5b9ULL;
+			x ^= x >> 32U;
+			return x;
+		}
+
+		/// The aggregate of each key and window start.  Entries are stored inline
+		/// and probed linearly, so an update touches one or two cache lines
+		/// instead of following the nodes of a std::unordered_map
+		template<typename Key, typename Time, typename Value>
+		class window_table_t {
+			struct entry_t {
+				std::uint64_t hash;
+				Key key;
+				Time start;
+				Value value;
+			};
+
+			std::vector<std::optional<entry_t>> m_slots = std::vector<std::optional<entry_t>>( 16 );
+			std::size_t m_size = 0;
+
+			[[nodiscard]] std::size_t slot_for( std::uint64_t hash ) const {
+				return static_cast<std::size_t>( hash ) & ( m_slots.size( ) - 1 );
+			}
+
+			/// Add an entry known not to be in the table
+			Value &insert( entry_t &&entry ) {
+				auto pos = slot_for( entry.hash );
+				while( m_slots[pos] ) {
+					pos = ( pos + 1 ) & ( m_slots.size( ) - 1 );
+				}
+				++m_size;
+				return m_slots[pos].emplace( DAW_MOVE( entry ) ).value;
+			}
+
+			void rebuild( std::size_t capacity ) {
+				auto old = std::exchange( m_slots, std::vector<std::optional<entry_t>>( capacity ) );
+				m_size = 0;
+				for( auto &slot : old ) {
+					if( slot ) {
+						(void)insert( DAW_MOVE( *slot ) );
+					}
+				}
+			}
+
+		public:
+			[[nodiscard]] std::size_t size( ) const {
+				return m_size;
+			}
+
+			/// The aggregate of key in the window at start, a copy of init when new.
+			/// hash is a well mixed hash of both
+			[[nodiscard]] Value &
+			find_or_add( std::uint64_t hash, Key const &key, Time const &start, Value const &init ) {
+				// Keep the table at most 3/4 full so probes stay short
+				if( 4U * ( m_size + 1U ) > 3U * m_slots.size( ) ) {
+					rebuild( 2U * m_slots.size( ) );
+				}
+				auto pos = slot_for( hash );
+				while( auto &slot = m_slots[pos] ) {
+					if( slot->hash == hash and slot->start == start and slot->key == key ) {
+						return slot->value;
+					}
+					pos = ( pos + 1 ) & ( m_slots.size( ) - 1 );
+				}
+				return insert( entry_t{ hash, key, start, init } );
+			}
+
+			/// Move the aggregates of the windows ending at or before horizon to out
+			void extract_until( Time const &horizon,
+			                    Time const &size,
+			                    std::vector<window_result<Key, Time, Value>> &out ) {
+				auto old = std::exchange( m_slots, std::vector<std::optional<entry_t>>( m_slots.size( ) ) );
+				m_size = 0;
+				for( auto &slot : old ) {
+					if( not slot ) {
+						continue;
+					}
+					if( slot->start + size <= horizon ) {
+						out.push_back( window_result<Key, Time, Value>{
+						  DAW_MOVE( slot->key ), slot->start, slot->start + size, DAW_MOVE( slot->value ) } );
+					} else {
+						(void)insert( DAW_MOVE( *slot ) );
+					}
+				}
+			}
+		};
+
+		template<typename Function, typename Input>
+		using window_time_t = daw::remove_cvref_t<std::invoke_result_t<Function &, Input const &>>;
+
+		/// Window starts are times rounded down to a multiple of the slide by
+		/// integer division
+		template<typename Time>
+		inline constexpr bool is_window_time_v = std::is_integral_v<Time>;
+
+		template<typename Rep, typename Period>
+		inline constexpr bool is_window_time_v<std::chrono::duration<Rep, Period>> =
+		  std::is_integral_v<Rep>;
+
+		/// State shared by the copies of a window stage.  Calls, made one at a
+		/// time, find the key and windows of each item and queue it on the shard
+		/// of its key.  A task per shard adds the queued items to its aggregates
+		/// so the keys are aggregated in parallel.  Once the latest time seen
+		/// passes the end of a window, every shard closes it and the aggregates
+		/// are returned by the call that passed it
+		template<typename Input,
+		         typename KeyFunction,
+		         typename TimeFunction,
+		         typename Value,
+		         typename Accumulate>
+		class window_state_t : public std::enable_shared_from_this<
+		                         window_state_t<Input, KeyFunction, TimeFunction, Value, Accumulate>> {
+		public:
+			using key_t = daw::remove_cvref_t<std::invoke_result_t<KeyFunction const &, Input const &>>;
+			using timestamp_t = window_time_t<TimeFunction const, Input>;
+			using result_t = window_result<key_t, timestamp_t, Value>;
+			static_assert( is_window_time_v<timestamp_t>,
+			               "The time of an item must be an integer or a std::chrono::duration "
+			               "with an integer representation" );
+
+		private:
+			struct pending_t {
+				std::uint64_t hash;
+				key_t key;
+				/// The latest window of the item and how many before it it is in
+				timestamp_t start;
+				std::size_t window_count;
+				Input item;
+			};
+
+			struct shard_t {
+				std::mutex mut{ };
+				std::vector<pending_t> pending{ };
+				bool is_running = false;
+				// Only used by the task running for the shard
+				window_table_t<key_t, timestamp_t, Value> table{ };
+				std::vector<result_t> closed{ };
+			};
+
+			KeyFunction m_key;
+			TimeFunction m_time;
+			Value m_init;
+			Accumulate m_accumulate;
+			timestamp_t m_size;
+			timestamp_t m_slide;
+			std::size_t m_batch_size;
+			task_scheduler m_ts;
+			std::size_t m_shard_count;
+			std::unique_ptr<shard_t[]> m_shards;
+			std::atomic<std::size_t> m_busy = 0;
+			std::atomic<bool> m_is_calling = false;
+			std::atomic<std::size_t> m_late_count = 0;
+			std::atomic<bool> m_has_error = false;
+			std::exception_ptr m_error = nullptr;
+			timestamp_t m_watermark{ };
+			timestamp_t m_closed_until{ };
+
+		public:
+			template<typename K, typename T, typename A>
+			window_state_t( K &&key,
+			                T &&time,
+			                timestamp_t size,
+			                timestamp_t slide,
+			                Value init,
+			                A &&accumulate,
+			                window_options const &opts,
+			                task_scheduler ts )
+			  : m_key( DAW_FWD( key ) )
+			  , m_time( DAW_FWD( time ) )
+			  , m_init( DAW_MOVE( init ) )
+			  , m_accumulate( DAW_FWD( accumulate ) )
+			  , m_size( size )
+			  , m_slide( slide )
+			  , m_batch_size( std::max<std::size_t>( opts.batch_size, 1 ) )
+			  , m_ts( DAW_MOVE( ts ) )
+			  , m_shard_count( opts.shard_count > 0 ? opts.shard_count
+			                                        : std::max<std::size_t>( m_ts.size( ), 1 ) )
+			  , m_shards( std::make_unique<shard_t[]>( m_shard_count ) ) {
+
+				daw::exception::precondition_check( timestamp_t{ } < slide and not( size < slide ),
+				                                    "A window must be at least as long as its slide" );
+			}
+
+			/// Add item to its windows
+			/// @returns the aggregates of the windows this closed, usually none
+			[[nodiscard]] std::vector<result_t> add( Input &&item ) {
+				auto const guard = call_guard( *this );
+				auto const t = std::invoke( m_time, std::as_const( item ) );
+				if( m_watermark < t ) {
+					m_watermark = t;
+				}
+				queue( t, DAW_MOVE( item ) );
+				if( m_watermark < next_close( ) ) {
+					return { };
+				}
+				return close( m_watermark );
+			}
+
+			/// Close every window and start over for a new stream
+			/// @returns the aggregates of the windows that were open
+			[[nodiscard]] std::vector<result_t> flush( ) {
+				auto const guard = call_guard( *this );
+				// Every window holding an item ends by the latest time plus its length
+				auto result = close( m_watermark + m_size );
+				m_watermark = timestamp_t{ };
+				m_closed_until = timestamp_t{ };
+				return result;
+			}
+
+			/// The number of items dropped because all of their windows had closed
+			[[nodiscard]] std::size_t late_count( ) const {
+				return m_late_count.load( std::memory_order_relaxed );
+			}
+
+		private:
+			/// Calls must be made one at a time, as function_stream::run does
+			class call_guard {
+				window_state_t *m_self;
+
+			public:
+				explicit call_guard( window_state_t &self )
+				  : m_self( &self ) {
+					daw::exception::precondition_check(
+					  not m_self->m_is_calling.exchange( true, std::memory_order_acquire ),
+					  "A window stage cannot be called concurrently" );
+				}
+
+				call_guard( call_guard const & ) = delete;
+				call_guard &operator=( call_guard const & ) = delete;
+
+				~call_guard( ) {
+					m_self->m_is_calling.store( false, std::memory_order_release );
+				}
+			};
+
+			/// The earliest end of a window that is still open
+			[[nodiscard]] timestamp_t next_close( ) const {
+				if( m_closed_until < m_size ) {
+					return m_size;
+				}
+				return m_slide * ( ( m_closed_until - m_size ) / m_slide + 1 ) + m_size;
+			}
+
+			void queue( timestamp_t const &t, Input &&item ) {
+				// Windows start at multiples of the slide.  Count those holding t
+				// from the latest back, stopping at the first that has closed
+				auto const latest = m_slide * ( t / m_slide );
+				auto const bound = std::max( t, m_closed_until );
+				std::size_t window_count = 0;
+				for( auto start = latest; bound < start + m_size; start -= m_slide ) {
+					++window_count;
+					if( start < m_slide ) {
+						break;
+					}
+				}
+				if( window_count == 0 ) {
+					m_late_count.fetch_add( 1, std::memory_order_relaxed );
+					return;
+				}
+				auto key = std::invoke( m_key, std::as_const( item ) );
+				auto const hash = static_cast<std::uint64_t>( std::hash<key_t>{ }( key ) );
+				auto &shard = m_shards[static_cast<std::size_t>( hash % m_shard_count )];
+				bool start_task = false;
+				{
+					auto const lck = std::lock_guard( shard.mut );
+					shard.pending.push_back(
+					  pending_t{ hash, DAW_MOVE( key ), latest, window_count, DAW_MOVE( item ) } );
+					if( shard.pending.size( ) >= m_batch_size and not shard.is_running ) {
+						shard.is_running = true;
+						start_task = true;
+					}
+				}
+				if( start_task ) {
+					start_shard( shard, std::nullopt );
+				}
+			}
+
+			/// Close the windows ending at or before horizon in every shard
+			[[nodiscard]] std::vector<result_t> close( timestamp_t const &horizon ) {
+				wait_for_shards( );
+				for( std::size_t n = 0; n < m_shard_count; ++n ) {
+					auto &shard = m_shards[n];
+					{
+						auto const lck = std::lock_guard( shard.mut );
+						if( shard.pending.empty( ) and shard.table.size( ) == 0 ) {
+							continue;
+						}
+						shard.is_running = true;
+					}
+					start_shard( shard, horizon );
+				}
+				wait_for_shards( );
+				m_closed_until = horizon;
+				auto result = std::vector<result_t>( );
+				for( std::size_t n = 0; n < m_shard_count; ++n ) {
+					auto &closed = m_shards[n].closed;
+					std::move( closed.begin( ), closed.end( ), std::back_inserter( result ) );
+					closed.clear( );
+				}
+				std::stable_sort( result.begin( ), result.end( ), []( auto const &lhs, auto const &rhs ) {
+					return lhs.start < rhs.start;
+				} );
+				return result;
+			}
+
+			/// Run pending tasks until no shard task is running and rethrow the
+			/// first exception one of them threw
+			void wait_for_shards( ) {
+				while( m_busy.load( std::memory_order_acquire ) > 0 ) {
+					if( not m_ts.help_run_next_task( ) ) {
+						std::this_thread::yield( );
+					}
+				}
+				if( m_has_error.load( std::memory_order_acquire ) ) {
+					m_has_error.store( false, std::memory_order_relaxed );
+					std::rethrow_exception( std::exchange( m_error, nullptr ) );
+				}
+			}
+
+			/// Run shard's task on the scheduler, or on this thread when it cannot
+			/// be scheduled
+			void start_shard( shard_t &shard, std::optional<timestamp_t> horizon ) {
+				m_busy.fetch_add( 1, std::memory_order_acq_rel );
+				if( not m_ts.add_task( [self = this->shared_from_this( ), &shard, horizon]( ) {
+					    self->run_shard( shard, horizon );
+				    } ) ) {
+					run_shard( shard, horizon );
+				}
+			}
+
+			/// Add the items queued on shard to its aggregates until none are left,
+			/// then close the windows ending at or before horizon
+			void run_shard( shard_t &shard, std::optional<timestamp_t> const &horizon ) {
+				try {
+					auto batch = std::vector<pending_t>( );
+					while( true ) {
+						batch.clear( );
+						{
+							auto const lck = std::lock_guard( shard.mut );
+							std::swap( batch, shard.pending );
+							if( batch.empty( ) ) {
+								shard.is_running = false;
+								break;
+							}
+						}
+						for( auto &p : batch ) {
+							auto start = p.start;
+							for( std::size_t n = 0; n < p.window_count; ++n, start -= m_slide ) {
+								auto const hash =
+								  window_mix( p.hash + static_cast<std::uint64_t>( start / m_slide ) );
+								std::invoke( m_accumulate,
+								             shard.table.find_or_add( hash, p.key, start, m_init ),
+								             std::as_const( p.item ) );
+							}
+						}
+					}
+					if( horizon ) {
+						shard.table.extract_until( *horizon, m_size, shard.closed );
+					}
+				} catch( ... ) {
+					{
+						auto const lck = std::lock_guard( shard.mut );
+						shard.pending.clear( );
+						shard.is_running = false;
+					}
+					// Only the first exception is kept, it is read once every shard
+					// task has finished
+					if( not m_has_error.exchange( true, std::memory_order_acq_rel ) ) {
+						m_error = std::current_exception( );
+					}
+				}
+				m_busy.fetch_sub( 1, std::memory_order_acq_rel );
+			}
+		};
+
+		/// A stage of function_stream::run aggregating its input by key over
+		/// windows of time.  Copies share their windows
+		template<typename Input,
+		         typename KeyFunction,
+		         typename TimeFunction,
+		         typename Value,
+		         typename Accumulate>
+		class window_stage_t {
+			using state_t = window_state_t<Input, KeyFunction, TimeFunction, Value, Accumulate>;
+
+			std::shared_ptr<state_t> m_state;
+
+		public:
+			using result_t = typename state_t::result_t;
+
+			explicit window_stage_t( std::shared_ptr<state_t> state )
+			  : m_state( DAW_MOVE( state ) ) {}
+
+			/// Add item to its windows
+			/// @returns the aggregates of the windows this closed, usually none
+			[[nodiscard]] std::vector<result_t> operator( )( Input item ) const {
+				return m_state->add( DAW_MOVE( item ) );
+			}
+
+			/// Close every window and start over for a new stream.  function_stream::run
+			/// does this when its input ends
+			/// @returns the aggregates of the windows that were open
+			[[nodiscard]] std::vector<result_t> flush( ) const {
+				return m_state->flush( );
+			}
+
+			/// The number of items dropped because all of their windows had closed
+			[[nodiscard]] std::size_t late_count( ) const {
+				return m_state->late_count( );
+			}
+		};
+
+		template<typename Input,
+		         typename KeyFunction,
+		         typename TimeFunction,
+		         typename Value,
+		         typename Accumulate>
+		[[nodiscard]] auto make_window_stage( KeyFunction &&key,
+		                                      TimeFunction &&time,
+		                                      window_time_t<TimeFunction, Input> size,
+		                                      window_time_t<TimeFunction, Input> slide,
+		                                      Value init,
+		                                      Accumulate &&accumulate,
+		                                      window_options const &opts ) {
+			using key_func_t = daw::remove_cvref_t<decltype( fs::impl::make_callable( DAW_FWD( key ) ) )>;
+			using time_func_t =
+			  daw::remove_cvref_t<decltype( fs::impl::make_callable( DAW_FWD( time ) ) )>;
+			using accumulate_t =
+			  daw::remove_cvref_t<decltype( fs::impl::make_callable( DAW_FWD( accumulate ) ) )>;
+			using stage_t = window_stage_t<Input, key_func_t, time_func_t, Value, accumulate_t>;
+			using state_t = window_state_t<Input, key_func_t, time_func_t, Value, accumulate_t>;
+
+			return stage_t( std::make_shared<state_t>( fs::impl::make_callable( DAW_FWD( key ) ),
+			                                           fs::impl::make_callable( DAW_FWD( time ) ),
+			                                           size,
+			                                           slide,
+			                                           DAW_MOVE( init ),
+			                                           fs::impl::make_callable( DAW_FWD( accumulate ) ),
+			                                           opts,
+			                                           get_task_scheduler( ) ) );
+		}
+	} // namespace impl
+
+	template<typename Input,
+	         typename KeyFunction,
+	         typename TimeFunction,
+	         typename Value,
+	         typename Accumulate>
+	inline constexpr bool
+	  is_window_stage_v<impl::window_stage_t<Input, KeyFunction, TimeFunction, Value, Accumulate>> =
+	    true;
+
+	/// A stage aggregating each key of its Input over consecutive windows of
+	/// size.  key( item ) and time( item ) give the key and time of an item,
+	/// times must not be negative and are integers or std::chrono::durations
+	/// with an integer representation, as window starts are rounded down by
+	/// integer division.  accumulate( value, item ) adds it to the
+	/// aggregate of its key and window, which starts as a copy of init.  Once an
+	/// item with a time at or after the end of a window is seen the window
+	/// closes.  Its aggregates are passed on as a std::vector of
+	/// window_result, later items falling in it are dropped.  In
+	/// function_stream::run the windows still open when the input ends are
+	/// passed on last
+	template<typename Input,
+	         typename KeyFunction,
+	         typename TimeFunction,
+	         typename Value,
+	         typename Accumulate>
+	[[nodiscard]] auto tumbling_window( KeyFunction &&key,
+	                                    TimeFunction &&time,
+	                                    impl::window_time_t<TimeFunction, Input> size,
+	                                    Value init,
+	                                    Accumulate &&accumulate,
+	                                    window_options const &opts = window_options{ } ) {
+		return impl::make_window_stage<Input>( DAW_FWD( key ),
+		                                       DAW_FWD( time ),
+		                                       size,
+		                                       size,
+		                                       DAW_MOVE( init ),
+		                                       DAW_FWD( accumulate ),
+		                                       opts );
+	}
+
+	/// As tumbling_window, but a window of size starts every slide so an item
+	/// is in each of the windows overlapping its time
+	template<typename Input,
+	         typename KeyFunction,
+	         typename TimeFunction,
+	         typename Value,
+	         typename Accumulate>
+	[[nodiscard]] auto sliding_window( KeyFunction &&key,
+	                                   TimeFunction &&time,
+	                                   impl::window_time_t<TimeFunction, Input> size,
+	                                   impl::window_time_t<TimeFunction, Input> slide,
+	                                   Value init,
+	                                   Accumulate &&accumulate,
+	                                   window_options const &opts = window_options{ } ) {
+		return impl::make_window_stage<Input>( DAW_FWD( key ),
+		                                       DAW_FWD( time ),
+		                                       size,
+		                                       slide,
+		                                       DAW_MOVE( init ),
+		                                       DAW_FWD( accumulate ),
+		                                       opts );
+	}
+} // namespace daw
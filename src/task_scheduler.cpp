@@ -30,6 +30,22 @@
 #include <thread>
 
 namespace daw {
+	namespace {
+		/// The scheduler and queue id of the worker running on this thread
+		struct current_worker_t {
+			fixed_task_scheduler const *ts = nullptr;
+			std::size_t id = 0;
+		};
+
+		thread_local current_worker_t current_worker = current_worker_t{ };
+
+		[[nodiscard]] auto set_current_worker( fixed_task_scheduler const *ts, std::size_t id ) {
+			auto const old = current_worker;
+			current_worker = current_worker_t{ ts, id };
+			return on_scope_exit( [old]( ) { current_worker = old; } );
+		}
+	} // namespace
+
 	task_scheduler get_task_scheduler( ) {
 		static auto ts = []( ) {
 			auto result = task_scheduler( );
@@ -202,7 +218,9 @@ namespace daw {
 
 	void fixed_task_scheduler::run_task( unique_task_t tsk ) noexcept {
 		try {
-			if( not started( ) ) {
+			// An empty task is what a runner gets when told to stop, it has no latch
+			// to wait on and would be sent around the queues forever
+			if( not started( ) or tsk.empty( ) ) {
 				return;
 			}
 			if( tsk.try_wait( ) ) {
@@ -223,6 +241,17 @@ namespace daw {
 		return tc % m_num_threads;
 	}
 
+	bool fixed_task_scheduler::is_worker_thread( ) const {
+		return current_worker.ts == this;
+	}
+
+	size_t fixed_task_scheduler::get_local_task_id( ) {
+		if( current_worker.ts == this and current_worker.id < m_tasks.size( ) ) {
+			return current_worker.id;
+		}
+		return get_task_id( );
+	}
+
 	unique_task_t task_scheduler::wait_for_task_from_pool( std::size_t id ) {
 		assert( m_ts_impl );
 		return m_ts_impl->wait_for_task_from_pool( id );
@@ -243,6 +272,11 @@ namespace daw {
 		return m_ts_impl->get_task_id( );
 	}
 
+	size_t task_scheduler::get_local_task_id( ) {
+		assert( m_ts_impl );
+		return m_ts_impl->get_local_task_id( );
+	}
+
 	bool fixed_task_scheduler::run_next_task( std::size_t id ) {
 		if( auto tsk = m_tasks[id].try_pop_front( ); tsk ) {
 			run_task( DAW_MOVE( *tsk ) );
@@ -275,7 +309,7 @@ namespace daw {
 		m_continue = true;
 		// assert( m_ts_impl->m_tasks.size( ) == m_ts_impl->m_num_threads );
 		for( std::size_t n = 0; n < m_num_threads; ++n ) {
-			add_queue( n, DAW_MOVE( hnd ) );
+			add_queue( n, hnd );
 		}
 	}
 
@@ -309,7 +343,8 @@ namespace daw {
 			}
 		};
 		// *****
-		size_t const id = m_current_id++;
+		// Serve the queue of the worker it stands in for
+		size_t const id = get_local_task_id( );
 
 		return { create_thread( tmp_worker{ id, wself, sem } ), sem };
 	}
@@ -345,6 +380,7 @@ namespace daw {
 
 	void task_scheduler::task_runner( std::size_t id ) {
 		assert( m_ts_impl );
+		auto const worker = set_current_worker( m_ts_impl.get( ), id );
 		auto w_self = get_handle( );
 		while( true ) {
 			auto tsk = unique_task_t( );
@@ -361,12 +397,13 @@ namespace daw {
 
 	void task_scheduler::task_runner( std::size_t id, shared_cnt_sem &sem ) {
 		assert( m_ts_impl );
+		auto const worker = set_current_worker( m_ts_impl.get( ), id );
 		auto w_self = get_handle( );
 		while( not sem.try_wait( ) ) {
 			auto tsk = unique_task_t( );
 			{
 				auto self = w_self.lock( );
-				if( not self or not self->started( ) or not sem.try_wait( ) ) {
+				if( not self or not self->started( ) or sem.try_wait( ) ) {
 					return;
 				}
 				tsk = self->wait_for_task_from_pool( id, sem );
@@ -24,7 +24,10 @@
 
 #include "display_info.h"
 
+#include "daw/fs/task_scheduler.h"
+
 #include <daw/daw_benchmark.h>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
 
@@ -58,6 +61,30 @@ namespace {
 		          << " std_dev=" << daw::utility::format_seconds( std_dev ) << '\n';
 	}
 
+	/// A xorshift generator with a fixed seed, so a test sees the same values
+	/// on every run
+	class [[maybe_unused]] test_random_t {
+		std::uint64_t m_state = 88'172'645'463'325'252ULL;
+
+	public:
+		[[nodiscard]] std::uint64_t operator( )( ) noexcept {
+			m_state ^= m_state << 13U;
+			m_state ^= m_state >> 7U;
+			m_state ^= m_state << 17U;
+			return m_state;
+		}
+	};
+
+	/// Call func( ts ) with the default task_scheduler, and with one that has
+	/// more workers than this machine may have cores so ranges are split into
+	/// more parts
+	template<typename Function>
+	[[maybe_unused]] void for_each_test_scheduler( Function &&func ) {
+		for( auto const &ts : { daw::get_task_scheduler( ), daw::task_scheduler( 7 ) } ) {
+			func( ts );
+		}
+	}
+
 	// static constexpr size_t const MAX_ITEMS = 134'217'728;
 	// static constexpr size_t const LARGE_TEST_SZ = 268'435'456;
 
@@ -0,0 +1,108 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/aggregators.h"
+#include "daw/fs/algorithms.h"
+
+#include "common.h"
+
+#include <daw/daw_benchmark.h>
+#include <daw/daw_random.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace {
+	namespace agg = daw::algorithm::parallel::aggregators;
+
+	void aggregate_test_001( daw::task_scheduler ts ) {
+		for( std::size_t const size : { 1U, 100U, 100'003U } ) {
+			auto const values = daw::make_random_data<std::int64_t>( size, -1'000, 1'000 );
+			auto const [count, sum, min, max, mv] = daw::algorithm::parallel::aggregate(
+			  values.begin( ), values.end( ), ts, agg::count{ }, agg::sum{ }, agg::min{ }, agg::max{ },
+			  agg::mean_var{ } );
+
+			auto const expected_sum =
+			  std::accumulate( values.begin( ), values.end( ), std::int64_t{ 0 } );
+			daw::expecting( values.size( ), count );
+			daw::expecting( expected_sum, sum );
+			daw::expecting( *std::min_element( values.begin( ), values.end( ) ), *min );
+			daw::expecting( *std::max_element( values.begin( ), values.end( ) ), *max );
+
+			auto const mean = static_cast<double>( expected_sum ) / static_cast<double>( size );
+			auto sq = 0.0;
+			for( auto v : values ) {
+				sq += ( static_cast<double>( v ) - mean ) * ( static_cast<double>( v ) - mean );
+			}
+			auto const variance = sq / static_cast<double>( size );
+			daw::expecting( size, mv.count );
+			daw::expecting( std::abs( mean - mv.mean ) < 1e-9 );
+			daw::expecting( std::abs( variance - mv.variance ) < 1e-6 * std::max( 1.0, variance ) );
+		}
+	}
+
+	void aggregate_test_002( daw::task_scheduler ts ) {
+		// Nothing to aggregate
+		auto const values = std::vector<std::int32_t>( );
+		auto const [count, min, mv] = daw::algorithm::parallel::aggregate(
+		  values.begin( ), values.end( ), ts, agg::count{ }, agg::min{ }, agg::mean_var{ } );
+		daw::expecting( std::size_t{ 0 }, count );
+		daw::expecting( not min );
+		daw::expecting( std::size_t{ 0 }, mv.count );
+
+		// A wider sum than the items, and a comparison of our own
+		auto const bytes = std::vector<std::uint8_t>( 100'003, 200 );
+		auto const [wide, least] = daw::algorithm::parallel::aggregate(
+		  bytes.begin( ), bytes.end( ), agg::sum<std::uint64_t>{ }, agg::min{ std::greater<>{ } } );
+		daw::expecting( std::uint64_t{ 200 } * 100'003U, wide );
+		daw::expecting( std::uint8_t{ 200 }, *least );
+	}
+
+	void aggregate_bench( std::size_t size ) {
+		auto const values = daw::make_random_data<std::int64_t>( size, -1'000, 1'000 );
+		std::int64_t par_sum = 0;
+		std::int64_t seq_sum = 0;
+		auto const par_time = daw::benchmark( [&]( ) {
+			auto const [sum, min, max, count] = daw::algorithm::parallel::aggregate(
+			  values.begin( ), values.end( ), agg::sum{ }, agg::min{ }, agg::max{ }, agg::count{ } );
+			par_sum = sum + *min + *max + static_cast<std::int64_t>( count );
+			daw::do_not_optimize( par_sum );
+		} );
+		// The four passes it replaces
+		auto const seq_time = daw::benchmark( [&]( ) {
+			auto const sum =
+			  daw::algorithm::parallel::reduce( values.begin( ), values.end( ), std::int64_t{ 0 } );
+			auto const min = *daw::algorithm::parallel::min_element( values.begin( ), values.end( ) );
+			auto const max = *daw::algorithm::parallel::max_element( values.begin( ), values.end( ) );
+			auto const count = daw::algorithm::parallel::count_if(
+			  values.begin( ), values.end( ), []( std::int64_t ) { return true; } );
+			seq_sum = sum + min + max + static_cast<std::int64_t>( count );
+			daw::do_not_optimize( seq_sum );
+		} );
+		daw::expecting( seq_sum, par_sum );
+		display_info( seq_time, par_time, size, sizeof( std::int64_t ), "aggregate vs 4 passes" );
+	}
+} // namespace
+
+int main( ) {
+	for_each_test_scheduler( []( daw::task_scheduler ts ) {
+		aggregate_test_001( ts );
+		aggregate_test_002( ts );
+	} );
+
+	std::cout << "aggregate tests - int64_t, sum, min, max and count\n";
+	aggregate_bench( LARGE_TEST_SZ );
+	for( std::size_t n = MAX_ITEMS; n >= 100; n /= 10 ) {
+		aggregate_bench( n );
+	}
+}
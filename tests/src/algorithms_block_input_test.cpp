@@ -0,0 +1,151 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/algorithms.h"
+
+#include "common.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <forward_list>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+	namespace par = daw::algorithm::parallel;
+
+	void block_input_test_001( daw::task_scheduler ts ) {
+		// Sizes around the block size, forward and bidirectional iterators
+		for( std::size_t const size : { 0U, 1U, 1'023U, 1'024U, 1'025U, 100'003U } ) {
+			auto values = std::list<std::int64_t>( size );
+			std::iota( values.begin( ), values.end( ), std::int64_t{ 0 } );
+			auto const expected = std::accumulate( values.begin( ), values.end( ), std::int64_t{ 0 } );
+
+			daw::expecting(
+			  expected + 3,
+			  par::reduce( values.begin( ), values.end( ), std::int64_t{ 3 }, std::plus<>{ }, ts ) );
+			daw::expecting( expected + 3,
+			                par::reduce( values.begin( ), values.end( ), std::int64_t{ 3 }, ts ) );
+			daw::expecting( expected, par::reduce( values.begin( ), values.end( ), std::int64_t{ 0 } ) );
+
+			auto const even = []( std::int64_t v ) { return v % 2 == 0; };
+			daw::expecting(
+			  static_cast<std::size_t>( std::count_if( values.begin( ), values.end( ), even ) ),
+			  par::count_if( values.begin( ), values.end( ), even, ts ) );
+
+			std::atomic<std::int64_t> seen = 0;
+			par::for_each( values.begin( ), values.end( ), [&]( std::int64_t v ) { seen += v; }, ts );
+			daw::expecting( expected, seen.load( ) );
+
+			auto const singly = std::forward_list<std::int64_t>( values.begin( ), values.end( ) );
+			daw::expecting( size > 0 ? 1U : 0U, par::count( singly.begin( ), singly.end( ), 0, ts ) );
+		}
+
+		auto names = std::unordered_map<int, std::string>( );
+		for( int n = 0; n < 10'007; ++n ) {
+			names[n] = std::to_string( n );
+		}
+		std::atomic<std::size_t> total_length = 0;
+		par::for_each(
+		  names.begin( ),
+		  names.end( ),
+		  [&]( auto const &item ) { total_length += item.second.size( ); },
+		  ts );
+		std::size_t expected_length = 0;
+		for( auto const &item : names ) {
+			expected_length += item.second.size( );
+		}
+		daw::expecting( expected_length, total_length.load( ) );
+	}
+
+	void block_input_test_002( daw::task_scheduler ts ) {
+		// Single pass input iterators are buffered
+		auto text = std::string( );
+		for( int n = 0; n < 10'007; ++n ) {
+			text += std::to_string( n ) + ' ';
+		}
+		{
+			auto in = std::istringstream( text );
+			auto const sum = par::reduce( std::istream_iterator<std::int64_t>( in ),
+			                              std::istream_iterator<std::int64_t>( ),
+			                              std::int64_t{ 0 },
+			                              std::plus<>{ },
+			                              ts );
+			daw::expecting( std::int64_t{ 10'006 } * 10'007 / 2, sum );
+		}
+		{
+			// A non commutative reduction keeps the order of the blocks
+			auto in = std::istringstream( text );
+			auto const last_seen = par::reduce(
+			  std::istream_iterator<int>( in ),
+			  std::istream_iterator<int>( ),
+			  -1,
+			  []( int, int rhs ) { return rhs; },
+			  ts );
+			daw::expecting( 10'006, last_seen );
+		}
+		{
+			auto in = std::istringstream( text );
+			daw::expecting_exception<std::runtime_error>( [&] {
+				par::for_each(
+				  std::istream_iterator<int>( in ),
+				  std::istream_iterator<int>( ),
+				  []( int v ) {
+					  if( v == 5'000 ) {
+						  throw std::runtime_error( "bad item" );
+					  }
+				  },
+				  ts );
+			} );
+		}
+	}
+
+	void block_input_bench( std::size_t size ) {
+		auto values = std::list<std::uint64_t>( );
+		for( std::size_t n = 0; n < size; ++n ) {
+			values.push_back( n % 1'000U );
+		}
+		// Integer addition is associative, so the parts give the sequential sum
+		std::uint64_t seq_result = 0;
+		auto const seq = daw::benchmark( [&]( ) {
+			seq_result = std::accumulate( values.begin( ), values.end( ), std::uint64_t{ 0 } );
+			daw::do_not_optimize( seq_result );
+		} );
+		std::uint64_t par_result = 0;
+		auto const par_time = daw::benchmark( [&]( ) {
+			par_result =
+			  par::reduce( values.begin( ), values.end( ), std::uint64_t{ 0 }, std::plus<>{ } );
+			daw::do_not_optimize( par_result );
+		} );
+		daw::expecting( seq_result, par_result );
+		display_info( seq, par_time, size, sizeof( std::uint64_t ), "reduce std::list" );
+	}
+} // namespace
+
+int main( ) {
+	for_each_test_scheduler( []( daw::task_scheduler ts ) {
+		block_input_test_001( ts );
+		block_input_test_002( ts );
+	} );
+
+	std::cout << "block input tests - uint64_t\n";
+	for( std::size_t n = MAX_ITEMS; n >= 100; n /= 10 ) {
+		block_input_bench( n );
+	}
+}
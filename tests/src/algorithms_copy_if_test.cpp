@@ -0,0 +1,213 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/algorithms.h"
+
+#include "common.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+	/// Values spread over [0, 100) so a threshold selects a share of them
+	std::vector<std::int64_t> make_values( std::size_t count ) {
+		auto result = std::vector<std::int64_t>( count );
+		for( std::size_t n = 0; n < count; ++n ) {
+			result[n] = static_cast<std::int64_t>( ( n * 2'654'435'761ULL ) % 100U );
+		}
+		return result;
+	}
+
+	void copy_if_test_001( daw::task_scheduler ts ) {
+		for( std::int64_t const threshold : { 0, 1, 50, 99, 100 } ) {
+			auto const values = make_values( 100'003 );
+			auto const pred = [threshold]( std::int64_t v ) {
+				return v < threshold;
+			};
+			auto expected = std::vector<std::int64_t>( );
+			std::copy_if( values.begin( ), values.end( ), std::back_inserter( expected ), pred );
+
+			auto result = std::vector<std::int64_t>( values.size( ) );
+			auto const last = daw::algorithm::parallel::copy_if(
+			  values.begin( ), values.end( ), result.begin( ), pred, ts );
+			result.erase( last, result.end( ) );
+			daw::expecting( expected == result );
+
+			auto removed = values;
+			removed.erase(
+			  daw::algorithm::parallel::remove_if( removed.begin( ), removed.end( ), pred, ts ),
+			  removed.end( ) );
+			auto expected_removed = values;
+			expected_removed.erase(
+			  std::remove_if( expected_removed.begin( ), expected_removed.end( ), pred ),
+			  expected_removed.end( ) );
+			daw::expecting( expected_removed == removed );
+		}
+	}
+
+	void partition_test_001( daw::task_scheduler ts ) {
+		for( std::int64_t const threshold : { 0, 1, 50, 99, 100 } ) {
+			auto const values = make_values( 100'003 );
+			auto const pred = [threshold]( std::int64_t v ) {
+				return v < threshold;
+			};
+			auto expected = values;
+			auto const expected_mid = std::stable_partition( expected.begin( ), expected.end( ), pred );
+
+			auto stable = values;
+			auto const stable_mid =
+			  daw::algorithm::parallel::stable_partition( stable.begin( ), stable.end( ), pred, ts );
+			daw::expecting( expected_mid - expected.begin( ), stable_mid - stable.begin( ) );
+			daw::expecting( expected == stable );
+
+			auto unstable = values;
+			auto const mid =
+			  daw::algorithm::parallel::partition( unstable.begin( ), unstable.end( ), pred, ts );
+			daw::expecting( expected_mid - expected.begin( ), mid - unstable.begin( ) );
+			daw::expecting( std::is_partitioned( unstable.begin( ), unstable.end( ), pred ) );
+			std::sort( unstable.begin( ), unstable.end( ) );
+			std::sort( expected.begin( ), expected.end( ) );
+			daw::expecting( expected == unstable );
+		}
+	}
+
+	void unique_test_001( daw::task_scheduler ts ) {
+		// Runs that cross the part boundaries
+		auto values = std::vector<std::int64_t>( 100'003 );
+		for( std::size_t n = 0; n < values.size( ); ++n ) {
+			values[n] = static_cast<std::int64_t>( n / 1'000 );
+		}
+		auto expected = values;
+		expected.erase( std::unique( expected.begin( ), expected.end( ) ), expected.end( ) );
+		values.erase( daw::algorithm::parallel::unique( values.begin( ), values.end( ), ts ),
+		              values.end( ) );
+		daw::expecting( expected == values );
+
+		auto distinct = make_values( 1'000 );
+		distinct.erase( std::unique( distinct.begin( ), distinct.end( ) ), distinct.end( ) );
+		auto const size = distinct.size( );
+		daw::expecting( distinct.end( ) ==
+		                daw::algorithm::parallel::unique( distinct.begin( ), distinct.end( ), ts ) );
+		daw::expecting( size, distinct.size( ) );
+	}
+
+	/// A value that can only be moved and has no default constructor
+	class boxed {
+		std::unique_ptr<std::int64_t> m_value;
+
+	public:
+		explicit boxed( std::int64_t v )
+		  : m_value( std::make_unique<std::int64_t>( v ) ) {}
+
+		[[nodiscard]] std::int64_t value( ) const {
+			return *m_value;
+		}
+	};
+
+	std::vector<boxed> box( std::vector<std::int64_t> const &values ) {
+		auto result = std::vector<boxed>( );
+		result.reserve( values.size( ) );
+		for( auto v : values ) {
+			result.emplace_back( v );
+		}
+		return result;
+	}
+
+	template<typename Iterator>
+	std::vector<std::int64_t> unbox( Iterator first, Iterator last ) {
+		auto result = std::vector<std::int64_t>( );
+		for( ; first != last; ++first ) {
+			result.push_back( first->value( ) );
+		}
+		return result;
+	}
+
+	void move_only_test_001( daw::task_scheduler ts ) {
+		namespace par = daw::algorithm::parallel;
+		auto const values = make_values( 100'003 );
+		auto const pred = []( boxed const &b ) {
+			return b.value( ) < 50;
+		};
+		auto const value_pred = []( std::int64_t v ) {
+			return v < 50;
+		};
+
+		auto removed = box( values );
+		auto const removed_last = par::remove_if( removed.begin( ), removed.end( ), pred, ts );
+		auto expected_removed = values;
+		expected_removed.erase(
+		  std::remove_if( expected_removed.begin( ), expected_removed.end( ), value_pred ),
+		  expected_removed.end( ) );
+		daw::expecting( expected_removed == unbox( removed.begin( ), removed_last ) );
+
+		auto stable = box( values );
+		auto const stable_mid = par::stable_partition( stable.begin( ), stable.end( ), pred, ts );
+		auto expected_stable = values;
+		auto const expected_mid =
+		  std::stable_partition( expected_stable.begin( ), expected_stable.end( ), value_pred );
+		daw::expecting( expected_mid - expected_stable.begin( ), stable_mid - stable.begin( ) );
+		daw::expecting( expected_stable == unbox( stable.begin( ), stable.end( ) ) );
+
+		auto runs = std::vector<std::int64_t>( 100'003 );
+		for( std::size_t n = 0; n < runs.size( ); ++n ) {
+			runs[n] = static_cast<std::int64_t>( n / 1'000 );
+		}
+		auto unique = box( runs );
+		auto const unique_last = par::unique(
+		  unique.begin( ), unique.end( ), ts, []( boxed const &lhs, boxed const &rhs ) {
+			  return lhs.value( ) == rhs.value( );
+		  } );
+		runs.erase( std::unique( runs.begin( ), runs.end( ) ), runs.end( ) );
+		daw::expecting( runs == unbox( unique.begin( ), unique_last ) );
+	}
+
+	void copy_if_bench( std::size_t size, std::int64_t threshold ) {
+		auto const values = make_values( size );
+		auto const pred = [threshold]( std::int64_t v ) {
+			return v < threshold;
+		};
+		auto out1 = std::vector<std::int64_t>( size );
+		auto out2 = std::vector<std::int64_t>( size );
+		std::ptrdiff_t count1 = 0;
+		std::ptrdiff_t count2 = 0;
+
+		auto const par_time = daw::benchmark( [&]( ) {
+			auto const last =
+			  daw::algorithm::parallel::copy_if( values.begin( ), values.end( ), out1.begin( ), pred );
+			count1 = last - out1.begin( );
+			daw::do_not_optimize( out1 );
+		} );
+		auto const seq_time = daw::benchmark( [&]( ) {
+			count2 = std::copy_if( values.begin( ), values.end( ), out2.begin( ), pred ) - out2.begin( );
+			daw::do_not_optimize( out2 );
+		} );
+		daw::expecting( count2, count1 );
+		std::cout << threshold << "% selected\n";
+		display_info( seq_time, par_time, size, sizeof( std::int64_t ), "copy_if" );
+	}
+} // namespace
+
+int main( ) {
+	for_each_test_scheduler( []( daw::task_scheduler ts ) {
+		copy_if_test_001( ts );
+		partition_test_001( ts );
+		unique_test_001( ts );
+		move_only_test_001( ts );
+	} );
+
+	std::cout << "copy_if tests - int64_t\n";
+	for( std::int64_t const threshold : { 1, 50, 99 } ) {
+		copy_if_bench( MAX_ITEMS, threshold );
+	}
+}
@@ -0,0 +1,164 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/algorithms.h"
+
+#include "common.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	namespace par = daw::algorithm::parallel;
+
+	void copy_test_001( daw::task_scheduler ts ) {
+		// Both policies, with ranges starting and ending part way through cache
+		// lines
+		for( auto policy : { par::store_policy::cached, par::store_policy::streaming } ) {
+			for( std::size_t const offset : { 0U, 1U, 5U } ) {
+				for( std::size_t const size : { 0U, 1U, 31U, 100'003U } ) {
+					auto in = std::vector<std::int16_t>( size );
+					std::iota( in.begin( ), in.end( ), std::int16_t{ 0 } );
+					auto out = std::vector<std::int16_t>( size + 2 * offset, -1 );
+					auto const last =
+					  par::copy( in.begin( ), in.end( ), out.begin( ) + offset, ts, policy );
+					daw::expecting( out.begin( ) + offset + size == last );
+					daw::expecting( std::equal( in.begin( ), in.end( ), out.begin( ) + offset ) );
+					daw::expecting( std::all_of( last, out.end( ), []( auto v ) { return v == -1; } ) );
+
+					// transform writes its results the same way
+					par::transform(
+					  in.begin( ),
+					  in.end( ),
+					  out.begin( ) + offset,
+					  []( std::int16_t v ) { return static_cast<std::int16_t>( v * 2 ); },
+					  ts,
+					  policy );
+					for( std::size_t n = 0; n < size; ++n ) {
+						daw::expecting( static_cast<std::int16_t>( in[n] * 2 ) == out[offset + n] );
+					}
+				}
+			}
+		}
+		auto const names = std::vector<std::string>( 1'001, "a name too long for small strings" );
+		auto copies = std::vector<std::string>( names.size( ) );
+		(void)par::copy( names.begin( ), names.end( ), copies.begin( ), ts );
+		daw::expecting( names == copies );
+	}
+
+	struct counted {
+		static inline std::atomic<int> alive = 0;
+		static inline std::atomic<int> copies_left = 0;
+		int value = 0;
+
+		explicit counted( int v )
+		  : value( v ) {
+			++alive;
+		}
+
+		counted( counted const &other )
+		  : value( other.value ) {
+			if( --copies_left < 0 ) {
+				throw std::runtime_error( "copy failed" );
+			}
+			++alive;
+		}
+
+		counted &operator=( counted const & ) = delete;
+
+		~counted( ) {
+			--alive;
+		}
+	};
+
+	void uninitialized_copy_test_001( daw::task_scheduler ts ) {
+		auto const in = [] {
+			auto result = std::vector<counted>( );
+			result.reserve( 10'007 );
+			for( int n = 0; n < 10'007; ++n ) {
+				result.emplace_back( n );
+			}
+			return result;
+		}( );
+		auto const storage = std::make_unique<std::byte[]>( sizeof( counted ) * in.size( ) );
+		auto *const out = reinterpret_cast<counted *>( storage.get( ) );
+
+		counted::copies_left = static_cast<int>( in.size( ) );
+		auto const last = par::uninitialized_copy( in.begin( ), in.end( ), out, ts );
+		daw::expecting( out + in.size( ) == last );
+		daw::expecting( static_cast<int>( 2 * in.size( ) ), counted::alive.load( ) );
+		for( std::size_t n = 0; n < in.size( ); ++n ) {
+			daw::expecting( in[n].value, out[n].value );
+		}
+		std::destroy( out, last );
+
+		// A copy part way through throws, and every item constructed is destroyed
+		counted::copies_left = static_cast<int>( in.size( ) / 2 );
+		daw::expecting_exception<std::runtime_error>(
+		  [&] { (void)par::uninitialized_copy( in.begin( ), in.end( ), out, ts ); } );
+		daw::expecting( static_cast<int>( in.size( ) ), counted::alive.load( ) );
+
+		// Trivially copyable items are streamed into the uninitialized memory
+		auto const values = std::vector<double>( 100'003, 1.5 );
+		auto const raw = std::make_unique<std::byte[]>( sizeof( double ) * values.size( ) );
+		auto *const doubles = reinterpret_cast<double *>( raw.get( ) );
+		(void)par::uninitialized_copy(
+		  values.begin( ), values.end( ), doubles, ts, par::store_policy::streaming );
+		daw::expecting( std::equal( values.begin( ), values.end( ), doubles ) );
+	}
+
+	void copy_bench( std::size_t size ) {
+		auto const in = std::vector<double>( size, 1.0 );
+		auto out = std::vector<double>( size );
+		auto const seq = daw::benchmark( [&]( ) {
+			std::copy( in.begin( ), in.end( ), out.begin( ) );
+			daw::do_not_optimize( out );
+		} );
+		auto const cached = daw::benchmark( [&]( ) {
+			(void)par::copy( in.begin( ),
+			                 in.end( ),
+			                 out.begin( ),
+			                 daw::get_task_scheduler( ),
+			                 par::store_policy::cached );
+			daw::do_not_optimize( out );
+		} );
+		auto const streaming = daw::benchmark( [&]( ) {
+			(void)par::copy( in.begin( ),
+			                 in.end( ),
+			                 out.begin( ),
+			                 daw::get_task_scheduler( ),
+			                 par::store_policy::streaming );
+			daw::do_not_optimize( out );
+		} );
+		display_info( seq, cached, size, sizeof( double ), "copy cached" );
+		display_info( seq, streaming, size, sizeof( double ), "copy streaming" );
+	}
+} // namespace
+
+int main( ) {
+	for_each_test_scheduler( []( daw::task_scheduler ts ) {
+		copy_test_001( ts );
+		uninitialized_copy_test_001( ts );
+	} );
+
+	std::cout << "copy tests - double\n";
+	copy_bench( LARGE_TEST_SZ );
+	for( std::size_t n = MAX_ITEMS; n >= 100; n /= 10 ) {
+		copy_bench( n );
+	}
+}
@@ -25,6 +25,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <date/date.h>
+#include <deque>
 #include <iostream>
 #include <numeric>
 #include <string>
@@ -66,6 +67,67 @@ void fill_test( size_t SZ ) {
 	display_info( seq_min, par_min, SZ, sizeof( T ), "fill" );
 }
 
+void fill_streaming_test( ) {
+	// Streamed fills of ranges starting and ending part way through cache
+	// lines write every item and nothing outside the range
+	namespace par = daw::algorithm::parallel;
+	for_each_test_scheduler( []( daw::task_scheduler const &ts ) {
+		for( size_t const offset : { 0U, 1U, 3U, 8U } ) {
+			for( size_t const size : { 0U, 1U, 7U, 16U, 100U, 100'003U } ) {
+				auto a = std::vector<int32_t>( size + 2 * offset + 16, -1 );
+				par::fill( a.begin( ) + offset,
+				           a.begin( ) + offset + size,
+				           7,
+				           ts,
+				           par::store_policy::streaming );
+				daw::expecting(
+				  std::count( a.begin( ), a.end( ), 7 ) == static_cast<std::ptrdiff_t>( size ) );
+				daw::expecting( std::all_of(
+				  a.begin( ) + offset, a.begin( ) + offset + size, []( auto v ) { return v == 7; } ) );
+			}
+		}
+		// Items that do not divide a cache line are written through the cache
+		struct rgb {
+			uint8_t r, g, b;
+		};
+		auto b = std::vector<rgb>( 10'007 );
+		par::fill( b.begin( ), b.end( ), rgb{ 1, 2, 3 }, ts, par::store_policy::streaming );
+		daw::expecting( std::all_of(
+		  b.begin( ), b.end( ), []( rgb v ) { return v.r == 1 and v.g == 2 and v.b == 3; } ) );
+	} );
+}
+
+void fill_non_contiguous_test( ) {
+	// Outputs that are not contiguous are always written through the cache
+	namespace par = daw::algorithm::parallel;
+	auto a = std::deque<int32_t>( 100'003, -1 );
+	par::fill( a.begin( ), a.end( ), 7, daw::get_task_scheduler( ), par::store_policy::streaming );
+	daw::expecting( std::all_of( a.begin( ), a.end( ), []( auto v ) { return v == 7; } ) );
+
+	// Neighbouring items of a std::vector<bool> share a word, so only one
+	// worker writes them
+	auto b = std::vector<bool>( 10'007, false );
+	par::fill( b.begin( ), b.end( ), true, daw::task_scheduler( 1 ), par::store_policy::streaming );
+	daw::expecting( std::all_of( b.begin( ), b.end( ), []( bool v ) { return v; } ) );
+}
+
+void fill_store_policy_bench( size_t SZ ) {
+	namespace par = daw::algorithm::parallel;
+	auto ts = daw::get_task_scheduler( );
+	auto a = std::vector<double>( SZ );
+	auto const cached = daw::benchmark( [&]( ) {
+		par::fill( a.begin( ), a.end( ), 1.0, ts, par::store_policy::cached );
+		daw::do_not_optimize( a );
+	} );
+	auto const streaming = daw::benchmark( [&]( ) {
+		par::fill( a.begin( ), a.end( ), 2.0, ts, par::store_policy::streaming );
+		daw::do_not_optimize( a );
+	} );
+	daw::expecting( 2.0, a.back( ) );
+	std::cout << "cached vs streaming stores\n";
+	display_info( cached, streaming, SZ, sizeof( double ), "fill" );
+}
+
 void fill_double( ) {
 	std::cout << "fill tests - double\n";
 	for( size_t n = MAX_ITEMS; n >= 100; n /= 10 ) {
@@ -88,6 +150,9 @@ void fill_int32_t( ) {
 }
 
 int main( ) {
+	fill_streaming_test( );
+	fill_non_contiguous_test( );
+	fill_store_policy_bench( LARGE_TEST_SZ );
 	fill_double( );
 	fill_int64_t( );
 	fill_int32_t( );
@@ -0,0 +1,109 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/algorithms.h"
+
+#include "common.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+	/// Latencies in microseconds, skewed towards the low buckets
+	std::vector<std::uint32_t> make_latencies( std::size_t count ) {
+		auto result = std::vector<std::uint32_t>( count );
+		auto rng = test_random_t( );
+		for( auto &latency : result ) {
+			auto const r = static_cast<std::uint32_t>( rng( ) % 1'000'000U );
+			latency = ( r * ( r / 1'000U ) ) / 1'000'000U;
+		}
+		return result;
+	}
+
+	void histogram_test_001( daw::task_scheduler ts ) {
+		// Fewer buckets than a cache line holds, and many more than there are
+		// items in a part
+		for( std::size_t const bucket_count : { 1U, 3U, 100U, 10'000U, 100'003U } ) {
+			auto const values = make_latencies( 100'003 );
+			auto const bucket = [bucket_count]( std::uint32_t v ) {
+				return v % bucket_count;
+			};
+			auto expected = std::vector<std::size_t>( bucket_count );
+			for( auto v : values ) {
+				++expected[bucket( v )];
+			}
+			auto const result = daw::algorithm::parallel::histogram(
+			  values.begin( ), values.end( ), bucket, bucket_count, ts );
+			daw::expecting( expected == result );
+		}
+		auto const empty = std::vector<std::uint32_t>( );
+		auto const result = daw::algorithm::parallel::histogram(
+		  empty.begin( ), empty.end( ), []( std::uint32_t v ) { return v; }, 10, ts );
+		daw::expecting( std::vector<std::size_t>( 10 ) == result );
+	}
+
+	void count_by_key_test_001( daw::task_scheduler ts ) {
+		auto const values = make_latencies( 100'003 );
+		auto expected = std::unordered_map<std::uint32_t, std::size_t>( );
+		for( auto v : values ) {
+			++expected[v];
+		}
+		daw::expecting( expected == daw::algorithm::parallel::count_by_key(
+		                              values.begin( ), values.end( ), ts ) );
+
+		// A key of another type than the items
+		auto const names = std::vector<std::string>{ "get", "put", "get", "delete", "get", "put" };
+		auto const by_length = daw::algorithm::parallel::count_by_key(
+		  names.begin( ), names.end( ), ts, []( std::string const &s ) { return s.size( ); } );
+		daw::expecting( std::size_t{ 2 }, by_length.size( ) );
+		daw::expecting( std::size_t{ 5 }, by_length.at( 3 ) );
+		daw::expecting( std::size_t{ 1 }, by_length.at( 6 ) );
+	}
+
+	void histogram_bench( std::size_t size, std::size_t bucket_count ) {
+		auto const values = make_latencies( size );
+		auto const bucket = [bucket_count]( std::uint32_t v ) {
+			return v % bucket_count;
+		};
+		auto par = std::vector<std::size_t>( );
+		auto seq = std::vector<std::size_t>( );
+		auto const par_time = daw::benchmark( [&]( ) {
+			par = daw::algorithm::parallel::histogram(
+			  values.begin( ), values.end( ), bucket, bucket_count );
+			daw::do_not_optimize( par );
+		} );
+		auto const seq_time = daw::benchmark( [&]( ) {
+			seq.assign( bucket_count, 0 );
+			for( auto v : values ) {
+				++seq[bucket( v )];
+			}
+			daw::do_not_optimize( seq );
+		} );
+		daw::expecting( seq == par );
+		std::cout << bucket_count << " buckets\n";
+		display_info( seq_time, par_time, size, sizeof( std::uint32_t ), "histogram" );
+	}
+} // namespace
+
+int main( ) {
+	for_each_test_scheduler( []( daw::task_scheduler ts ) {
+		histogram_test_001( ts );
+		count_by_key_test_001( ts );
+	} );
+
+	std::cout << "histogram tests - uint32_t\n";
+	for( std::size_t const bucket_count : { 64U, 65'536U } ) {
+		histogram_bench( MAX_ITEMS, bucket_count );
+	}
+}
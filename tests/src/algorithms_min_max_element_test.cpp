@@ -29,6 +29,7 @@
 #include <numeric>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <daw/daw_benchmark.h>
@@ -105,6 +106,52 @@ void max_element_test( size_t SZ ) {
 	display_info( seq_max, par_max, SZ, sizeof( value_t ), "max_element" );
 }
 
+template<typename value_t>
+void minmax_element_test( size_t SZ ) {
+	auto ts = daw::get_task_scheduler( );
+	auto a = daw::make_random_data<value_t>( SZ );
+	std::pair<value_t, value_t> result1{ };
+	std::pair<value_t, value_t> result2{ };
+
+	auto const result_1 = daw::benchmark( [&]( ) {
+		auto const mm = daw::algorithm::parallel::minmax_element( a.begin( ), a.end( ), ts );
+		result1 = { *mm.first, *mm.second };
+		daw::do_not_optimize( result1 );
+	} );
+	auto const result_2 = daw::benchmark( [&]( ) {
+		auto const mm = std::minmax_element( a.begin( ), a.end( ) );
+		result2 = { *mm.first, *mm.second };
+		daw::do_not_optimize( result2 );
+	} );
+	daw::expecting( result1 == result2 );
+	display_info( result_2, result_1, SZ, sizeof( value_t ), "minmax_element" );
+}
+
+void minmax_element_positions( ) {
+	// As std::minmax_element, the first of the smallest and the last of the
+	// largest, whatever parts they fall in
+	for_each_test_scheduler( []( daw::task_scheduler const &ts ) {
+		auto a = std::vector<int64_t>( 100'003, 5 );
+		a[10] = 1;
+		a[60'000] = 1;
+		a[20] = 9;
+		a[90'000] = 9;
+		auto const mm = daw::algorithm::parallel::minmax_element( a.begin( ), a.end( ), ts );
+		daw::expecting( std::minmax_element( a.begin( ), a.end( ) ) == mm );
+		daw::expecting( a.begin( ) + 10 == mm.first );
+		daw::expecting( a.begin( ) + 90'000 == mm.second );
+
+		auto const all_same = std::vector<int64_t>( 100'003, 5 );
+		auto const mm2 =
+		  daw::algorithm::parallel::minmax_element( all_same.begin( ), all_same.end( ), ts );
+		daw::expecting( std::minmax_element( all_same.begin( ), all_same.end( ) ) == mm2 );
+
+		auto const empty = std::vector<int64_t>( );
+		auto const mm3 = daw::algorithm::parallel::minmax_element( empty.begin( ), empty.end( ), ts );
+		daw::expecting( empty.end( ) == mm3.first and empty.end( ) == mm3.second );
+	} );
+}
+
 void min_element_int64_t( ) {
 	std::cout << "min_element tests - int64_t\n";
 	min_element_test<int64_t>( LARGE_TEST_SZ );
@@ -121,7 +168,17 @@ void max_element_int64_t( ) {
 	}
 }
 
+void minmax_element_int64_t( ) {
+	std::cout << "minmax_element tests - int64_t\n";
+	minmax_element_test<int64_t>( LARGE_TEST_SZ );
+	for( size_t n = MAX_ITEMS; n >= 100; n /= 10 ) {
+		minmax_element_test<int64_t>( n );
+	}
+}
+
 int main( ) {
+	minmax_element_positions( );
 	min_element_int64_t( );
 	max_element_int64_t( );
+	minmax_element_int64_t( );
 }
@@ -0,0 +1,115 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/algorithms.h"
+
+#include "common.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace {
+	/// Pseudo random values, with many repeats when modulus is small
+	std::vector<std::int64_t> make_values( std::size_t count, std::uint64_t modulus ) {
+		auto result = std::vector<std::int64_t>( count );
+		auto rng = test_random_t( );
+		for( auto &v : result ) {
+			v = static_cast<std::int64_t>( rng( ) % modulus );
+		}
+		return result;
+	}
+
+	void nth_element_test_001( daw::task_scheduler ts ) {
+		for( std::uint64_t const modulus : { 3ULL, 1'000ULL, 1'000'000'000ULL } ) {
+			auto const values = make_values( 500'000, modulus );
+			auto sorted = values;
+			std::sort( sorted.begin( ), sorted.end( ) );
+			for( std::size_t const pos : { std::size_t{ 0 }, std::size_t{ 1 }, std::size_t{ 250'000 },
+			                               std::size_t{ 495'000 }, std::size_t{ 499'999 } } ) {
+				auto result = values;
+				auto const nth = result.begin( ) + static_cast<std::ptrdiff_t>( pos );
+				daw::algorithm::parallel::nth_element( result.begin( ), nth, result.end( ), ts );
+				daw::expecting( sorted[pos], *nth );
+				daw::expecting( std::all_of(
+				  result.begin( ), nth, [&]( auto const &v ) { return not( *nth < v ); } ) );
+				daw::expecting( std::all_of(
+				  nth, result.end( ), [&]( auto const &v ) { return not( v < *nth ); } ) );
+			}
+		}
+	}
+
+	void partial_sort_test_001( daw::task_scheduler ts ) {
+		auto values = make_values( 300'000, 1'000'000 );
+		auto sorted = values;
+		std::sort( sorted.begin( ), sorted.end( ) );
+		auto const middle = values.begin( ) + 100'000;
+		daw::algorithm::parallel::partial_sort( values.begin( ), middle, values.end( ), ts );
+		daw::expecting( std::equal( values.begin( ), middle, sorted.begin( ) ) );
+	}
+
+	void top_k_test_001( daw::task_scheduler ts ) {
+		auto const values = make_values( 300'000, 1'000'000 );
+		auto sorted = values;
+		std::sort( sorted.begin( ), sorted.end( ), std::greater<>{ } );
+
+		auto const top = daw::algorithm::parallel::top_k( values.begin( ), values.end( ), 1'000, ts );
+		daw::expecting( std::size_t{ 1'000 }, top.size( ) );
+		daw::expecting( std::equal( top.begin( ), top.end( ), sorted.begin( ) ) );
+
+		auto const bottom = daw::algorithm::parallel::top_k(
+		  values.begin( ), values.end( ), 10, ts, std::less<>{ } );
+		daw::expecting( std::equal( bottom.begin( ), bottom.end( ), sorted.rbegin( ) ) );
+
+		auto const all =
+		  daw::algorithm::parallel::top_k( values.begin( ), values.begin( ) + 5, 10, ts );
+		daw::expecting( std::size_t{ 5 }, all.size( ) );
+	}
+
+	void percentile_bench( std::size_t size ) {
+		// The p99 of latency samples
+		auto const values = make_values( size, 1'000'000 );
+		auto const pos = static_cast<std::ptrdiff_t>( size * 99 / 100 );
+		auto par = values;
+		auto seq = values;
+		auto sorted = values;
+		auto const par_time = daw::benchmark( [&]( ) {
+			daw::algorithm::parallel::nth_element( par.begin( ), par.begin( ) + pos, par.end( ) );
+			daw::do_not_optimize( par );
+		} );
+		auto const seq_time = daw::benchmark( [&]( ) {
+			std::nth_element( seq.begin( ), seq.begin( ) + pos, seq.end( ) );
+			daw::do_not_optimize( seq );
+		} );
+		auto const sort_time = daw::benchmark( [&]( ) {
+			daw::algorithm::parallel::sort( sorted.begin( ), sorted.end( ) );
+			daw::do_not_optimize( sorted );
+		} );
+		daw::expecting( seq[static_cast<std::size_t>( pos )], par[static_cast<std::size_t>( pos )] );
+		daw::expecting( seq[static_cast<std::size_t>( pos )],
+		                sorted[static_cast<std::size_t>( pos )] );
+		display_info( seq_time, par_time, size, sizeof( std::int64_t ), "nth_element" );
+		std::cout << "\tparallel sort: " << daw::utility::format_seconds( sort_time, 3 ) << '\n';
+	}
+} // namespace
+
+int main( ) {
+	for_each_test_scheduler( []( daw::task_scheduler ts ) {
+		nth_element_test_001( ts );
+		partial_sort_test_001( ts );
+		top_k_test_001( ts );
+	} );
+
+	std::cout << "nth_element tests - int64_t\n";
+	percentile_bench( MAX_ITEMS );
+}
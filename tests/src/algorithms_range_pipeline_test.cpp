@@ -0,0 +1,118 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/algorithms.h"
+
+#include "common.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	namespace par = daw::algorithm::parallel;
+
+	void range_pipeline_test_001( daw::task_scheduler ts ) {
+		for( std::size_t const size : { 0U, 1U, 7U, 100'003U } ) {
+			auto data = std::vector<std::int64_t>( size );
+			std::iota( data.begin( ), data.end( ), std::int64_t{ 0 } );
+
+			std::int64_t expected = 0;
+			std::size_t expected_count = 0;
+			for( auto v : data ) {
+				if( ( v * 3 ) % 2 == 0 ) {
+					expected += v * 3;
+					++expected_count;
+				}
+			}
+			auto const triple = []( std::int64_t v ) { return v * 3; };
+			auto const is_even = []( std::int64_t v ) { return v % 2 == 0; };
+
+			auto const sum = data | par::transform( triple ) | par::filter( is_even ) |
+			                 par::reduce( std::plus<>{ }, ts );
+			daw::expecting( expected, sum );
+
+			auto const sum_init = data | par::transform( triple ) | par::filter( is_even ) |
+			                      par::reduce( std::int64_t{ 5 }, std::plus<>{ }, ts );
+			daw::expecting( expected + 5, sum_init );
+
+			auto const n = data | par::transform( triple ) | par::filter( is_even ) | par::count( ts );
+			daw::expecting( expected_count, n );
+
+			std::atomic<std::int64_t> seen = 0;
+			data | par::filter( []( std::int64_t v ) { return v % 2 != 0; } ) |
+			  par::for_each( [&]( std::int64_t v ) { seen += v; }, ts );
+			std::int64_t expected_odd = 0;
+			for( auto v : data ) {
+				expected_odd += v % 2 != 0 ? v : 0;
+			}
+			daw::expecting( expected_odd, seen.load( ) );
+		}
+	}
+
+	void range_pipeline_test_002( daw::task_scheduler ts ) {
+		// The stages change the item type, and the reduction is not commutative
+		auto data = std::vector<int>( 10'007 );
+		std::iota( data.begin( ), data.end( ), 0 );
+		auto const text = data | par::filter( []( int v ) { return v % 1000 == 0; } ) |
+		                  par::transform( []( int v ) { return std::to_string( v / 1000 ); } ) |
+		                  par::reduce( std::string( ">" ), std::plus<>{ }, ts );
+		daw::expecting( std::string( ">012345678910" ), text );
+
+		// A stage that throws rethrows on the calling thread
+		daw::expecting_exception<std::runtime_error>( [&] {
+			(void)( data | par::transform( []( int v ) {
+				        if( v == 5'000 ) {
+					        throw std::runtime_error( "bad item" );
+				        }
+				        return v;
+			        } ) |
+			        par::count( ts ) );
+		} );
+	}
+
+	void range_pipeline_bench( std::size_t size ) {
+		auto data = std::vector<double>( size, 1.0 );
+		auto const triple = []( double v ) { return v * 3.0; };
+		auto const positive = []( double v ) { return v > 0.0; };
+		auto const unfused = daw::benchmark( [&]( ) {
+			auto mapped = std::vector<double>( size );
+			auto kept = std::vector<double>( size );
+			par::transform( data.begin( ), data.end( ), mapped.begin( ), triple );
+			auto const last = par::copy_if( mapped.begin( ), mapped.end( ), kept.begin( ), positive );
+			auto result = par::reduce( kept.begin( ), last, 0.0 );
+			daw::do_not_optimize( result );
+		} );
+		auto const fused = daw::benchmark( [&]( ) {
+			auto result = data | par::transform( triple ) | par::filter( positive ) |
+			              par::reduce( std::plus<>{ } );
+			daw::do_not_optimize( result );
+		} );
+		display_info( unfused, fused, size, sizeof( double ), "transform | filter | reduce" );
+	}
+} // namespace
+
+int main( ) {
+	for_each_test_scheduler( []( daw::task_scheduler ts ) {
+		range_pipeline_test_001( ts );
+		range_pipeline_test_002( ts );
+	} );
+
+	std::cout << "range pipeline tests - double\n";
+	range_pipeline_bench( LARGE_TEST_SZ );
+	for( std::size_t n = MAX_ITEMS; n >= 100; n /= 10 ) {
+		range_pipeline_bench( n );
+	}
+}
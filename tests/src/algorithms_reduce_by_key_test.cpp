@@ -0,0 +1,118 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/algorithms.h"
+
+#include "common.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+	/// Unsorted keys in [0, key_count)
+	std::vector<std::uint64_t> make_keys( std::size_t count, std::uint64_t key_count ) {
+		auto result = std::vector<std::uint64_t>( count );
+		auto rng = test_random_t( );
+		for( auto &key : result ) {
+			key = rng( ) % key_count;
+		}
+		return result;
+	}
+
+	template<typename Key, typename Value>
+	std::map<Key, Value> to_map( std::vector<std::pair<Key, Value>> const &items ) {
+		return std::map<Key, Value>( items.begin( ), items.end( ) );
+	}
+
+	void reduce_by_key_test_001( daw::task_scheduler ts ) {
+		// One key, a few keys, and mostly distinct keys
+		for( std::uint64_t const key_count : { 1U, 10U, 1'000U, 1'000'000U } ) {
+			auto const keys = make_keys( 100'003, key_count );
+			auto const values = std::vector<std::int64_t>( keys.size( ), 3 );
+			auto expected = std::map<std::uint64_t, std::int64_t>( );
+			for( auto k : keys ) {
+				expected[k] += 3;
+			}
+			auto const result = daw::algorithm::parallel::reduce_by_key(
+			  keys.begin( ), keys.end( ), values.begin( ), std::plus<>{ }, ts );
+			daw::expecting( expected.size( ), result.size( ) );
+			daw::expecting( expected == to_map( result ) );
+		}
+	}
+
+	void reduce_by_key_test_002( daw::task_scheduler ts ) {
+		// The values of a key are combined in item order, so keeping the left
+		// value gives the first index of each key
+		auto const keys = make_keys( 100'003, 97 );
+		auto indices = std::vector<std::size_t>( keys.size( ) );
+		for( std::size_t n = 0; n < indices.size( ); ++n ) {
+			indices[n] = n;
+		}
+		auto expected = std::map<std::uint64_t, std::size_t>( );
+		for( std::size_t n = 0; n < keys.size( ); ++n ) {
+			expected.emplace( keys[n], n );
+		}
+		auto const result = daw::algorithm::parallel::reduce_by_key(
+		  keys.begin( ),
+		  keys.end( ),
+		  indices.begin( ),
+		  []( std::size_t lhs, std::size_t ) { return lhs; },
+		  ts );
+		daw::expecting( expected == to_map( result ) );
+
+		auto const names = std::vector<std::string>{ "a", "b", "a", "c", "a", "b" };
+		auto const lengths = std::vector<std::string>{ "1", "2", "3", "4", "5", "6" };
+		auto const joined = to_map( daw::algorithm::parallel::reduce_by_key(
+		  names.begin( ), names.end( ), lengths.begin( ), std::plus<>{ }, ts ) );
+		daw::expecting( std::string( "135" ), joined.at( "a" ) );
+		daw::expecting( std::string( "26" ), joined.at( "b" ) );
+		daw::expecting( std::string( "4" ), joined.at( "c" ) );
+	}
+
+	void reduce_by_key_bench( std::size_t size, std::uint64_t key_count ) {
+		auto const keys = make_keys( size, key_count );
+		auto const values = std::vector<std::int64_t>( size, 1 );
+		auto par = std::vector<std::pair<std::uint64_t, std::int64_t>>( );
+		auto seq = std::unordered_map<std::uint64_t, std::int64_t>( );
+		auto const par_time = daw::benchmark( [&]( ) {
+			par = daw::algorithm::parallel::reduce_by_key(
+			  keys.begin( ), keys.end( ), values.begin( ), std::plus<>{ } );
+			daw::do_not_optimize( par );
+		} );
+		auto const seq_time = daw::benchmark( [&]( ) {
+			for( std::size_t n = 0; n < size; ++n ) {
+				seq[keys[n]] += values[n];
+			}
+			daw::do_not_optimize( seq );
+		} );
+		daw::expecting( seq.size( ), par.size( ) );
+		std::cout << key_count << " keys\n";
+		display_info( seq_time, par_time, size, sizeof( std::uint64_t ) * 2, "reduce_by_key" );
+	}
+} // namespace
+
+int main( ) {
+	for_each_test_scheduler( []( daw::task_scheduler ts ) {
+		reduce_by_key_test_001( ts );
+		reduce_by_key_test_002( ts );
+	} );
+
+	std::cout << "reduce_by_key tests - uint64_t keys, int64_t values\n";
+	for( std::uint64_t const key_count : { 1'000U, 1'000'000U } ) {
+		reduce_by_key_bench( MAX_ITEMS, key_count );
+	}
+}
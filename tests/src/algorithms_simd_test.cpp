@@ -0,0 +1,160 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/algorithms.h"
+#include "daw/fs/impl/simd_kernels.h"
+
+#include "common.h"
+
+#include <daw/daw_benchmark.h>
+#include <daw/daw_random.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace {
+	namespace simd = daw::algorithm::parallel::impl::simd;
+
+	constexpr simd::isa_t all_isas[] = {
+	  simd::isa_t::scalar, simd::isa_t::sse2, simd::isa_t::avx2, simd::isa_t::avx512 };
+
+	char const *isa_name( simd::isa_t isa ) {
+		switch( isa ) {
+		case simd::isa_t::sse2:
+			return "sse2";
+		case simd::isa_t::avx2:
+			return "avx2";
+		case simd::isa_t::avx512:
+			return "avx512";
+		default:
+			return "scalar";
+		}
+	}
+
+	/// The kernels against the std algorithms, at sizes around the vector,
+	/// unroll and block widths
+	template<typename T>
+	void simd_kernel_test( T lo, T hi ) {
+		for( std::size_t const size : { 1U, 3U, 15U, 16U, 17U, 63U, 64U, 65U, 255U, 1'000U, 4'099U } ) {
+			auto values = daw::make_random_data<T>( size, lo, hi );
+			for( auto isa : all_isas ) {
+				simd::limit_isa( isa );
+				auto const *const first = values.data( );
+				auto const sum = std::accumulate( values.begin( ), values.end( ), T{ } );
+				if constexpr( std::is_floating_point_v<T> ) {
+					// The additions are in another order
+					daw::expecting( std::abs( sum - simd::sum( first, size ) ) <
+					                static_cast<T>( size ) * hi * T{ 1e-6 } );
+				} else {
+					daw::expecting( sum, simd::sum( first, size ) );
+				}
+				auto const cnt = std::count( values.begin( ), values.end( ), lo );
+				daw::expecting( static_cast<std::size_t>( cnt ), simd::count( first, size, lo ) );
+				daw::expecting( &*std::min_element( values.begin( ), values.end( ) ),
+				                simd::extreme_element<false>( first, size ) );
+				daw::expecting( &*std::max_element( values.begin( ), values.end( ) ),
+				                simd::extreme_element<true>( first, size ) );
+			}
+		}
+		// Enough equal items to overflow a narrow lane count
+		auto const same = std::vector<T>( 100'003, hi );
+		for( auto isa : all_isas ) {
+			simd::limit_isa( isa );
+			daw::expecting( same.size( ), simd::count( same.data( ), same.size( ), hi ) );
+			daw::expecting( same.data( ), simd::extreme_element<true>( same.data( ), same.size( ) ) );
+		}
+		simd::limit_isa( simd::isa_t::avx512 );
+	}
+
+	void simd_algorithm_test( daw::task_scheduler ts ) {
+		// The algorithms pick the kernels for these, and give the results of the
+		// scalar loops
+		auto values = daw::make_random_data<std::int32_t>( 100'003, -1'000, 1'000 );
+		values[70'000] = -5'000;
+		values[90'000] = -5'000;
+		values[30'000] = 5'000;
+		values[80'000] = 5'000;
+		namespace par = daw::algorithm::parallel;
+		daw::expecting( std::accumulate( values.begin( ), values.end( ), std::int32_t{ 0 } ),
+		                par::reduce( values.begin( ), values.end( ), std::int32_t{ 0 }, ts ) );
+		daw::expecting( values.begin( ) + 70'000,
+		                par::min_element( values.begin( ), values.end( ), ts ) );
+		daw::expecting( values.begin( ) + 30'000,
+		                par::max_element( values.begin( ), values.end( ), ts ) );
+		daw::expecting( std::count( values.begin( ), values.end( ), 7 ),
+		                par::count( values.begin( ), values.end( ), std::int32_t{ 7 }, ts ) );
+
+		auto other = values;
+		daw::expecting(
+		  par::equal( values.begin( ), values.end( ), other.begin( ), other.end( ), ts ) );
+		other[99'999] += 1;
+		daw::expecting(
+		  not par::equal( values.begin( ), values.end( ), other.begin( ), other.end( ), ts ) );
+
+		auto const doubles = daw::make_random_data<double>( 100'003, -1.0, 1.0 );
+		auto const sum = par::reduce( doubles.begin( ), doubles.end( ), 0.0, ts );
+		daw::expecting( std::abs( std::accumulate( doubles.begin( ), doubles.end( ), 0.0 ) - sum ) <
+		                1e-9 );
+	}
+
+	template<typename T>
+	void simd_bench( std::size_t size, char const *type_name ) {
+		auto const values = daw::make_random_data<T>( size, 0, 100 );
+		std::cout << "sum and count - " << type_name << '\n';
+		T sum = 0;
+		auto const time_sum = [&]( ) {
+			return daw::benchmark( [&]( ) {
+				sum = daw::algorithm::parallel::reduce( values.begin( ), values.end( ), T{ 0 } );
+				daw::do_not_optimize( sum );
+			} );
+		};
+		std::ptrdiff_t cnt = 0;
+		auto const time_count = [&]( ) {
+			return daw::benchmark( [&]( ) {
+				cnt = daw::algorithm::parallel::count( values.begin( ), values.end( ), T{ 42 } );
+				daw::do_not_optimize( cnt );
+			} );
+		};
+		// Each isa is compared with the scalar kernels
+		simd::limit_isa( simd::isa_t::scalar );
+		auto const scalar_sum_time = time_sum( );
+		auto const scalar_count_time = time_count( );
+		auto const scalar_cnt = cnt;
+		for( auto isa : all_isas ) {
+			simd::limit_isa( isa );
+			if( isa == simd::isa_t::scalar or simd::current_isa( ) != isa ) {
+				continue;
+			}
+			auto const sum_time = time_sum( );
+			auto const count_time = time_count( );
+			daw::expecting( scalar_cnt, cnt );
+			std::cout << isa_name( isa ) << ' ';
+			display_info( scalar_sum_time, sum_time, size, sizeof( T ), "reduce" );
+			std::cout << isa_name( isa ) << ' ';
+			display_info( scalar_count_time, count_time, size, sizeof( T ), "count" );
+		}
+		simd::limit_isa( simd::isa_t::avx512 );
+	}
+} // namespace
+
+int main( ) {
+	simd_kernel_test<std::int8_t>( -100, 100 );
+	simd_kernel_test<std::uint16_t>( 0, 60'000 );
+	simd_kernel_test<std::int32_t>( -1'000'000, 1'000'000 );
+	simd_kernel_test<std::uint64_t>( 0, 1'000'000'000'000 );
+	simd_kernel_test<float>( -100.0f, 100.0f );
+	for_each_test_scheduler( simd_algorithm_test );
+	simd_bench<std::int32_t>( MAX_ITEMS, "int32_t" );
+	simd_bench<double>( MAX_ITEMS, "double" );
+}
@@ -30,7 +30,9 @@
 #include <benchmark/benchmark.h>
 #include <chrono>
 #include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <vector>
 
 template<typename Iterator>
 void test_sort( Iterator first, Iterator last, daw::string_view label ) {
@@ -84,3 +86,26 @@ BENCHMARK_TEMPLATE( parallel_sort_test, 1'024 );
 BENCHMARK_TEMPLATE( parallel_sort_test, 4'096 );
 BENCHMARK_TEMPLATE( parallel_sort_test, 16'384 );
 BENCHMARK_TEMPLATE( parallel_sort_test, 65'536 );
+
+void parallel_sort_many_parts_test( benchmark::State &state ) {
+	// More parts than cores takes several rounds of merges, and no merge may
+	// block a worker waiting on another
+	auto ts = daw::task_scheduler( 16 );
+	auto const a = daw::make_random_data<int64_t>( 1'000'003 );
+	auto b = std::vector<int64_t>( );
+	auto c = std::vector<int64_t>( );
+	for( auto _ : state ) {
+		b = a;
+		c = a;
+		daw::algorithm::parallel::sort( std::data( b ), daw::data_end( b ), ts );
+		daw::algorithm::parallel::stable_sort( std::data( c ), daw::data_end( c ), ts );
+		benchmark::DoNotOptimize( b );
+		benchmark::DoNotOptimize( c );
+	}
+	if( not std::is_sorted( b.begin( ), b.end( ) ) or b != c ) {
+		test_sort( std::data( b ), daw::data_end( b ), "parallel sort many parts test" );
+		std::abort( );
+	}
+}
+
+BENCHMARK( parallel_sort_many_parts_test );
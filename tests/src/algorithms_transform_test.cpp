@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstdlib>
+#include <deque>
 #include <numeric>
 #include <string>
 #include <thread>
@@ -119,6 +120,36 @@ void transform_test2( size_t SZ ) {
 	display_info( seq_max, par_max, SZ, sizeof( value_t ), "transform" );
 }
 
+void transform_non_contiguous_test( ) {
+	// Outputs that are not contiguous are always written through the cache
+	namespace par = daw::algorithm::parallel;
+	auto a = std::vector<int64_t>( 100'003 );
+	std::iota( a.begin( ), a.end( ), 0 );
+	auto b = std::deque<int64_t>( a.size( ) );
+	par::transform( a.cbegin( ),
+	                a.cend( ),
+	                b.begin( ),
+	                []( int64_t v ) { return v + v; },
+	                daw::get_task_scheduler( ),
+	                par::store_policy::streaming );
+	for( size_t n = 0; n < a.size( ); ++n ) {
+		daw::expecting( a[n] + a[n], b[n] );
+	}
+
+	// Neighbouring items of a std::vector<bool> share a word, so only one
+	// worker writes them
+	auto c = std::vector<bool>( a.size( ) );
+	par::transform( a.cbegin( ),
+	                a.cend( ),
+	                c.begin( ),
+	                []( int64_t v ) { return v % 2 == 0; },
+	                daw::task_scheduler( 1 ),
+	                par::store_policy::streaming );
+	for( size_t n = 0; n < a.size( ); ++n ) {
+		daw::expecting( a[n] % 2 == 0, static_cast<bool>( c[n] ) );
+	}
+}
+
 void transform_int64_t( ) {
 	std::cout << "transform tests - int64_t\n";
 	transform_test<int64_t>( LARGE_TEST_SZ );
@@ -136,6 +167,7 @@ void transform2_int64_t( ) {
 }
 
 int main( ) {
+	transform_non_contiguous_test( );
 	transform_int64_t( );
 	transform2_int64_t( );
 }
@@ -0,0 +1,217 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/algorithms.h"
+
+#include "common.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	namespace par = daw::algorithm::parallel;
+
+	struct counted {
+		static inline std::atomic<int> alive = 0;
+		static inline std::atomic<int> constructions_left = 0;
+		int value = 0;
+
+		explicit counted( int v )
+		  : value( v ) {
+			if( --constructions_left < 0 ) {
+				throw std::runtime_error( "construction failed" );
+			}
+			++alive;
+		}
+
+		counted( counted const &other )
+		  : counted( other.value ) {}
+
+		counted( counted &&other ) noexcept
+		  : value( other.value ) {
+			++alive;
+		}
+
+		counted &operator=( counted const & ) = delete;
+
+		~counted( ) {
+			--alive;
+		}
+	};
+
+	template<typename T>
+	struct raw_storage {
+		std::unique_ptr<std::byte[]> storage;
+		T *first;
+
+		explicit raw_storage( std::size_t size )
+		  : storage( std::make_unique<std::byte[]>( sizeof( T ) * size ) )
+		  , first( reinterpret_cast<T *>( storage.get( ) ) ) {}
+	};
+
+	void uninitialized_fill_test_001( daw::task_scheduler ts ) {
+		constexpr std::size_t size = 10'007;
+		auto const out = raw_storage<counted>( size );
+		counted::constructions_left = 1;
+		auto const value = counted( 42 );
+
+		counted::constructions_left = static_cast<int>( size );
+		par::uninitialized_fill( out.first, out.first + size, value, ts );
+		daw::expecting( static_cast<int>( size + 1 ), counted::alive.load( ) );
+		daw::expecting(
+		  std::all_of( out.first, out.first + size, []( auto const &c ) { return c.value == 42; } ) );
+
+		// destroy leaves only value alive
+		par::destroy( out.first, out.first + size, ts );
+		daw::expecting( 1, counted::alive.load( ) );
+
+		// A copy part way through throws, and every item constructed is destroyed
+		counted::constructions_left = static_cast<int>( size / 2 );
+		daw::expecting_exception<std::runtime_error>(
+		  [&] { par::uninitialized_fill( out.first, out.first + size, value, ts ); } );
+		daw::expecting( 1, counted::alive.load( ) );
+
+		// Trivial items, streamed or not
+		for( auto policy : { par::store_policy::cached, par::store_policy::streaming } ) {
+			auto const doubles = raw_storage<double>( 100'003 );
+			par::uninitialized_fill( doubles.first + 1, doubles.first + 100'002, 1.5, ts, policy );
+			daw::expecting( std::all_of(
+			  doubles.first + 1, doubles.first + 100'002, []( double d ) { return d == 1.5; } ) );
+		}
+	}
+
+	void uninitialized_transform_test_001( daw::task_scheduler ts ) {
+		constexpr std::size_t size = 10'007;
+		auto in = std::vector<int>( size );
+		std::iota( in.begin( ), in.end( ), 0 );
+		auto const out = raw_storage<counted>( size );
+
+		counted::constructions_left = static_cast<int>( size );
+		auto const last = par::uninitialized_transform(
+		  in.begin( ), in.end( ), out.first, []( int v ) { return counted( 2 * v ); }, ts );
+		daw::expecting( out.first + size == last );
+		for( std::size_t n = 0; n < size; ++n ) {
+			daw::expecting( 2 * in[n], out.first[n].value );
+		}
+		par::destroy( out.first, last, ts );
+		daw::expecting( 0, counted::alive.load( ) );
+
+		// unary_op part way through throws, and every item constructed is destroyed
+		counted::constructions_left = static_cast<int>( size / 3 );
+		daw::expecting_exception<std::runtime_error>( [&] {
+			(void)par::uninitialized_transform(
+			  in.begin( ), in.end( ), out.first, []( int v ) { return counted( v ); }, ts );
+		} );
+		daw::expecting( 0, counted::alive.load( ) );
+
+		auto const strings = raw_storage<std::string>( size );
+		(void)par::uninitialized_transform(
+		  in.begin( ), in.end( ), strings.first, []( int v ) { return std::to_string( v ); }, ts );
+		for( std::size_t n = 0; n < size; ++n ) {
+			daw::expecting( std::to_string( in[n] ), strings.first[n] );
+		}
+		par::destroy( strings.first, strings.first + size, ts );
+	}
+
+	template<typename Vector>
+	void resize_and_overwrite_test( daw::task_scheduler ts ) {
+		auto vec = Vector( 3, 7 );
+		for( auto policy : { par::store_policy::cached, par::store_policy::streaming } ) {
+			vec.resize( 3 );
+			par::resize_and_overwrite(
+			  vec,
+			  100'003,
+			  []( std::size_t n ) { return static_cast<std::int32_t>( n ); },
+			  ts,
+			  policy );
+			daw::expecting( 100'003U, vec.size( ) );
+			daw::expecting(
+			  std::all_of( vec.begin( ), vec.begin( ) + 3, []( auto v ) { return v == 7; } ) );
+			for( std::size_t n = 3; n < vec.size( ); ++n ) {
+				daw::expecting( static_cast<std::int32_t>( n ), vec[n] );
+			}
+		}
+		// Shrinking keeps the first items
+		par::resize_and_overwrite( vec, 2, []( std::size_t ) { return -1; }, ts );
+		daw::expecting( 2U, vec.size( ) );
+		daw::expecting( 7, vec[1] );
+	}
+
+	void resize_and_overwrite_test_001( daw::task_scheduler ts ) {
+		resize_and_overwrite_test<std::vector<std::int32_t>>( ts );
+		resize_and_overwrite_test<
+		  std::vector<std::int32_t, par::default_init_allocator<std::int32_t>>>( ts );
+
+		// Items of a std::vector<bool> are not contiguous and share words, so
+		// they are written through the cache by one worker
+		auto bits = std::vector<bool>( 3, true );
+		par::resize_and_overwrite(
+		  bits,
+		  10'007,
+		  []( std::size_t n ) { return n % 3 == 0; },
+		  daw::task_scheduler( 1 ),
+		  par::store_policy::streaming );
+		daw::expecting( 10'007U, bits.size( ) );
+		for( std::size_t n = 0; n < bits.size( ); ++n ) {
+			daw::expecting( n < 3 or n % 3 == 0, static_cast<bool>( bits[n] ) );
+		}
+	}
+
+	void resize_and_overwrite_bench( std::size_t size ) {
+		auto const seq = daw::benchmark( [&]( ) {
+			auto vec = std::vector<double>( );
+			vec.reserve( size );
+			for( std::size_t n = 0; n < size; ++n ) {
+				vec.push_back( static_cast<double>( n ) );
+			}
+			daw::do_not_optimize( vec );
+		} );
+		auto const par_std = daw::benchmark( [&]( ) {
+			auto vec = std::vector<double>( );
+			par::resize_and_overwrite(
+			  vec, size, []( std::size_t n ) { return static_cast<double>( n ); } );
+			daw::do_not_optimize( vec );
+		} );
+		auto const par_default_init = daw::benchmark( [&]( ) {
+			auto vec = std::vector<double, par::default_init_allocator<double>>( );
+			par::resize_and_overwrite(
+			  vec, size, []( std::size_t n ) { return static_cast<double>( n ); } );
+			daw::do_not_optimize( vec );
+		} );
+		display_info( seq, par_std, size, sizeof( double ), "resize_and_overwrite" );
+		display_info( seq,
+		              par_default_init,
+		              size,
+		              sizeof( double ),
+		              "resize_and_overwrite default_init_allocator" );
+	}
+} // namespace
+
+int main( ) {
+	for_each_test_scheduler( []( daw::task_scheduler ts ) {
+		uninitialized_fill_test_001( ts );
+		uninitialized_transform_test_001( ts );
+		resize_and_overwrite_test_001( ts );
+	} );
+
+	std::cout << "resize_and_overwrite tests - double\n";
+	resize_and_overwrite_bench( LARGE_TEST_SZ );
+	for( std::size_t n = MAX_ITEMS; n >= 100; n /= 10 ) {
+		resize_and_overwrite_bench( n );
+	}
+}
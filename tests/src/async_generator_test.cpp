@@ -0,0 +1,199 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/async_generator.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+	/// Produces 0, 1, ... count - 1
+	auto make_counter( std::uint64_t count, std::size_t lookahead = 8 ) {
+		return daw::make_async_generator(
+		  [n = std::uint64_t{ 0 }, count]( ) mutable -> std::optional<std::uint64_t> {
+			  if( n == count ) {
+				  return { };
+			  }
+			  return n++;
+		  },
+		  lookahead );
+	}
+
+	void async_generator_test_001( ) {
+		auto gen = make_counter( 1'000 );
+		std::uint64_t expected = 0;
+		for( auto v : gen ) {
+			daw::expecting( expected, v );
+			++expected;
+		}
+		daw::expecting( std::uint64_t{ 1'000 }, expected );
+	}
+
+	void async_generator_test_002( ) {
+		// Stages are applied to each value as it is produced
+		auto gen = make_counter( 100 )
+		             .next( []( std::uint64_t v ) { return v * 2; } )
+		             .next( []( std::uint64_t v ) { return std::to_string( v ); } );
+		std::size_t count = 0;
+		std::size_t length = 0;
+		for( auto const &s : gen ) {
+			++count;
+			length += s.size( );
+		}
+		daw::expecting( std::size_t{ 100 }, count );
+		daw::expecting( std::size_t{ 245 }, length );
+	}
+
+	void async_generator_test_003( ) {
+		// The producer never runs more than lookahead values ahead of the consumer
+		constexpr std::size_t lookahead = 4;
+		auto produced = std::atomic<std::size_t>( 0 );
+		auto gen = daw::make_async_generator(
+		  [&produced]( ) -> std::optional<std::size_t> {
+			  auto const n = produced++;
+			  if( n == 100 ) {
+				  return { };
+			  }
+			  return n;
+		  },
+		  lookahead );
+		std::size_t consumed = 0;
+		for( auto v : gen ) {
+			daw::expecting( consumed, v );
+			++consumed;
+			// The value in hand was taken from the buffer, so one more is allowed
+			daw::expecting( produced.load( ) <= consumed + lookahead + 1 );
+		}
+		daw::expecting( std::size_t{ 100 }, consumed );
+	}
+
+	void async_generator_test_004( ) {
+		auto gen = daw::make_async_generator( [n = 0]( ) mutable -> std::optional<int> {
+			if( n == 10 ) {
+				throw std::runtime_error( "async_generator_test_004" );
+			}
+			return n++;
+		} );
+		daw::expecting_exception( [&]( ) {
+			for( auto v : gen ) {
+				(void)v;
+			}
+		} );
+	}
+
+	/// Just enough of a coroutine type to co_await a generator from a test
+	struct fire_and_forget {
+		struct promise_type {
+			fire_and_forget get_return_object( ) noexcept {
+				return { };
+			}
+			std::suspend_never initial_suspend( ) noexcept {
+				return { };
+			}
+			std::suspend_never final_suspend( ) noexcept {
+				return { };
+			}
+			void return_void( ) noexcept {}
+			void unhandled_exception( ) noexcept {
+				std::terminate( );
+			}
+		};
+	};
+
+	fire_and_forget sum_values( daw::async_generator<std::uint64_t> &gen,
+	                            std::uint64_t &sum,
+	                            std::atomic<bool> &is_done ) {
+		while( auto v = co_await gen ) {
+			sum += *v;
+		}
+		is_done = true;
+	}
+
+	void async_generator_test_005( ) {
+		auto gen = make_counter( 10'000, 16 );
+		std::uint64_t sum = 0;
+		auto is_done = std::atomic<bool>( false );
+		sum_values( gen, sum, is_done );
+		auto ts = daw::get_task_scheduler( );
+		while( not is_done ) {
+			if( not ts.help_run_next_task( ) ) {
+				std::this_thread::yield( );
+			}
+		}
+		daw::expecting( std::uint64_t{ 49'995'000 }, sum );
+	}
+
+	void async_generator_test_006( ) {
+		// Destroying the generator while it produces waits for the producer, so
+		// one referring to locals is not called after they are gone
+		std::atomic<std::size_t> calls = 0;
+		{
+			auto gen = daw::make_async_generator(
+			  [&calls]( ) -> std::optional<std::uint64_t> {
+				  std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+				  return ++calls;
+			  },
+			  64 );
+			// Start the producer on a worker without running it on this thread
+			auto awaiter = gen.operator co_await( );
+			(void)awaiter.await_ready( );
+			while( calls < 2 ) {
+				std::this_thread::yield( );
+			}
+		}
+		auto const calls_at_destruction = calls.load( );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+		daw::expecting( calls_at_destruction, calls.load( ) );
+	}
+
+	void async_generator_test_007( ) {
+		// Move assigning over a producing generator stops its producer too
+		std::atomic<std::size_t> calls = 0;
+		auto gen = daw::make_async_generator(
+		  [&calls]( ) -> std::optional<std::uint64_t> {
+			  std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+			  return ++calls;
+		  },
+		  64 );
+		auto awaiter = gen.operator co_await( );
+		(void)awaiter.await_ready( );
+		while( calls < 2 ) {
+			std::this_thread::yield( );
+		}
+		gen = make_counter( 10 );
+		auto const calls_at_assignment = calls.load( );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+		daw::expecting( calls_at_assignment, calls.load( ) );
+		std::uint64_t expected = 0;
+		for( auto v : gen ) {
+			daw::expecting( expected, v );
+			++expected;
+		}
+		daw::expecting( std::uint64_t{ 10 }, expected );
+	}
+} // namespace
+
+int main( ) {
+	async_generator_test_001( );
+	async_generator_test_002( );
+	async_generator_test_003( );
+	async_generator_test_004( );
+	async_generator_test_005( );
+	async_generator_test_006( );
+	async_generator_test_007( );
+}
@@ -20,6 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <cstddef>
 #include <iostream>
 #include <string>
 
@@ -45,6 +46,40 @@ void test_001( ) {
 	daw::expecting( 72, fs( 3 ).get( ) );
 }
 
+void test_002( ) {
+	constexpr auto fs = daw::compose_future( daw::continuation_policy::run_inline ) | a | b | c;
+	daw::expecting( 72, fs( 3 ).get( ) );
+}
+
+void test_003( ) {
+	constexpr auto fs = daw::compose_future( daw::continuation_policy::same_worker ) | a | b | c;
+	daw::expecting( 72, fs( 3 ).get( ) );
+}
+
+void test_004( ) {
+	// Each result replaces the arguments in the package, even as the type changes
+	auto const fs = daw::make_function_stream(
+	  a,
+	  []( int x ) { return std::to_string( x ); },
+	  []( std::string const &s ) { return s + s; },
+	  []( std::string const &s ) { return s.size( ); } );
+	daw::expecting( std::size_t{ 4 }, fs( 21 ).get( ) );
+}
+
+void test_005( ) {
+	// A freed package is reused by the next allocation of the same size
+	using pool_t = daw::impl::package_pool<64, alignof( std::max_align_t )>;
+	void *const p0 = pool_t::allocate( );
+	pool_t::deallocate( p0 );
+	void *const p1 = pool_t::allocate( );
+	daw::expecting( p0 == p1 );
+	pool_t::deallocate( p1 );
+}
+
 int main( ) {
 	test_001( );
+	test_002( );
+	test_003( );
+	test_004( );
+	test_005( );
 }
@@ -0,0 +1,115 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/function_stream.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace {
+	constexpr std::size_t const NUM_CALLS = 10'000;
+
+	constexpr std::uint64_t a( std::uint64_t x ) noexcept {
+		return x * 2;
+	}
+
+	constexpr std::uint64_t b( std::uint64_t x ) noexcept {
+		return x + 3;
+	}
+
+	constexpr std::uint64_t c( std::uint64_t x ) noexcept {
+		return x ^ 0x55U;
+	}
+
+	constexpr std::uint64_t abc( std::uint64_t x ) noexcept {
+		return c( b( a( x ) ) );
+	}
+
+	struct to_string_t {
+		std::string operator( )( std::uint64_t x ) const {
+			return std::to_string( x );
+		}
+	};
+} // namespace
+
+template<>
+inline constexpr bool daw::is_fusible_stage_v<to_string_t> = true;
+
+namespace {
+	template<typename FunctionStream>
+	constexpr std::size_t stage_count_v = std::tuple_size_v<
+	  daw::remove_cvref_t<decltype( std::declval<FunctionStream>( ).functions( ) )>>;
+
+	void fusion_test_001( ) {
+		constexpr auto f = daw::fuse( a, b, c );
+		static_assert( daw::is_fused_function_v<std::remove_cv_t<decltype( f )>> );
+		static_assert( f( 5 ) == abc( 5 ) );
+	}
+
+	void fusion_test_002( ) {
+		// Adjacent fusible stages become one, the others are left alone
+		auto fs = daw::make_function_stream( daw::fusible( a ),
+		                                     daw::fusible( b ),
+		                                     to_string_t{ },
+		                                     []( std::string const &s ) { return s.size( ); },
+		                                     daw::fuse( a, b ),
+		                                     daw::fusible( c ) );
+		static_assert( stage_count_v<decltype( fs )> == 3 );
+		daw::expecting( c( b( a( std::to_string( b( a( 7 ) ) ).size( ) ) ) ), fs( 7 ).get( ) );
+	}
+
+	void fusion_test_003( ) {
+		constexpr auto fs =
+		  daw::compose_future( ) | daw::fusible( a ) | daw::fusible( b ) | daw::fusible( c );
+		static_assert( stage_count_v<decltype( fs.get_function_stream( ) )> == 1 );
+		daw::expecting( abc( 3 ), fs( 3 ).get( ) );
+	}
+
+	void fusion_bench_001( ) {
+		auto const unfused = daw::make_function_stream( a, b, c, a, b, c, a, b, c );
+		auto const fused = daw::make_function_stream( daw::fuse( a, b, c, a, b, c, a, b, c ) );
+
+		auto results = std::vector<daw::future_result_t<std::uint64_t>>( );
+		results.reserve( NUM_CALLS );
+		auto const run = [&]( auto const &fs ) {
+			results.clear( );
+			for( std::size_t n = 0; n < NUM_CALLS; ++n ) {
+				results.push_back( fs( n ) );
+			}
+			std::uint64_t sum = 0;
+			for( auto &r : results ) {
+				sum += r.get( );
+			}
+			return sum;
+		};
+
+		std::uint64_t unfused_sum = 0;
+		std::uint64_t fused_sum = 0;
+		auto const t_unfused = daw::benchmark( [&]( ) { unfused_sum = run( unfused ); } );
+		auto const t_fused = daw::benchmark( [&]( ) { fused_sum = run( fused ); } );
+		daw::expecting( unfused_sum, fused_sum );
+
+		std::cout << NUM_CALLS << " calls of a 9 function stream\n";
+		std::cout << "\tunfused: " << daw::utility::format_seconds( t_unfused, 3 ) << '\n';
+		std::cout << "\tfused:   " << daw::utility::format_seconds( t_fused, 3 ) << '\n';
+	}
+} // namespace
+
+int main( ) {
+	fusion_test_001( );
+	fusion_test_002( );
+	fusion_test_003( );
+	fusion_bench_001( );
+}
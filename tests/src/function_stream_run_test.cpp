@@ -0,0 +1,285 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/function_stream.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+	constexpr std::size_t const NUM_ITEMS = 1'000'000;
+
+	std::uint64_t a( std::uint64_t x ) noexcept {
+		return x * 2;
+	}
+
+	std::uint64_t b( std::uint64_t x ) noexcept {
+		return x + 3;
+	}
+
+	std::uint64_t c( std::uint64_t x ) noexcept {
+		return x ^ 0x55U;
+	}
+
+	std::vector<std::uint64_t> make_input( std::size_t count ) {
+		auto result = std::vector<std::uint64_t>( count );
+		std::iota( result.begin( ), result.end( ), std::uint64_t{ 0 } );
+		return result;
+	}
+
+	void run_test_001( ) {
+		auto const input = make_input( 10'000 );
+		auto results = std::vector<std::uint64_t>( );
+		results.reserve( input.size( ) );
+
+		auto fs = daw::make_function_stream( a, b, c );
+		fs.run( input, [&results]( std::uint64_t v ) { results.push_back( v ); }, 16 );
+
+		daw::expecting( input.size( ), results.size( ) );
+		for( std::size_t n = 0; n < input.size( ); ++n ) {
+			daw::expecting( c( b( a( input[n] ) ) ), results[n] );
+		}
+	}
+
+	void run_test_002( ) {
+		// Stages change type and the last one returns void
+		auto const input = make_input( 1'000 );
+		std::size_t count = 0;
+		std::size_t total_length = 0;
+		auto fs = daw::make_function_stream(
+		  []( std::uint64_t v ) { return std::to_string( v ); },
+		  [&total_length]( std::string const &s ) { total_length += s.size( ); } );
+		fs.run( input, [&count]( ) { ++count; }, 4 );
+
+		daw::expecting( input.size( ), count );
+		daw::expecting( std::size_t{ 2890 }, total_length );
+	}
+
+	void run_test_003( ) {
+		auto const input = make_input( 10'000 );
+		auto fs = daw::make_function_stream( a, []( std::uint64_t v ) {
+			if( v == 5'000 ) {
+				throw std::runtime_error( "run_test_003" );
+			}
+			return v;
+		} );
+		daw::expecting_exception( [&]( ) { fs.run( input, []( std::uint64_t ) {}, 32 ); } );
+	}
+
+	void run_test_004( ) {
+		// A parallel stage in the middle keeps the input order when ordered
+		auto const input = make_input( 10'000 );
+		auto results = std::vector<std::uint64_t>( );
+		results.reserve( input.size( ) );
+
+		auto fs = daw::make_function_stream( a, daw::parallel_stage( b, 4 ), c );
+		fs.run( input, [&results]( std::uint64_t v ) { results.push_back( v ); }, 64 );
+
+		daw::expecting( input.size( ), results.size( ) );
+		for( std::size_t n = 0; n < input.size( ); ++n ) {
+			daw::expecting( c( b( a( input[n] ) ) ), results[n] );
+		}
+	}
+
+	void run_test_005( ) {
+		// Unordered, every result still arrives exactly once
+		auto const input = make_input( 10'000 );
+		auto results = std::vector<std::uint64_t>( );
+		results.reserve( input.size( ) );
+
+		auto fs =
+		  daw::make_function_stream( a, daw::parallel_stage( b, 3, daw::parallel_order::unordered ) );
+		fs.run( input, [&results]( std::uint64_t v ) { results.push_back( v ); }, 32 );
+
+		daw::expecting( input.size( ), results.size( ) );
+		std::sort( results.begin( ), results.end( ) );
+		for( std::size_t n = 0; n < input.size( ); ++n ) {
+			daw::expecting( b( a( input[n] ) ), results[n] );
+		}
+	}
+
+	void run_test_006( ) {
+		// A failing item in an ordered parallel stage does not hold back the rest
+		auto const input = make_input( 10'000 );
+		auto fs = daw::make_function_stream( daw::parallel_stage(
+		  []( std::uint64_t v ) {
+			  if( v == 5'000 ) {
+				  throw std::runtime_error( "run_test_006" );
+			  }
+			  return v;
+		  },
+		  4 ) );
+		daw::expecting_exception( [&]( ) { fs.run( input, []( std::uint64_t ) {}, 32 ); } );
+	}
+
+	/// Counts the copies made of a buffer
+	struct tracked_buffer {
+		static inline std::atomic<std::size_t> copies = 0;
+		std::vector<std::uint64_t> data;
+
+		explicit tracked_buffer( std::size_t size )
+		  : data( size ) {}
+
+		tracked_buffer( tracked_buffer const &other )
+		  : data( other.data ) {
+			++copies;
+		}
+
+		tracked_buffer &operator=( tracked_buffer const &rhs ) {
+			data = rhs.data;
+			++copies;
+			return *this;
+		}
+
+		tracked_buffer( tracked_buffer && ) noexcept = default;
+		tracked_buffer &operator=( tracked_buffer && ) noexcept = default;
+		~tracked_buffer( ) = default;
+	};
+
+	tracked_buffer &fill_buffer( tracked_buffer &buff ) {
+		std::iota( buff.data.begin( ), buff.data.end( ), std::uint64_t{ 0 } );
+		return buff;
+	}
+
+	tracked_buffer &double_buffer( tracked_buffer &buff ) {
+		for( auto &v : buff.data ) {
+			v *= 2;
+		}
+		return buff;
+	}
+
+	std::uint64_t sum_buffer( tracked_buffer const &buff ) {
+		return std::accumulate( buff.data.begin( ), buff.data.end( ), std::uint64_t{ 0 } );
+	}
+
+	void run_test_007( ) {
+		// Stages that modify their buffer in place and return it by reference
+		// pass it on without a copy
+		auto const input = make_input( 100 );
+		std::uint64_t sum = 0;
+		auto fs = daw::make_function_stream( []( std::uint64_t n ) { return tracked_buffer( n ); },
+		                                     fill_buffer,
+		                                     double_buffer,
+		                                     sum_buffer );
+		tracked_buffer::copies = 0;
+		fs.run( input, [&sum]( std::uint64_t v ) { sum += v; }, 8 );
+		daw::expecting( std::size_t{ 0 }, tracked_buffer::copies.load( ) );
+		daw::expecting( std::uint64_t{ 323'400 }, sum );
+
+		auto result = daw::make_function_stream( fill_buffer, double_buffer )( tracked_buffer( 1000 ) );
+		daw::expecting( std::uint64_t{ 999'000 }, sum_buffer( result.get( ) ) );
+		daw::expecting( std::size_t{ 0 }, tracked_buffer::copies.load( ) );
+	}
+
+	/// Throws when copied with value 5'000, as feeding it to a stream does
+	struct throwing_copy {
+		std::uint64_t value = 0;
+
+		explicit throwing_copy( std::uint64_t v )
+		  : value( v ) {}
+
+		throwing_copy( throwing_copy const &other )
+		  : value( other.value ) {
+			if( value == 5'000 ) {
+				throw std::runtime_error( "run_test_008" );
+			}
+		}
+
+		throwing_copy &operator=( throwing_copy const & ) = default;
+	};
+
+	void run_test_008( ) {
+		// Reading the input fails with items in flight, they reach the sink
+		// before run rethrows and none after
+		auto input = std::vector<throwing_copy>( );
+		input.reserve( 10'000 );
+		for( std::uint64_t n = 0; n < 10'000; ++n ) {
+			input.emplace_back( n );
+		}
+		std::atomic<std::size_t> count = 0;
+		auto fs = daw::make_function_stream( []( throwing_copy const &v ) { return v.value; },
+		                                     daw::parallel_stage( b, 4 ) );
+		daw::expecting_exception(
+		  [&]( ) { fs.run( input, [&count]( std::uint64_t ) { ++count; }, 32 ); } );
+		auto const count_at_return = count.load( );
+		daw::expecting( count_at_return <= 5'000U );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+		daw::expecting( count_at_return, count.load( ) );
+	}
+
+	void run_bench_001( ) {
+		auto const input = make_input( NUM_ITEMS );
+		std::uint64_t sum = 0;
+		auto const sink = [&sum]( std::uint64_t v ) { sum += v; };
+		auto fs = daw::make_function_stream( a, b, c );
+
+		auto const t_hand = daw::benchmark( [&]( ) {
+			for( auto v : input ) {
+				sink( c( b( a( v ) ) ) );
+			}
+		} );
+		auto const expected_sum = std::exchange( sum, 0 );
+
+		auto const t_run = daw::benchmark( [&]( ) { fs.run( input, sink ); } );
+		daw::expecting( expected_sum, sum );
+
+		std::cout << "stream of " << NUM_ITEMS << " items\n";
+		std::cout << "\thand written: " << daw::utility::format_seconds( t_hand, 3 ) << '\n';
+		std::cout << "\trun:          " << daw::utility::format_seconds( t_run, 3 ) << '\n';
+	}
+
+	void run_bench_002( ) {
+		// The middle stage is the bottleneck, it waits instead of computing so the
+		// gain does not depend on the number of cores
+		constexpr std::size_t item_count = 200;
+		auto const input = make_input( item_count );
+		auto const slow = []( std::uint64_t v ) {
+			std::this_thread::sleep_for( std::chrono::microseconds( 500 ) );
+			return b( v );
+		};
+		std::uint64_t sum = 0;
+		auto const sink = [&sum]( std::uint64_t v ) { sum += v; };
+
+		auto serial = daw::make_function_stream( a, slow, c );
+		auto const t_serial = daw::benchmark( [&]( ) { serial.run( input, sink ); } );
+		auto const expected_sum = std::exchange( sum, 0 );
+
+		auto parallel = daw::make_function_stream( a, daw::parallel_stage( slow, 8 ), c );
+		auto const t_parallel = daw::benchmark( [&]( ) { parallel.run( input, sink ); } );
+		daw::expecting( expected_sum, sum );
+
+		std::cout << "stream of " << item_count << " items with a slow stage\n";
+		std::cout << "\tserial stage:   " << daw::utility::format_seconds( t_serial, 3 ) << '\n';
+		std::cout << "\tparallel stage: " << daw::utility::format_seconds( t_parallel, 3 ) << '\n';
+	}
+} // namespace
+
+int main( ) {
+	run_test_001( );
+	run_test_002( );
+	run_test_003( );
+	run_test_004( );
+	run_test_005( );
+	run_test_006( );
+	run_test_007( );
+	run_test_008( );
+	run_bench_001( );
+	run_bench_002( );
+}
@@ -23,6 +23,9 @@
 #include <cmath>
 #include <exception>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <daw/daw_benchmark.h>
 #include <daw/daw_size_literals.h>
@@ -168,9 +171,39 @@ void future_result_test_010( ) {
 	daw::expecting( result, 42 );
 }
 
+void continuation_policy_test_001( ) {
+	auto const add_one = []( int i ) { return i + 1; };
+	auto f1 = daw::async( []( ) { return 0; } )
+	            .next( daw::continuation_policy::run_inline, add_one )
+	            .next( daw::continuation_policy::same_worker, add_one )
+	            .next( daw::continuation_policy::scheduled, add_one );
+	daw::expecting( 3, f1.get( ) );
+}
+
+void continuation_policy_test_002( ) {
+	// Chains longer than max_inline_continuation_depth must not overflow the
+	// stack
+	constexpr int chain_length = 1000;
+	auto start = daw::future_result_t<int>( );
+	auto last = start.next( daw::continuation_policy::run_inline, []( int i ) { return i + 1; } );
+	for( int n = 1; n < chain_length; ++n ) {
+		last = last.next( daw::continuation_policy::run_inline, []( int i ) { return i + 1; } );
+	}
+	start.set_value( 0 );
+	daw::expecting( chain_length, last.get( ) );
+}
+
+void continuation_policy_test_003( ) {
+	auto f1 = daw::async( []( ) { return 6; } )
+	            .fork_join( daw::continuation_policy::run_inline,
+	                        []( int a, int b ) { return a * b; },
+	                        []( int const &v ) { return v; },
+	                        []( int const &v ) { return v + 1; } );
+	daw::expecting( 42, f1.get( ) );
+}
+
 void fork_join_test_001( ) {
-	/*
-	auto const f1 =
+	auto f1 =
 	  daw::async( []( ) { return std::string( "Hello" ); } )
 	    .fork_join(
 	      []( char a, char b, char c, char d, char e ) {
@@ -188,8 +221,33 @@ void fork_join_test_001( ) {
 	      []( std::string const &s ) -> char { return s[3] | ' '; },
 	      []( std::string const &s ) -> char { return s[4] | ' '; } );
 
-	daw::expecting( f1.get( ) = "hello" );
-	      */
+	daw::expecting( std::string( "hello" ), f1.get( ) );
+}
+
+void fork_join_test_002( ) {
+	auto f1 = daw::async( []( ) { return 21; } )
+	            .fork_join( []( int a, int b ) { return a + b; },
+	                        []( int const &v ) -> int {
+		                        if( v > 0 ) {
+			                        throw std::runtime_error( "fork_join_test_002" );
+		                        }
+		                        return v;
+	                        },
+	                        []( int const &v ) { return v; } );
+	daw::expecting_exception( [&f1]( ) { (void)f1.get( ); } );
+}
+
+void reduce_futures_test_001( ) {
+	// Each future is combined once, for odd and even counts
+	for( int count = 1; count <= 9; ++count ) {
+		auto futures = std::vector<daw::future_result_t<int>>( );
+		for( int n = 1; n <= count; ++n ) {
+			futures.push_back( daw::async( [n]( ) { return n; } ) );
+		}
+		auto result =
+		  daw::reduce_futures( futures.begin( ), futures.end( ), []( int a, int b ) { return a + b; } );
+		daw::expecting( count * ( count + 1 ) / 2, result.get( ) );
+	}
 }
 
 int main( ) {
@@ -203,5 +261,10 @@ int main( ) {
 	future_result_test_008( );
 	future_result_test_009( );
 	future_result_test_010( );
+	continuation_policy_test_001( );
+	continuation_policy_test_002( );
+	continuation_policy_test_003( );
 	fork_join_test_001( );
+	fork_join_test_002( );
+	reduce_futures_test_001( );
 }
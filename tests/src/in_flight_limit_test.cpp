@@ -0,0 +1,110 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/function_stream.h"
+#include "daw/fs/future_result.h"
+#include "daw/fs/in_flight_limit.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace {
+	/// Counts how many calls are running at once
+	struct concurrency_counter {
+		std::atomic<std::size_t> running = 0;
+		std::atomic<std::size_t> max_running = 0;
+
+		void enter( ) {
+			auto const now = ++running;
+			auto seen = max_running.load( );
+			while( seen < now and not max_running.compare_exchange_weak( seen, now ) ) {}
+		}
+
+		void leave( ) {
+			--running;
+		}
+	};
+
+	void in_flight_limit_test_001( daw::in_flight_policy policy ) {
+		constexpr std::size_t max_in_flight = 4;
+		auto limit = daw::in_flight_limit( max_in_flight, policy );
+		auto counter = concurrency_counter( );
+		auto fs = daw::make_function_stream(
+		  [&counter]( int x ) {
+			  counter.enter( );
+			  return x;
+		  },
+		  [&counter]( int x ) {
+			  counter.leave( );
+			  return x * 2;
+		  } );
+		fs.limit = &limit;
+
+		auto results = std::vector<daw::future_result_t<int>>( );
+		for( int n = 0; n < 1'000; ++n ) {
+			results.push_back( fs( n ) );
+			daw::expecting( limit.size( ) <= max_in_flight );
+		}
+		for( int n = 0; n < 1'000; ++n ) {
+			daw::expecting( n * 2, results[static_cast<std::size_t>( n )].get( ) );
+		}
+		daw::expecting( counter.max_running.load( ) <= max_in_flight );
+	}
+
+	void in_flight_limit_test_002( ) {
+		// A call past the limit is refused instead of queued
+		auto limit = daw::in_flight_limit( 1, daw::in_flight_policy::would_block );
+		auto is_released = std::atomic<bool>( false );
+		auto fs = daw::make_function_stream( [&is_released]( int x ) {
+			while( not is_released.load( ) ) {
+				std::this_thread::yield( );
+			}
+			return x;
+		} );
+		fs.limit = &limit;
+
+		auto first = fs( 1 );
+		auto second = fs( 2 );
+		daw::expecting_exception<daw::would_block_exception>( [&]( ) { (void)second.get( ); } );
+		is_released = true;
+		daw::expecting( 1, first.get( ) );
+	}
+
+	void in_flight_limit_test_003( ) {
+		constexpr std::size_t max_in_flight = 3;
+		auto limit = daw::in_flight_limit( max_in_flight );
+		auto counter = concurrency_counter( );
+		auto results = std::vector<daw::future_result_t<std::size_t>>( );
+		for( std::size_t n = 0; n < 100; ++n ) {
+			results.push_back( daw::make_future_result(
+			  limit,
+			  [&counter]( std::size_t x ) {
+				  counter.enter( );
+				  counter.leave( );
+				  return x + 1;
+			  },
+			  n ) );
+		}
+		for( std::size_t n = 0; n < results.size( ); ++n ) {
+			daw::expecting( n + 1, results[n].get( ) );
+		}
+		daw::expecting( counter.max_running.load( ) <= max_in_flight );
+	}
+} // namespace
+
+int main( ) {
+	in_flight_limit_test_001( daw::in_flight_policy::help );
+	in_flight_limit_test_001( daw::in_flight_policy::block );
+	in_flight_limit_test_002( );
+	in_flight_limit_test_003( );
+}
@@ -0,0 +1,128 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/function_stream.h"
+#include "daw/fs/memoize.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	void memoize_test_001( daw::memo_eviction eviction ) {
+		std::size_t calls = 0;
+		auto const square = daw::memoize<int>(
+		  [&calls]( int x ) {
+			  ++calls;
+			  return x * x;
+		  },
+		  daw::memo_options{ 1024U * 1024U, 4, eviction } );
+
+		for( int n = 0; n < 3; ++n ) {
+			for( int x = 0; x < 10; ++x ) {
+				daw::expecting( x * x, square( x ) );
+			}
+		}
+		daw::expecting( std::size_t{ 10 }, calls );
+		auto const stats = square.stats( );
+		daw::expecting( std::size_t{ 20 }, stats.hits );
+		daw::expecting( std::size_t{ 10 }, stats.misses );
+		daw::expecting( std::size_t{ 0 }, stats.evictions );
+		daw::expecting( std::size_t{ 10 }, stats.size );
+	}
+
+	void memoize_test_002( daw::memo_eviction eviction ) {
+		// A budget of a few entries keeps the size bounded and evicts
+		auto const f = daw::memoize<std::uint64_t>( []( std::uint64_t x ) { return x + 1; },
+		                                            daw::memo_options{ 512, 1, eviction } );
+		for( std::uint64_t x = 0; x < 1'000; ++x ) {
+			daw::expecting( x + 1, f( x ) );
+		}
+		auto const stats = f.stats( );
+		daw::expecting( stats.size < 100 );
+		daw::expecting( std::size_t{ 1'000 } - stats.size, stats.evictions );
+	}
+
+	void memoize_test_003( ) {
+		// The most recently used entry survives under LRU
+		auto const f = daw::memoize<int, int>( []( int a, int b ) { return a * b; },
+		                                       daw::memo_options{ 1, 1, daw::memo_eviction::lru } );
+		daw::expecting( 6, f( 2, 3 ) );
+		daw::expecting( 20, f( 4, 5 ) );
+		daw::expecting( 20, f( 4, 5 ) );
+		daw::expecting( std::size_t{ 1 }, f.stats( ).hits );
+		daw::expecting( std::size_t{ 1 }, f.stats( ).evictions );
+	}
+
+	void memoize_test_004( ) {
+		// A memoized stage of a function_stream, all copies share the cache
+		auto const input = [] {
+			auto result = std::vector<std::uint64_t>( );
+			for( std::uint64_t n = 0; n < 10'000; ++n ) {
+				result.push_back( n % 16 );
+			}
+			return result;
+		}( );
+		auto const to_string = daw::memoize<std::uint64_t>(
+		  []( std::uint64_t x ) { return std::to_string( x ); },
+		  daw::memo_options{ 1024U * 1024U, 16, daw::memo_eviction::clock } );
+		std::size_t total = 0;
+		auto fs =
+		  daw::make_function_stream( to_string, []( std::string const &s ) { return s.size( ); } );
+		fs.run( input, [&total]( std::size_t len ) { total += len; } );
+
+		daw::expecting( std::size_t{ 13'750 }, total );
+		auto const stats = to_string.stats( );
+		daw::expecting( input.size( ), stats.hits + stats.misses );
+		daw::expecting( stats.misses >= 16 );
+		daw::expecting( std::size_t{ 16 }, stats.size );
+	}
+
+	void memoize_bench_001( ) {
+		constexpr std::size_t item_count = 2'000;
+		auto const slow = []( std::uint64_t x ) {
+			std::this_thread::sleep_for( std::chrono::microseconds( 50 ) );
+			return x * 3;
+		};
+		auto input = std::vector<std::uint64_t>( );
+		for( std::uint64_t n = 0; n < item_count; ++n ) {
+			input.push_back( n % 64 );
+		}
+		std::uint64_t sum = 0;
+		auto const sink = [&sum]( std::uint64_t v ) { sum += v; };
+
+		auto plain = daw::make_function_stream( slow );
+		auto const t_plain = daw::benchmark( [&]( ) { plain.run( input, sink ); } );
+		auto const expected_sum = std::exchange( sum, 0 );
+
+		auto memoized = daw::make_function_stream( daw::memoize<std::uint64_t>( slow ) );
+		auto const t_memo = daw::benchmark( [&]( ) { memoized.run( input, sink ); } );
+		daw::expecting( expected_sum, sum );
+
+		std::cout << item_count << " items with 64 distinct keys\n";
+		std::cout << "\tplain:    " << daw::utility::format_seconds( t_plain, 3 ) << '\n';
+		std::cout << "\tmemoized: " << daw::utility::format_seconds( t_memo, 3 ) << '\n';
+	}
+} // namespace
+
+int main( ) {
+	memoize_test_001( daw::memo_eviction::lru );
+	memoize_test_001( daw::memo_eviction::clock );
+	memoize_test_002( daw::memo_eviction::lru );
+	memoize_test_002( daw::memo_eviction::clock );
+	memoize_test_003( );
+	memoize_test_004( );
+	memoize_bench_001( );
+}
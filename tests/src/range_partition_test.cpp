@@ -0,0 +1,159 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/algorithms.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace {
+	void range_partition_test_001( ) {
+		// Parts cover the range in order and differ in size by at most one
+		auto values = std::vector<int>( 10 );
+		auto const parts =
+		  daw::algorithm::parallel::impl::range_partition( values.begin( ), values.size( ), 3 );
+		daw::expecting( std::size_t{ 3 }, parts.size( ) );
+		daw::expecting( std::size_t{ 4 }, parts[0].size( ) );
+		daw::expecting( std::size_t{ 3 }, parts[1].size( ) );
+		daw::expecting( std::size_t{ 3 }, parts[2].size( ) );
+		daw::expecting( values.begin( ) == parts[0].begin( ) );
+		daw::expecting( parts[0].end( ) == parts[1].begin( ) );
+		daw::expecting( parts[1].end( ) == parts[2].begin( ) );
+		daw::expecting( values.end( ) == parts[2].end( ) );
+
+		// A slice has the bounds of the parts it was taken from
+		auto const rest = parts.slice( 1, 3 );
+		daw::expecting( std::size_t{ 2 }, rest.size( ) );
+		for( std::size_t n = 0; n < rest.size( ); ++n ) {
+			daw::expecting( parts[n + 1].begin( ) == rest[n].begin( ) );
+			daw::expecting( parts[n + 1].end( ) == rest[n].end( ) );
+		}
+	}
+
+	void range_partition_test_002( ) {
+		// Parts are no smaller than the minimum size unless the range is
+		auto values = std::vector<int>( 10 );
+		auto const split = daw::algorithm::parallel::impl::split_range_t<4>{ };
+		daw::expecting( std::size_t{ 2 }, split( values.begin( ), values.end( ), 8 ).size( ) );
+		daw::expecting( std::size_t{ 1 }, split( values.begin( ), values.begin( ) + 3, 8 ).size( ) );
+		daw::expecting( split( values.begin( ), values.begin( ), 8 ).empty( ) );
+	}
+
+	void range_partition_test_003( ) {
+		// equal and for_each_index over a size that does not split evenly
+		auto const a = [] {
+			auto result = std::vector<std::int64_t>( 100'003 );
+			std::iota( result.begin( ), result.end( ), 0 );
+			return result;
+		}( );
+		auto b = a;
+		daw::expecting( daw::algorithm::parallel::equal( a.begin( ), a.end( ), b.begin( ), b.end( ) ) );
+		b.back( ) = -1;
+		daw::expecting(
+		  not daw::algorithm::parallel::equal( a.begin( ), a.end( ), b.begin( ), b.end( ) ) );
+
+		auto seen = std::vector<std::atomic<int>>( a.size( ) );
+		daw::algorithm::parallel::for_each_index(
+		  a.begin( ), a.end( ), [&seen]( std::size_t n ) { ++seen[n]; } );
+		for( auto const &s : seen ) {
+			daw::expecting( 1, s.load( ) );
+		}
+	}
+
+	void range_partition_test_004( ) {
+		// Boundaries after the first fall on cache lines of the items written,
+		// and a transform with them gives the same result
+		auto const in = [] {
+			auto result = std::vector<std::int32_t>( 100'003 );
+			std::iota( result.begin( ), result.end( ), 0 );
+			return result;
+		}( );
+		auto out = std::vector<std::int32_t>( in.size( ) + 1 );
+		// Start out away from the alignment of in
+		auto const first_out = out.data( ) + 1;
+		auto const parts = daw::algorithm::parallel::aligned_range_splitter<>{ }(
+		  in.begin( ), in.end( ), 7, first_out );
+		daw::expecting( std::size_t{ 7 }, parts.size( ) );
+		daw::expecting( in.begin( ) == parts[0].begin( ) );
+		daw::expecting( in.end( ) == parts[6].end( ) );
+		for( std::size_t n = 1; n < parts.size( ); ++n ) {
+			daw::expecting( parts[n - 1].end( ) == parts[n].begin( ) );
+			auto const pos = parts[n].begin( ) - in.begin( );
+			daw::expecting( reinterpret_cast<std::uintptr_t>( first_out + pos ) % 64U == 0U );
+		}
+
+		daw::algorithm::parallel::transform(
+		  in.begin( ), in.end( ), first_out, []( std::int32_t v ) { return v * 2; } );
+		for( std::size_t n = 0; n < in.size( ); ++n ) {
+			daw::expecting( in[n] * 2, first_out[n] );
+		}
+	}
+
+	template<typename PartitionPolicy>
+	double time_transform( std::vector<std::int32_t> const &in, std::vector<std::int32_t> &out ) {
+		return daw::benchmark( [&]( ) {
+			for( std::size_t n = 0; n < 100; ++n ) {
+				daw::algorithm::parallel::impl::parallel_map<PartitionPolicy>(
+				  daw::view( in.begin( ), in.end( ) ),
+				  out.begin( ),
+				  []( std::int32_t v ) { return v + 1; },
+				  daw::get_task_scheduler( ) );
+			}
+		} );
+	}
+
+	void range_partition_bench_002( ) {
+		// Small items written by many tasks, where parts split at arbitrary
+		// items share cache lines at their edges
+		auto const in = std::vector<std::int32_t>( 1'000'003, 1 );
+		auto out = std::vector<std::int32_t>( in.size( ) );
+		auto const t_split =
+		  time_transform<daw::algorithm::parallel::default_range_splitter<>>( in, out );
+		auto const t_aligned =
+		  time_transform<daw::algorithm::parallel::aligned_range_splitter<>>( in, out );
+		daw::expecting( 2, out.back( ) );
+
+		std::cout << "100 int32_t transforms of " << in.size( ) << " items\n";
+		std::cout << "\tarbitrary boundaries:  " << daw::utility::format_seconds( t_split, 3 )
+		          << '\n';
+		std::cout << "\tcache line boundaries: " << daw::utility::format_seconds( t_aligned, 3 )
+		          << '\n';
+	}
+
+	void range_partition_bench_001( ) {
+		// Many small calls, where splitting is a larger share of the work
+		auto const a = std::vector<std::int64_t>( 10'000, 1 );
+		auto const b = a;
+		std::size_t equal_count = 0;
+		auto const t = daw::benchmark( [&]( ) {
+			for( std::size_t n = 0; n < 1'000; ++n ) {
+				if( daw::algorithm::parallel::equal( a.begin( ), a.end( ), b.begin( ), b.end( ) ) ) {
+					++equal_count;
+				}
+			}
+		} );
+		daw::expecting( std::size_t{ 1'000 }, equal_count );
+		std::cout << "1000 equal calls of 10000 items: " << daw::utility::format_seconds( t, 3 )
+		          << '\n';
+	}
+} // namespace
+
+int main( ) {
+	range_partition_test_001( );
+	range_partition_test_002( );
+	range_partition_test_003( );
+	range_partition_test_004( );
+	range_partition_bench_001( );
+	range_partition_bench_002( );
+}
@@ -0,0 +1,93 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/algorithms.h"
+#include "daw/fs/scratch_arena.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory_resource>
+#include <numeric>
+#include <vector>
+
+namespace {
+	void scratch_arena_test_001( ) {
+		// Memory released to a mark is reused by the next allocation
+		auto arena = daw::algorithm::parallel::scratch_arena( 1024 );
+		auto const m = arena.mark( );
+		void *const first = arena.allocate( 100, 8 );
+		arena.release( m );
+		void *const second = arena.allocate( 100, 8 );
+		daw::expecting( first == second );
+		daw::expecting( std::size_t{ 1024 }, arena.capacity( ) );
+	}
+
+	void scratch_arena_test_002( ) {
+		// Allocations larger than a block, and over aligned, get a block of their own
+		auto arena = daw::algorithm::parallel::scratch_arena( 1024 );
+		(void)arena.allocate( 10, 1 );
+		void *const ptr = arena.allocate( 4096, 64 );
+		daw::expecting( reinterpret_cast<std::uintptr_t>( ptr ) % 64U == 0U );
+		daw::expecting( arena.capacity( ) >= 1024U + 4096U );
+	}
+
+	void scratch_arena_test_003( ) {
+		// The algorithms take their bookkeeping from the arena in use and give it
+		// all back, so repeated calls do not grow it
+		auto const values = [] {
+			auto result = std::vector<std::int64_t>( 100'000 );
+			std::iota( result.begin( ), result.end( ), 0 );
+			return result;
+		}( );
+		auto arena = daw::algorithm::parallel::scratch_arena( );
+		auto const scope = daw::algorithm::parallel::use_scratch_arena( arena );
+		auto const expected = std::accumulate( values.begin( ), values.end( ), std::int64_t{ 0 } );
+
+		daw::expecting(
+		  expected,
+		  daw::algorithm::parallel::reduce( values.begin( ), values.end( ), std::int64_t{ 0 } ) );
+		auto const capacity = arena.capacity( );
+		daw::expecting( capacity > 0U );
+		auto const m = arena.mark( );
+		for( std::size_t n = 0; n < 100; ++n ) {
+			daw::expecting(
+			  expected,
+			  daw::algorithm::parallel::reduce( values.begin( ), values.end( ), std::int64_t{ 0 } ) );
+			daw::expecting( values.begin( ) + 99'999,
+			                daw::algorithm::parallel::max_element( values.begin( ), values.end( ) ) );
+		}
+		daw::expecting( capacity, arena.capacity( ) );
+		auto const after = arena.mark( );
+		daw::expecting( m.block == after.block and m.offset == after.offset );
+	}
+
+	void scratch_arena_bench_001( ) {
+		// Many small calls, where the bookkeeping is a larger share of the work
+		auto const values = std::vector<std::int64_t>( 10'000, 1 );
+		std::int64_t sum = 0;
+		auto const t = daw::benchmark( [&]( ) {
+			for( std::size_t n = 0; n < 1'000; ++n ) {
+				sum +=
+				  daw::algorithm::parallel::reduce( values.begin( ), values.end( ), std::int64_t{ 0 } );
+			}
+		} );
+		daw::expecting( std::int64_t{ 10'000'000 }, sum );
+		std::cout << "1000 reduce calls of 10000 items: " << daw::utility::format_seconds( t, 3 )
+		          << '\n';
+	}
+} // namespace
+
+int main( ) {
+	scratch_arena_test_001( );
+	scratch_arena_test_002( );
+	scratch_arena_test_003( );
+	scratch_arena_bench_001( );
+}
@@ -0,0 +1,115 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/task_graph.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+	void task_graph_test_001( ) {
+		// A diamond, d must see the work of b and c which must see a's
+		int a = 0;
+		int b = 0;
+		int c = 0;
+		int d = 0;
+		auto graph = daw::task_graph( );
+		auto const na = graph.add_node( [&]( ) { a = 1; } );
+		auto const nb = graph.add_node( [&]( ) { b = a + 1; } );
+		auto const nc = graph.add_node( [&]( ) { c = a + 2; } );
+		auto const nd = graph.add_node( [&]( ) { d = b + c; } );
+		graph.add_edge( na, nb );
+		graph.add_edge( na, nc );
+		graph.add_edge( nb, nd );
+		graph.add_edge( nc, nd );
+		graph.run( );
+		daw::expecting( 5, d );
+	}
+
+	void task_graph_test_002( ) {
+		// The same graph is run many times without being rebuilt
+		constexpr std::size_t width = 16;
+		auto count = std::atomic<std::size_t>( 0 );
+		std::size_t total = 0;
+		auto graph = daw::task_graph( );
+		auto const source = graph.add_node( [] {} );
+		auto const sink = graph.add_node( [&]( ) { total += count.exchange( 0 ); } );
+		for( std::size_t n = 0; n < width; ++n ) {
+			auto const node = graph.add_node( [&]( ) { ++count; } );
+			graph.add_edge( source, node );
+			graph.add_edge( node, sink );
+		}
+		for( std::size_t n = 0; n < 100; ++n ) {
+			graph.run( );
+		}
+		daw::expecting( width * 100, total );
+	}
+
+	void task_graph_test_003( ) {
+		// The exception of a node is rethrown and the nodes after it do not run
+		bool after_ran = false;
+		auto graph = daw::task_graph( );
+		auto const thrower =
+		  graph.add_node( [] { throw std::runtime_error( "task_graph_test_003" ); } );
+		auto const after = graph.add_node( [&]( ) { after_ran = true; } );
+		graph.add_edge( thrower, after );
+		daw::expecting_exception( [&]( ) { graph.run( ); } );
+		daw::expecting( not after_ran );
+	}
+
+	void task_graph_test_004( ) {
+		auto graph = daw::task_graph( );
+		auto const a = graph.add_node( [] {} );
+		auto const b = graph.add_node( [] {} );
+		graph.add_edge( a, b );
+		graph.add_edge( b, a );
+		daw::expecting_exception( [&]( ) { graph.run( ); } );
+	}
+
+	void task_graph_bench_001( ) {
+		// Layers of nodes where every node depends on the whole layer before it
+		constexpr std::size_t layers = 8;
+		constexpr std::size_t width = 32;
+		auto graph = daw::task_graph( );
+		auto sum = std::atomic<std::size_t>( 0 );
+		auto previous = std::vector<daw::task_graph::node_id>( );
+		for( std::size_t l = 0; l < layers; ++l ) {
+			auto current = std::vector<daw::task_graph::node_id>( );
+			for( std::size_t n = 0; n < width; ++n ) {
+				auto const node = graph.add_node( [&sum, n]( ) { sum += n; } );
+				for( auto p : previous ) {
+					graph.add_edge( p, node );
+				}
+				current.push_back( node );
+			}
+			previous = current;
+		}
+		constexpr std::size_t runs = 100;
+		auto const t = daw::benchmark( [&]( ) {
+			for( std::size_t n = 0; n < runs; ++n ) {
+				graph.run( );
+			}
+		} );
+		daw::expecting( runs * layers * ( width * ( width - 1 ) / 2 ), sum.load( ) );
+		std::cout << runs << " runs of a " << graph.size( ) << " node graph: "
+		          << daw::utility::format_seconds( t, 3 ) << '\n';
+	}
+} // namespace
+
+int main( ) {
+	task_graph_test_001( );
+	task_graph_test_002( );
+	task_graph_test_003( );
+	task_graph_test_004( );
+	task_graph_bench_001( );
+}
@@ -20,6 +20,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <thread>
 
@@ -95,7 +97,91 @@ void create_waitable_task_test_001( ) {
 	}
 }
 
+void nested_drain_test_001( ) {
+	// A worker draining a long queue runs the tasks one after the other
+	// instead of nesting each in the last
+	constexpr std::size_t count = 200'000;
+	auto ts = daw::task_scheduler( 1 );
+	auto is_queued = std::atomic<bool>( false );
+	auto sem = daw::fixed_cnt_sem( count + 1 );
+	(void)ts.add_task( [&]( ) {
+		while( not is_queued ) {
+			std::this_thread::yield( );
+		}
+		sem.notify( );
+	} );
+	for( std::size_t n = 0; n < count; ++n ) {
+		daw::expecting( ts.add_task( [&sem]( ) { sem.notify( ); } ) );
+	}
+	is_queued = true;
+	sem.wait( );
+}
+
+void wait_for_scope_test_001( ) {
+	// A worker waiting on a task queued behind it on its own queue has that
+	// queue served until the wait ends, and gets the result of the scope
+	auto ts = daw::task_scheduler( 1 );
+	auto result = std::atomic<int>( 0 );
+	auto done = daw::shared_cnt_sem( 1 );
+	daw::expecting( ts.add_task( [&ts, &result, done]( ) mutable {
+		auto inner = daw::shared_cnt_sem( 1 );
+		daw::expecting( ts.add_task( [inner]( ) mutable { inner.notify( ); } ) );
+		result = ts.wait_for_scope( [&inner]( ) {
+			inner.wait( );
+			return 42;
+		} );
+		done.notify( );
+	} ) );
+	done.wait( );
+	daw::expecting( 42, result.load( ) );
+}
+
+void all_workers_run_test_001( ) {
+	// Every worker of a started scheduler runs tasks, so as many tasks as
+	// there are workers can wait on each other
+	constexpr std::size_t count = 4;
+	auto ts = daw::task_scheduler( count );
+	auto running = std::atomic<std::size_t>( 0 );
+	auto done = daw::shared_cnt_sem( count );
+	auto const deadline = std::chrono::steady_clock::now( ) + std::chrono::seconds( 10 );
+	for( std::size_t n = 0; n < count; ++n ) {
+		daw::expecting( ts.add_task( [&running, &deadline, done]( ) mutable {
+			++running;
+			while( running < count and std::chrono::steady_clock::now( ) < deadline ) {
+				std::this_thread::yield( );
+			}
+			done.notify( );
+		} ) );
+	}
+	done.wait( );
+	daw::expecting( count, running.load( ) );
+}
+
+void stopped_runner_test_001( ) {
+	// The temporary runner of a wait leaves nothing behind in the queues once
+	// it stops
+	auto ts = daw::task_scheduler( 1 );
+	auto done = daw::shared_cnt_sem( 1 );
+	daw::expecting( ts.add_task( [&ts, done]( ) mutable {
+		ts.wait_for_scope( []( ) {} );
+		done.notify( );
+	} ) );
+	done.wait( );
+	std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+	std::size_t ran = 0;
+	for( std::size_t n = 0; n < 1'000; ++n ) {
+		if( ts.help_run_next_task( ) ) {
+			++ran;
+		}
+	}
+	daw::expecting( std::size_t{ 0 }, ran );
+}
+
 int main( ) {
 	test_task_scheduler( );
 	create_waitable_task_test_001( );
+	nested_drain_test_001( );
+	wait_for_scope_test_001( );
+	all_workers_run_test_001( );
+	stopped_runner_test_001( );
 }
@@ -0,0 +1,198 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/function_stream
+//
+
+#include "daw/fs/function_stream.h"
+#include "daw/fs/window_stage.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+	struct event_t {
+		std::uint64_t key;
+		std::uint64_t time;
+	};
+
+	std::vector<event_t> make_events( std::size_t count, std::uint64_t key_count ) {
+		auto result = std::vector<event_t>( );
+		result.reserve( count );
+		for( std::uint64_t n = 0; n < count; ++n ) {
+			result.push_back( event_t{ ( n * 7U ) % key_count, n } );
+		}
+		return result;
+	}
+
+	auto event_key( event_t const &e ) {
+		return e.key;
+	}
+
+	auto event_time( event_t const &e ) {
+		return e.time;
+	}
+
+	void count_event( std::size_t &count, event_t const & ) {
+		++count;
+	}
+
+	using count_result_t = daw::window_result<std::uint64_t, std::uint64_t, std::size_t>;
+	using window_key_t = std::tuple<std::uint64_t, std::uint64_t, std::uint64_t>;
+
+	/// Collect the closed windows by key and bounds
+	auto window_sink( std::map<window_key_t, std::size_t> &windows ) {
+		return [&windows]( std::vector<count_result_t> const &closed ) {
+			for( auto const &w : closed ) {
+				auto const inserted = windows.emplace( window_key_t{ w.key, w.start, w.end }, w.value );
+				daw::expecting( inserted.second );
+			}
+		};
+	}
+
+	void window_stage_test_001( ) {
+		// Per key counts over tumbling windows
+		auto const events = make_events( 1'000, 4 );
+		auto windows = std::map<window_key_t, std::size_t>( );
+		auto fs = daw::make_function_stream(
+		  daw::tumbling_window<event_t>( event_key, event_time, 100, std::size_t{ 0 }, count_event ) );
+		fs.run( events, window_sink( windows ) );
+
+		daw::expecting( std::size_t{ 40 }, windows.size( ) );
+		for( auto const &[bounds, count] : windows ) {
+			daw::expecting( std::get<2>( bounds ), std::get<1>( bounds ) + 100 );
+			daw::expecting( std::size_t{ 25 }, count );
+		}
+	}
+
+	void window_stage_test_002( ) {
+		// Each item is in the two windows overlapping it, except the first ones
+		auto const events = make_events( 1'000, 1 );
+		auto windows = std::map<window_key_t, std::size_t>( );
+		auto fs = daw::make_function_stream( daw::sliding_window<event_t>(
+		  event_key, event_time, 100, 50, std::size_t{ 0 }, count_event ) );
+		fs.run( events, window_sink( windows ) );
+
+		daw::expecting( std::size_t{ 20 }, windows.size( ) );
+		for( auto const &[bounds, count] : windows ) {
+			auto const start = std::get<1>( bounds );
+			daw::expecting( std::min<std::uint64_t>( start + 100, 1'000 ) - start, count );
+		}
+	}
+
+	void window_stage_test_003( ) {
+		// Windows are passed on when an item passes their end and late items are
+		// dropped
+		auto stage =
+		  daw::tumbling_window<event_t>( event_key, event_time, 100, std::size_t{ 0 }, count_event );
+		daw::expecting( stage( event_t{ 1, 5 } ).empty( ) );
+		daw::expecting( stage( event_t{ 2, 50 } ).empty( ) );
+		daw::expecting( stage( event_t{ 1, 99 } ).empty( ) );
+		auto closed = stage( event_t{ 1, 150 } );
+		std::sort( closed.begin( ), closed.end( ), []( auto const &lhs, auto const &rhs ) {
+			return lhs.key < rhs.key;
+		} );
+		daw::expecting( std::size_t{ 2 }, closed.size( ) );
+		daw::expecting( std::uint64_t{ 1 }, closed[0].key );
+		daw::expecting( std::size_t{ 2 }, closed[0].value );
+		daw::expecting( std::uint64_t{ 2 }, closed[1].key );
+		daw::expecting( std::size_t{ 1 }, closed[1].value );
+
+		daw::expecting( stage( event_t{ 1, 20 } ).empty( ) );
+		daw::expecting( std::size_t{ 1 }, stage.late_count( ) );
+
+		auto const rest = stage.flush( );
+		daw::expecting( std::size_t{ 1 }, rest.size( ) );
+		daw::expecting( std::uint64_t{ 100 }, rest[0].start );
+		daw::expecting( std::size_t{ 1 }, rest[0].value );
+	}
+
+	void window_stage_test_004( ) {
+		// Many keys over many shards, each aggregated in several batches, match
+		// a sequential count and sum
+		auto const events = make_events( 100'000, 1'000 );
+		auto expected = std::map<std::pair<std::uint64_t, std::uint64_t>, std::uint64_t>( );
+		for( auto const &e : events ) {
+			expected[{ e.key, e.time / 10'000 * 10'000 }] += e.time;
+		}
+		auto windows = std::map<std::pair<std::uint64_t, std::uint64_t>, std::uint64_t>( );
+		auto fs = daw::make_function_stream( daw::tumbling_window<event_t>(
+		  event_key,
+		  event_time,
+		  10'000,
+		  std::uint64_t{ 0 },
+		  []( std::uint64_t &sum, event_t const &e ) { sum += e.time; },
+		  daw::window_options{ 8, 64 } ) );
+		fs.run( events, [&]( auto const &closed ) {
+			for( auto const &w : closed ) {
+				windows[{ w.key, w.start }] = w.value;
+			}
+		} );
+		daw::expecting( expected == windows );
+	}
+
+	void window_stage_test_005( ) {
+		auto const events = make_events( 1'000, 4 );
+		auto fs = daw::make_function_stream( daw::tumbling_window<event_t>(
+		  event_key, event_time, 100, std::size_t{ 0 }, []( std::size_t &, event_t const &e ) {
+			  if( e.time == 500 ) {
+				  throw std::runtime_error( "window_stage_test_005" );
+			  }
+		  } ) );
+		daw::expecting_exception( [&]( ) { fs.run( events, []( auto const & ) {} ); } );
+	}
+
+	void window_stage_bench_001( ) {
+		constexpr std::size_t item_count = 1'000'000;
+		auto const events = make_events( item_count, 10'000 );
+		auto const accumulate = []( std::uint64_t &sum, event_t const &e ) {
+			sum += e.time;
+		};
+		std::uint64_t expected_total = 0;
+		auto const t_post = daw::benchmark( [&]( ) {
+			// What a single threaded stage after the stream does today
+			auto windows = std::map<std::pair<std::uint64_t, std::uint64_t>, std::uint64_t>( );
+			for( auto const &e : events ) {
+				accumulate( windows[{ e.key, e.time / 100'000 }], e );
+			}
+			for( auto const &w : windows ) {
+				expected_total += w.second;
+			}
+		} );
+		std::uint64_t total = 0;
+		auto fs = daw::make_function_stream( daw::tumbling_window<event_t>(
+		  event_key, event_time, 100'000, std::uint64_t{ 0 }, accumulate ) );
+		auto const t_window = daw::benchmark( [&]( ) {
+			fs.run( events, [&]( auto const &closed ) {
+				for( auto const &w : closed ) {
+					total += w.value;
+				}
+			} );
+		} );
+		daw::expecting( expected_total, total );
+
+		std::cout << "windowed sums of " << item_count << " items\n";
+		std::cout << "\tpost processing: " << daw::utility::format_seconds( t_post, 3 ) << '\n';
+		std::cout << "\twindow stage:    " << daw::utility::format_seconds( t_window, 3 ) << '\n';
+	}
+} // namespace
+
+int main( ) {
+	window_stage_test_001( );
+	window_stage_test_002( );
+	window_stage_test_003( );
+	window_stage_test_004( );
+	window_stage_test_005( );
+	window_stage_bench_001( );
+}